@@ -39,10 +39,13 @@
 #include <graphene/chain/fund_object.hpp>
 #include <graphene/chain/cheque_object.hpp>
 #include <graphene/chain/operation_history_object.hpp>
+#include <graphene/history/history_plugin.hpp>
+#include <graphene/history/operation_history_store.hpp>
 
 #include <fc/crypto/hex.hpp>
 #include <fc/crypto/base64.hpp>
 #include <fc/rpc/api_connection.hpp>
+#include <fc/thread/parallel.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
 template class fc::api<graphene::app::network_broadcast_api>;
@@ -88,7 +91,7 @@ namespace graphene { namespace app {
     void login_api::enable_api( const std::string& api_name )
     {
        if (api_name == "database_api") {
-          _database_api = std::make_shared< database_api >( std::ref( *_app.chain_database() ) );
+          _database_api = std::make_shared< database_api >( std::ref( *_app.chain_database() ), _app.history_store() );
        }
        else if (api_name == "network_broadcast_api") {
           _network_broadcast_api = std::make_shared< network_broadcast_api >( std::ref( _app ) );
@@ -114,6 +117,9 @@ namespace graphene { namespace app {
        return;
     }
 
+    const size_t network_broadcast_api::max_broadcast_batch_size;
+    const size_t network_broadcast_api::max_pending_confirmations;
+
     network_broadcast_api::network_broadcast_api(application& a):_app(a) {
        _applied_block_connection = _app.chain_database()->applied_block.connect([this](const signed_block& b){ on_applied_block(b); });
     }
@@ -132,7 +138,8 @@ namespace graphene { namespace app {
              if( itr != _callbacks.end() )
              {
                 auto block_num = b.block_num();
-                auto& callback = _callbacks.find(id)->second;
+                auto callback = itr->callback;
+                _callbacks.erase( itr );
                 auto v = fc::variant( transaction_confirmation{ id, block_num, trx_num, trx }, GRAPHENE_MAX_NESTED_OBJECTS );
                 fc::async( [capture_this,v,callback]() {
                    callback(v);
@@ -142,9 +149,42 @@ namespace graphene { namespace app {
 //                fc::async( [capture_this,this,id,block_num,trx_num,trx,callback](){ callback( fc::variant(transaction_confirmation{ id, block_num, trx_num, trx}) ); } );
              }
           }
+
+          // transactions which expired before this block can not be included any more
+          auto& by_exp = _callbacks.get<by_expiration>();
+          by_exp.erase( by_exp.begin(), by_exp.lower_bound( b.timestamp ) );
        }
     }
 
+    void network_broadcast_api::reserve_callback( const transaction_id_type& id )
+    {
+       if( _callbacks.size() < _max_pending_confirmations || _callbacks.find( id ) != _callbacks.end() )
+          return;
+       auto& by_exp = _callbacks.get<by_expiration>();
+       by_exp.erase( by_exp.begin(), by_exp.lower_bound( _app.chain_database()->head_block_time() ) );
+       FC_ASSERT( _callbacks.size() < _max_pending_confirmations,
+                  "Too many transactions are waiting for a confirmation callback" );
+    }
+
+    void network_broadcast_api::add_callback( const signed_transaction& trx, confirmation_callback cb )
+    {
+       auto itr = _callbacks.find( trx.id() );
+       if( itr != _callbacks.end() )
+          _callbacks.modify( itr, [&cb]( pending_confirmation& p ) { p.callback = cb; } );
+       else
+          _callbacks.insert( pending_confirmation{ trx.id(), trx.expiration, cb } );
+    }
+
+    void network_broadcast_api::set_max_pending_confirmations( size_t limit )
+    {
+       _max_pending_confirmations = limit;
+    }
+
+    size_t network_broadcast_api::pending_confirmations()const
+    {
+       return _callbacks.size();
+    }
+
     void network_broadcast_api::broadcast_transaction(const signed_transaction& trx)
     {
        trx.validate();
@@ -152,6 +192,52 @@ namespace graphene { namespace app {
        _app.p2p_node()->broadcast_transaction(trx);
     }
 
+    vector<network_broadcast_api::broadcast_result> network_broadcast_api::broadcast_transactions(
+          const vector<signed_transaction>& trxs )
+    {
+       FC_ASSERT( trxs.size() <= max_broadcast_batch_size, "At most ${n} transactions can be broadcast at once",
+                  ("n", max_broadcast_batch_size) );
+       auto db = _app.chain_database();
+       const chain_id_type& chain_id = db->get_chain_id();
+
+       // stateless checks and signature recovery, the expensive part, do not need the database
+       vector<flat_set<public_key_type>> signature_keys( trxs.size() );
+       vector<broadcast_result> results( trxs.size() );
+       fc::parallel_for( 0, trxs.size(), [&trxs,&chain_id,&signature_keys,&results]( size_t i ) {
+          try {
+             trxs[i].validate();
+             signature_keys[i] = trxs[i].get_signature_keys( chain_id );
+          } catch( const fc::exception& e ) {
+             results[i].error = e.to_string();
+          }
+       } );
+
+       // the authorities are checked with the recovered keys right before each transaction is applied,
+       // so that a transaction sees the changes of the ones before it
+       vector<signed_transaction> accepted;
+       accepted.reserve( trxs.size() );
+       auto get_active = [&db]( account_id_type id ) { return &id(*db).active; };
+       auto get_owner  = [&db]( account_id_type id ) { return &id(*db).owner;  };
+       for( size_t i = 0; i < trxs.size(); ++i )
+       {
+          results[i].id = trxs[i].id();
+          if( results[i].error )
+             continue;
+          try {
+             graphene::protocol::verify_authority( trxs[i].operations, signature_keys[i], get_active, get_owner,
+                                                   db->get_global_properties().parameters.max_authority_depth );
+             db->push_transaction( trxs[i], database::skip_transaction_signatures );
+             results[i].accepted = true;
+             accepted.push_back( trxs[i] );
+          } catch( const fc::exception& e ) {
+             results[i].error = e.to_string();
+          }
+       }
+
+       _app.p2p_node()->broadcast_transactions( accepted );
+       return results;
+    }
+
     void network_broadcast_api::broadcast_block( const signed_block& b )
     {
        _app.chain_database()->push_block(b);
@@ -227,8 +313,11 @@ namespace graphene { namespace app {
     void network_broadcast_api::broadcast_transaction_with_callback_new(confirmation_callback cb, const signed_transaction& trx)
     {
        trx.validate();
-       _callbacks[trx.id()] = cb;
+       // a full table rejects the transaction before it is applied locally, it would not be broadcast otherwise
+       reserve_callback( trx.id() );
        _app.chain_database()->push_transaction(trx);
+       // registered once the transaction is accepted, a rejected one would never be confirmed
+       add_callback( trx, cb );
        _app.p2p_node()->broadcast_transaction(trx);
     }
 
@@ -423,16 +512,10 @@ namespace graphene { namespace app {
                   assert( aobj != nullptr );
                   result.push_back( aobj->owner );
                   break;
-               } case impl_transaction_history_object_type:{
-                  const auto& aobj = dynamic_cast<const transaction_history_object*>(obj);
-                  assert( aobj != nullptr );
-                  flat_set<account_id_type> impacted;
-                  flat_set<fund_id_type> impacted_fund_tmp;
-                  transaction_get_impacted_items( aobj->trx, impacted, impacted_fund_tmp);
-                  result.reserve( impacted.size() );
-                  for( auto& item : impacted ) result.emplace_back(item);
+               } case impl_transaction_history_object_type:
+                  // only the id of the transaction is kept
                   break;
-               } case impl_blinded_balance_object_type:{
+                 case impl_blinded_balance_object_type:{
                   const auto& aobj = dynamic_cast<const blinded_balance_object*>(obj);
                   assert( aobj != nullptr );
                   result.reserve( aobj->owner.account_auths.size() );
@@ -458,6 +541,7 @@ namespace graphene { namespace app {
                  case impl_fund_history_object_type:
                  case impl_settings_object_type:
                  case impl_blind_transfer2_object_type:
+                 case impl_cheque_payee_object_type:
                   break;
           }
        }
@@ -505,6 +589,31 @@ namespace graphene { namespace app {
        }
     }
 
+    graphene::history::operation_history_store* history_api::history_store() const
+    {
+       return _app.history_store();
+    }
+
+    optional<operation_history_object> history_api::find_operation(operation_history_id_type id) const
+    {
+       const auto& db = *_app.chain_database();
+       const operation_history_object* obj = db.find(id);
+       if (obj) {
+          return *obj;
+       }
+       auto* store = history_store();
+       if (store) {
+          return store->fetch(id);
+       }
+       return optional<operation_history_object>();
+    }
+
+    void history_api::visit_account_history(account_id_type account,
+                                            const std::function<bool(const operation_history_object&)>& visit) const
+    {
+       graphene::history::visit_account_history(*_app.chain_database(), history_store(), account, visit);
+    }
+
     vector<operation_history_object> history_api::get_accounts_history(unsigned limit) const
     {
        FC_ASSERT( _app.chain_database() );
@@ -512,16 +621,25 @@ namespace graphene { namespace app {
        FC_ASSERT( limit <= 100 );
        vector<operation_history_object> result;
 
+       uint64_t oldest_visited = std::numeric_limits<uint64_t>::max();
        const auto& idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
-       for (auto rit = idx.rbegin(); rit != idx.crend(); ++rit)
+       for (auto rit = idx.rbegin(); (rit != idx.crend()) && (result.size() < limit); ++rit)
+       {
+          operation_history_object obj = *rit;
+          oldest_visited = obj.id.instance();
+          db.clear_op(obj.op);
+          result.emplace_back(std::move(obj));
+       }
+
+       auto* store = history_store();
+       if (store)
        {
-          if (result.size() < limit)
+          for (size_t pos = store->lower_bound(operation_history_id_type(oldest_visited)); (pos > 0) && (result.size() < limit); --pos)
           {
-             operation_history_object obj = *rit;
+             operation_history_object obj = store->fetch_by_position(pos - 1);
              db.clear_op(obj.op);
              result.emplace_back(std::move(obj));
           }
-          if (result.size() == limit) { break; }
        }
 
        return result;
@@ -533,47 +651,21 @@ namespace graphene { namespace app {
                                                                        operation_history_id_type start ) const
     {
        FC_ASSERT( _app.chain_database() );
-       const auto& db = *_app.chain_database();       
        FC_ASSERT( limit <= 100 );
        vector<operation_history_object> result;
 
-       const auto& stats = account(db).statistics(db);
-       if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-
-       if (!db.find(stats.most_recent_op)) {
-          return result;
-       }
-       const account_transaction_history_object* node = &stats.most_recent_op(db);
-
-       if (start == operation_history_id_type()) {
-          start = node->operation_id;
-       }
-       while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit) )
+       visit_account_history(account, [&](const operation_history_object& hist) -> bool
        {
-          if (node->operation_id.instance.value <= start.instance.value)
+          if (hist.id.instance() <= stop.instance.value) { return false; }
+          if ((start == operation_history_id_type()) || (hist.id.instance() <= start.instance.value))
           {
-             try
-             {
-                operation_history_object op_h = node->operation_id(db);
-                reserve_op(op_h);
-                result.push_back(std::move(op_h));
-             } catch(fc::exception e) { break; }
-          }
-          if (node->next == account_transaction_history_id_type()) {
-             node = nullptr;
-          }
-          else
-          {
-             auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-             if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-                node = nullptr;
-             }
-             else {
-                node = &(*f_idx);
-             }
+             operation_history_object op_h = hist;
+             reserve_op(op_h);
+             result.push_back(std::move(op_h));
           }
-       }
-       
+          return result.size() < limit;
+       });
+
        return result;
     }
 
@@ -584,47 +676,23 @@ namespace graphene { namespace app {
       const auto& db = *_app.chain_database();       
       FC_ASSERT(count <= 100);
       vector<listtransactions_result> result;
-      const auto& stats = account(db).statistics(db);
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
+      if (count <= 0) { return result; }
       const uint32_t current_block = db.head_block_num();
-      while ((node != nullptr) && (result.size() < (uint32_t)count))
+
+      visit_account_history(account, [&](const operation_history_object& op_hist) -> bool
       {
-         auto op_hist = node->operation_id(db);
          if (op_hist.op.which() == operation::tag<transfer_operation>::value)
          {
-            auto ext = op_hist.op.get<transfer_operation>().extensions;
-            auto tr_address = ext.begin() != ext.end() ? ext.begin()->get<string>(): "";
-            if (addresses.size() && std::find(addresses.begin(), addresses.end(), tr_address) == addresses.end())
-            {
-               node = &node->next(db);
-               continue;
+            const transfer_operation& tr_op = op_hist.op.get<transfer_operation>();
+            auto tr_address = tr_op.extensions.begin() != tr_op.extensions.end() ? tr_op.extensions.begin()->get<string>(): "";
+            if (addresses.size() && std::find(addresses.begin(), addresses.end(), tr_address) == addresses.end()) {
+               return true;
             }
-            try
-            {
-               result.push_back(listtransactions_result{op_hist.op.get<transfer_operation>(),
-                                                        (int)(current_block - op_hist.block_num)});
-            } catch (fc::exception e)
-            { break; }
-         }
-         if (node->next == account_transaction_history_id_type()) {
-            node = nullptr;
+            result.push_back(listtransactions_result{tr_op, (int)(current_block - op_hist.block_num)});
          }
-         else
-         {
-            auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-            if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-               node = nullptr;
-            }
-            else {
-               node = &(*f_idx);
-            }
-         }
-      }
-       
+         return result.size() < (uint32_t)count;
+      });
+
       return result;
    }
 
@@ -644,20 +712,37 @@ namespace graphene { namespace app {
        const auto& by_seq_idx = hist_idx.indices().get<by_seq>();
        
        auto itr = by_seq_idx.upper_bound( boost::make_tuple( account, start ) );
-       auto itr_stop = by_seq_idx.lower_bound( boost::make_tuple( account, stop ) );
-       --itr;
+       auto itr_stop = by_seq_idx.upper_bound( boost::make_tuple( account, stop ) );
+       uint32_t next_seq = start;
        
        while ( itr != itr_stop && result.size() < limit )
        {
-          try
-          {
-             operation_history_object op_h = itr->operation_id(db);
-             reserve_op(op_h);
-             result.push_back(std::move(op_h));
-          } catch(fc::exception e) { break; }
           --itr;
+          optional<operation_history_object> op_h = find_operation(itr->operation_id);
+          if (!op_h.valid()) { return result; }
+          reserve_op(*op_h);
+          result.push_back(std::move(*op_h));
+          next_seq = itr->sequence - 1;
        }
-       
+
+       // older entries of the account were moved to the history store
+       auto* store = history_store();
+       if (!store) { return result; }
+       const auto& entries = store->account_history(account);
+       auto rit = std::upper_bound(entries.begin(), entries.end(), next_seq,
+                                   [](uint32_t seq, const graphene::history::operation_history_store::account_entry& e) {
+                                      return seq < e.sequence;
+                                   });
+       while ( (rit != entries.begin()) && (result.size() < limit) )
+       {
+          --rit;
+          if (rit->sequence <= stop) { break; }
+          optional<operation_history_object> op_h = store->fetch(operation_history_id_type(rit->operation));
+          if (!op_h.valid()) { break; }
+          reserve_op(*op_h);
+          result.push_back(std::move(*op_h));
+       }
+
        return result;
     }
 
@@ -665,46 +750,20 @@ namespace graphene { namespace app {
     history_api::get_account_operation_history(account_id_type account, unsigned operation_type, unsigned limit) const
     {
       FC_ASSERT( _app.chain_database() );
-      const auto& db = *_app.chain_database();       
       FC_ASSERT( limit <= 100 );
-
       vector<operation_history_object> result;
-      const auto& stats = account(db).statistics(db);
-      if( stats.most_recent_op == account_transaction_history_id_type() ) { return result; }
 
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
-
-      while (node && result.size() < limit)
+      visit_account_history(account, [&](const operation_history_object& hist) -> bool
       {
-        try
-        {
-          const operation_history_object& hist = node->operation_id(db);
-          if ((unsigned)hist.op.which() == operation_type)
-          {
-             operation_history_object op_h = hist;
-             reserve_op(op_h);
-             result.push_back(std::move(op_h));
-          }
-        }
-        catch(fc::exception e) { break; }
-        if ( node->next == account_transaction_history_id_type() ) {
-           node = nullptr;
-        }
-        else
-        {
-           auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-           if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-              node = nullptr;
-           }
-           else {
-              node = &(*f_idx);
-           }
-        }
-      }
-      
+         if ((unsigned)hist.op.which() == operation_type)
+         {
+            operation_history_object op_h = hist;
+            reserve_op(op_h);
+            result.push_back(std::move(op_h));
+         }
+         return result.size() < limit;
+      });
+
       return result;
     }
 
@@ -716,52 +775,21 @@ namespace graphene { namespace app {
        , unsigned operation_type) const
     { 
       FC_ASSERT( _app.chain_database() );
-      const auto& db = *_app.chain_database();       
       FC_ASSERT( limit <= 100 );
       vector<operation_history_object> result;
-      const auto& stats = account(db).statistics(db);
-
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
 
-      if (start == operation_history_id_type()) {
-         start = node->operation_id;
-      }
-
-      while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit))
+      visit_account_history(account, [&](const operation_history_object& hist) -> bool
       {
-        try
-        {
-          auto& hist = node->operation_id(db);
-          if (node->operation_id.instance.value <= start.instance.value)
-          {
-             if ((unsigned)hist.op.which() == operation_type)
-             {
-                operation_history_object op_h = hist;
-                reserve_op(op_h);
-                result.push_back(std::move(op_h));
-             }
-          }
-        }
-        catch(fc::exception e) { break; }
-        if (node->next == account_transaction_history_id_type()) {
-           node = nullptr;
-        }
-        else
-        {
-           auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-           if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-              node = nullptr;
-           }
-           else {
-              node = &(*f_idx);
-           }
-        }
-      }
+         if (hist.id.instance() <= stop.instance.value) { return false; }
+         if ( ((start == operation_history_id_type()) || (hist.id.instance() <= start.instance.value))
+              && ((unsigned)hist.op.which() == operation_type) )
+         {
+            operation_history_object op_h = hist;
+            reserve_op(op_h);
+            result.push_back(std::move(op_h));
+         }
+         return result.size() < limit;
+      });
 
       return result;
    }
@@ -774,64 +802,31 @@ namespace graphene { namespace app {
       , const vector<uint16_t>& operation_types) const
    {
       FC_ASSERT( _app.chain_database() );
-      const auto& db = *_app.chain_database();
       FC_ASSERT( limit <= 100 );
       vector<operation_history_object> result;
-      const auto& stats = account_id(db).statistics(db);
 
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
-
-      if (start == operation_history_id_type()) {
-         start = node->operation_id;
-      }
-
-      while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit))
+      visit_account_history(account_id, [&](const operation_history_object& h) -> bool
       {
-         try
+         if (h.id.instance() <= stop.instance.value) { return false; }
+         if ( ((start == operation_history_id_type()) || (h.id.instance() <= start.instance.value))
+              && (std::find(operation_types.begin(), operation_types.end(), (uint16_t)h.op.which()) != operation_types.end()) )
          {
-            operation_history_object hist = node->operation_id(db);
+            operation_history_object hist = h;
             reserve_op(hist);
 
-            if (node->operation_id.instance.value <= start.instance.value)
+            // fund_payment_operation
+            if (hist.op.which() == operation::tag<fund_payment_operation>::value)
             {
-               std::for_each(operation_types.begin(), operation_types.end(), [&account_id, &hist, &result](const uint16_t& op_type)
-               {
-                  if ((unsigned)hist.op.which() == op_type)
-                  {
-                     // fund_payment_operation
-                     if (hist.op.which() == operation::tag<fund_payment_operation>::value)
-                     {
-                        if (hist.op.get<fund_payment_operation>().issue_to_account == account_id) {
-                           result.push_back(std::move(hist));
-                        }
-                     }
-                     else {
-                        result.push_back(std::move(hist));
-                     }
-                  }
-               });
-            }
-         }
-         catch(fc::exception e) { break; }
-         if (node->next == account_transaction_history_id_type()) {
-            node = nullptr;
-         }
-         else
-         {
-            auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-            if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-               node = nullptr;
+               if (hist.op.get<fund_payment_operation>().issue_to_account == account_id) {
+                  result.push_back(std::move(hist));
+               }
             }
             else {
-               node = &(*f_idx);
+               result.push_back(std::move(hist));
             }
          }
-      }
+         return result.size() < limit;
+      });
 
       return result;
    }
@@ -849,7 +844,7 @@ namespace graphene { namespace app {
       result.reserve(limit);
 
       const auto& idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
-      auto itr = idx.begin();
+      auto* store = history_store();
 
       auto is_valid_operation = [&operation_types, &account](const operation_history_object& op) -> bool
       {
@@ -871,34 +866,32 @@ namespace graphene { namespace app {
          return false;
       };
 
-      if (start == operation_history_id_type())
+      if ( (start != operation_history_id_type())
+           && (idx.find(start) == idx.end())
+           && (!store || !store->contains(start)) )
+      {
+         return result;
+      }
+
+      // archived operations are older than the ones in the object database
+      operation_history_id_type next = start;
+      if (store)
       {
-         while (itr != idx.end())
+         for (size_t pos = store->lower_bound(start); (pos < store->size()) && (result.size() < limit); ++pos)
          {
-            // find first valid operation
-            if (is_valid_operation(*itr)) {
-               break;
+            operation_history_object op = store->fetch_by_position(pos);
+            next = operation_history_id_type(op.id.instance() + 1);
+            if (is_valid_operation(op)) {
+               result.emplace_back(std::move(op));
             }
-            ++itr;
          }
       }
-      else
-      {
-         itr = idx.find(start);
-         if (itr == idx.end()) { return result; }
-      }
 
-      while (itr != idx.end())
+      for (auto itr = idx.lower_bound(next); (itr != idx.end()) && (result.size() < limit); ++itr)
       {
-         if (result.size() == limit) { break;}
-
-         const operation_history_object& op = *itr;
-
-         if (is_valid_operation(op)) {
-            result.emplace_back(op);
+         if (is_valid_operation(*itr)) {
+            result.emplace_back(*itr);
          }
-
-         ++itr;
       }
 
       return result;
@@ -911,21 +904,8 @@ namespace graphene { namespace app {
       , operation_history_id_type start) const
    {
       FC_ASSERT( _app.chain_database() );
-      const auto& db = *_app.chain_database();
       FC_ASSERT( limit <= 100 );
       vector<operation_history_object> result;
-      const auto& stats = account_id(db).statistics(db);
-
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
-
-      if (start == operation_history_id_type()) {
-         start = node->operation_id;
-      }
 
       auto set_fund_validation = [&](const fund_id_type& fund_id, bool& status)
       {
@@ -937,78 +917,61 @@ namespace graphene { namespace app {
          }
       };
 
-      while (node && (result.size() < limit))
+      visit_account_history(account_id, [&](const operation_history_object& h) -> bool
       {
-         try
+         if ((start == operation_history_id_type()) || (h.id.instance() <= start.instance.value))
          {
-            operation_history_object hist = node->operation_id(db);
+            operation_history_object hist = h;
             reserve_op(hist);
 
-            if (node->operation_id.instance.value <= start.instance.value)
-            {
-               const auto& op = hist.op.which();
-
-               bool fund_is_valid = false;
-               bool account_is_valid = false;
+            const auto& op = hist.op.which();
 
-               if (op == operation::tag<fund_update_operation>::value)
-               {
-                  const fund_update_operation& inner_op = hist.op.get<fund_update_operation>();
+            bool fund_is_valid = false;
+            bool account_is_valid = false;
 
-                  set_fund_validation(inner_op.id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.from_account == account_id)) {
-                     account_is_valid = true;
-                  }
-               }
-               else if (op == operation::tag<fund_deposit_operation>::value)
-               {
-                  const fund_deposit_operation& inner_op = hist.op.get<fund_deposit_operation>();
+            if (op == operation::tag<fund_update_operation>::value)
+            {
+               const fund_update_operation& inner_op = hist.op.get<fund_update_operation>();
 
-                  set_fund_validation(inner_op.fund_id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.from_account == account_id)) {
-                     account_is_valid = true;
-                  }
+               set_fund_validation(inner_op.id, fund_is_valid);
+               if (fund_is_valid && (inner_op.from_account == account_id)) {
+                  account_is_valid = true;
                }
-               else if (op == operation::tag<fund_withdrawal_operation>::value)
-               {
-                  const fund_withdrawal_operation& inner_op = hist.op.get<fund_withdrawal_operation>();
+            }
+            else if (op == operation::tag<fund_deposit_operation>::value)
+            {
+               const fund_deposit_operation& inner_op = hist.op.get<fund_deposit_operation>();
 
-                  set_fund_validation(inner_op.fund_id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
-                     account_is_valid = true;
-                  }
+               set_fund_validation(inner_op.fund_id, fund_is_valid);
+               if (fund_is_valid && (inner_op.from_account == account_id)) {
+                  account_is_valid = true;
                }
-               else if (op == operation::tag<fund_payment_operation>::value)
-               {
-                  const fund_payment_operation& inner_op = hist.op.get<fund_payment_operation>();
+            }
+            else if (op == operation::tag<fund_withdrawal_operation>::value)
+            {
+               const fund_withdrawal_operation& inner_op = hist.op.get<fund_withdrawal_operation>();
 
-                  set_fund_validation(inner_op.fund_id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
-                     account_is_valid = true;
-                  }
+               set_fund_validation(inner_op.fund_id, fund_is_valid);
+               if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
+                  account_is_valid = true;
                }
+            }
+            else if (op == operation::tag<fund_payment_operation>::value)
+            {
+               const fund_payment_operation& inner_op = hist.op.get<fund_payment_operation>();
 
-               if (account_is_valid && fund_is_valid) {
-                  result.push_back(std::move(hist));
+               set_fund_validation(inner_op.fund_id, fund_is_valid);
+               if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
+                  account_is_valid = true;
                }
             }
-         }
-         catch(fc::exception e) { break; }
 
-         if (node->next == account_transaction_history_id_type()) {
-            node = nullptr;
-         }
-         else
-         {
-            auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-            if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-               node = nullptr;
-            }
-            else {
-               node = &(*f_idx);
+            if (account_is_valid && fund_is_valid) {
+               result.push_back(std::move(hist));
             }
          }
-      }
+         return result.size() < limit;
+      });
 
       return result;
    }
@@ -1038,20 +1001,18 @@ namespace graphene { namespace app {
 
       while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit))
       {
-         try
+         if (node->operation_id.instance.value <= start.instance.value)
          {
-            auto& hist = node->operation_id(db);
-            if (node->operation_id.instance.value <= start.instance.value)
+            // the operation may be archived in the history store
+            optional<operation_history_object> hist = find_operation(node->operation_id);
+            if (!hist.valid()) { break; }
+            std::for_each(operation_types.begin(), operation_types.end(), [&hist, &result](const uint16_t& op_type)
             {
-               std::for_each(operation_types.begin(), operation_types.end(), [&hist, &result](const uint16_t& op_type)
-               {
-                  if ((unsigned) hist.op.which() == op_type) {
-                     result.push_back(hist);
-                  }
-               });
-            }
+               if ((unsigned) hist->op.which() == op_type) {
+                  result.push_back(*hist);
+               }
+            });
          }
-         catch(fc::exception e) { break; }
          if (node->next == fund_transaction_history_id_type()) {
             node = nullptr;
          }
@@ -1153,34 +1114,26 @@ namespace graphene { namespace app {
       FC_ASSERT(_app.chain_database());
       const auto& db = *_app.chain_database();
 
-      std::vector<cheque_object> result;
+      // cheques drawn by the account and cheques it has used, newest first
+      std::vector<const cheque_object*> cheques;
 
-      const auto& idx = db.get_index_type<cheque_index>().indices().get<by_datetime_creation>();
-      auto itr = idx.rbegin();
-      uint32_t i = 0;
+      const auto& drawer_idx = db.get_index_type<cheque_index>().indices().get<by_drawer>();
+      for (auto itr = drawer_idx.lower_bound(account_id); itr != drawer_idx.end() && itr->drawer == account_id; ++itr) {
+         cheques.push_back(&*itr);
+      }
 
-      while (itr != idx.rend())
-      {
-         if (itr->drawer == account_id)
-         {
-            if (i >= start) {
-               result.emplace_back(*itr);
-            }
-            ++i;
-         }
+      const auto& payee_idx = db.get_index_type<cheque_payee_index>().indices().get<by_payee>();
+      for (auto itr = payee_idx.lower_bound(account_id); itr != payee_idx.end() && itr->payee == account_id; ++itr) {
+         cheques.push_back(&itr->cheque(db));
+      }
 
-         for (const cheque_object::payee_item& item: itr->payees)
-         {
-            if (item.payee == account_id)
-            {
-               if (i >= start) {
-                  result.emplace_back(*itr);
-               }
-               ++i;
-            }
-         }
-         if (result.size() == limit) { break; }
-         ++itr;
+      std::sort(cheques.begin(), cheques.end(), [](const cheque_object* a, const cheque_object* b) {
+         return std::tie(a->datetime_creation, a->id) > std::tie(b->datetime_creation, b->id);
+      });
+
+      std::vector<cheque_object> result;
+      for (uint32_t i = start; i < cheques.size() && result.size() < limit; ++i) {
+         result.emplace_back(*cheques[i]);
       }
 
       return result;
@@ -25,10 +25,13 @@
 #include <graphene/app/api_access.hpp>
 #include <graphene/app/application.hpp>
 #include <graphene/app/plugin.hpp>
+#include <graphene/app/prevalidated_transactions.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
 #include <graphene/protocol/types.hpp>
 #include <graphene/chain/worker_evaluator.hpp>
 #include <graphene/egenesis/egenesis.hpp>
+#include <graphene/history/history_plugin.hpp>
+#include <graphene/history/operation_history_store.hpp>
 #include <graphene/net/core_messages.hpp>
 #include <graphene/net/exceptions.hpp>
 #include <graphene/utilities/key_conversion.hpp>
@@ -38,6 +41,7 @@
 #include <fc/rpc/api_connection.hpp>
 #include <fc/rpc/websocket_api.hpp>
 #include <fc/network/resolve.hpp>
+#include <fc/thread/parallel.hpp>
 
 #include <fc/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
@@ -182,7 +186,7 @@ namespace graphene { namespace app { namespace detail {
       _websocket_server->on_connection([&]( const fc::http::websocket_connection_ptr& c ){
          auto wsc = std::make_shared<fc::rpc::websocket_api_connection>(c, GRAPHENE_NET_MAX_NESTED_OBJECTS);
          auto login = std::make_shared<graphene::app::login_api>( std::ref(*_self) );
-         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()) );
+         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()), _self->history_store() );
          wsc->register_api(fc::api<graphene::app::database_api>(db_api));
          wsc->register_api(fc::api<graphene::app::login_api>(login));
          c->set_session_data( wsc );
@@ -210,7 +214,7 @@ namespace graphene { namespace app { namespace detail {
       {
          auto wsc = std::make_shared<fc::rpc::websocket_api_connection>(c, GRAPHENE_NET_MAX_NESTED_OBJECTS);
          auto login = std::make_shared<graphene::app::login_api>( std::ref(*_self) );
-         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()) );
+         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()), _self->history_store() );
          wsc->register_api(fc::api<graphene::app::database_api>(db_api));
          wsc->register_api(fc::api<graphene::app::login_api>(login));
          c->set_session_data( wsc );
@@ -511,9 +515,30 @@ namespace graphene { namespace app { namespace detail {
          trx_count = 0;
       }
 
-      _chain_db->push_transaction( transaction_message.trx );
+      _prevalidated_transactions.push_transaction( *_chain_db, transaction_message.trx );
    } FC_CAPTURE_AND_RETHROW( (transaction_message) ) }
 
+   void application_impl::prevalidate_block(const graphene::net::block_message& blk_msg)
+   {
+      // the range proofs of confidential transactions are checked on the worker pool, outside of any undo
+      // session, push_block() then finds them in the cache of transaction::validate().  Failures are
+      // reported by push_block()
+      vector<const processed_transaction*> confidential_trxs;
+      for( const auto& trx : blk_msg.block.transactions )
+         if( trx.has_confidential_operations() )
+            confidential_trxs.push_back( &trx );
+      fc::parallel_for( 0, confidential_trxs.size(), [&confidential_trxs]( size_t i ) {
+         try {
+            confidential_trxs[i]->validate();
+         } catch( const fc::exception& ) {}
+      }, 1 );
+   }
+
+   void application_impl::prevalidate_transaction(const graphene::net::trx_message& transaction_message)
+   {
+      _prevalidated_transactions.prevalidate( transaction_message.trx, _chain_db->get_chain_id() );
+   }
+
    void application_impl::handle_message(const message& message_to_process)
    {
       // not a transaction, not a block
@@ -880,6 +905,7 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("api-access", bpo::value<boost::filesystem::path>(), "JSON file specifying API permissions")
          ("io-threads", bpo::value<uint16_t>()->implicit_value(0), "Number of IO threads, default to 0 for auto-configuration")
          ("replay-blockchain", "Rebuild object graph by replaying all blocks")
+         ("block-timing-log-threshold", bpo::value<uint32_t>(), "Log the phase timings of blocks which take at least this many milliseconds to apply")
          ;
    command_line_options.add(configuration_file_options);
    command_line_options.add_options()
@@ -903,6 +929,12 @@ void application::initialize(const fc::path& data_dir, const boost::program_opti
    if (options.count("fast")) {
        my->_chain_db->set_history_size(options.at("fast").as<int>());
    }
+   if (options.count("fast-pruning-chunk")) {
+       my->_chain_db->set_pruning_chunk_size(options.at("fast-pruning-chunk").as<uint32_t>());
+   }
+   if (options.count("block-timing-log-threshold")) {
+       my->_chain_db->get_block_timing().set_log_threshold(fc::milliseconds(options.at("block-timing-log-threshold").as<uint32_t>()));
+   }
    if( options.count("create-genesis-json") )
    {
       fc::path genesis_out = options.at("create-genesis-json").as<boost::filesystem::path>();
@@ -957,6 +989,9 @@ void application::startup()
       {
          p_key = graphene::utilities::wif_to_key(key_string);
          from_account = *itr_acc;
+         my->_chain_db->applied_block.connect([this](const signed_block& b) {
+            confirm_bonus_transactions(b);
+         });
          bonus_schedule();
       }
    }
@@ -974,6 +1009,55 @@ string date_string(fc::time_point now) {
     return string(now).substr(0, 10);
 }
 
+/// the rewards of a day are issued to the chain time zone, see get_history
+string bonus_day() {
+    return date_string(fc::time_point::now() - fc::hours(9));
+}
+
+/// packed size of the reward transactions broadcast per block interval, the rest of the block is left to
+/// the other transactions
+const uint64_t max_bonus_round_size = 512 * 1024;
+/// a reward with its memo is never smaller than this, which bounds the operations built per round
+const uint64_t min_bonus_operation_size = 128;
+
+void bonus_checkpoint::start_day( const string& day )
+{
+    const bool kept_before = !date.empty();
+    *this = bonus_checkpoint();
+    date = day;
+    trusted = kept_before;
+}
+
+bool bonus_checkpoint::confirm( const chain::transaction_id_type& id )
+{
+    auto itr = pending.find(id);
+    if (itr == pending.end()) return false;
+    for (const auto& payment : itr->second.payments) {
+        if (payment.core_transfer)
+            completed.insert(payment.kind);
+        else if (payment.kind == "Daily mining reward")
+            daily_rewards[payment.account] = payment.quantity;
+        else
+            referral_rewards.insert(payment.account);
+    }
+    pending.erase(itr);
+    return true;
+}
+
+bool bonus_checkpoint::drop_expired( fc::time_point_sec now )
+{
+    bool dropped = false;
+    for (auto itr = pending.begin(); itr != pending.end(); ) {
+        if (itr->second.expiration < now) {
+            itr = pending.erase(itr);
+            dropped = true;
+        } else {
+            ++itr;
+        }
+    }
+    return dropped;
+}
+
 void application::set_key_from_file(fc::path path)
 {
     if( path.is_relative() )
@@ -997,12 +1081,15 @@ void application::bonus_schedule()
 void application::bonus_schedule_loop()
 {
     bonus_schedule();
-    if (!bonus_storage.empty()) {
+    // rewards are only known to be paid once their transactions are included, so a new pass waits for them
+    if (!bonus_storage.empty() || !checkpoint.pending.empty()) {
        std::cout << "STILL ISSUING" << std::endl;
        return;
     }
     auto& d = *my->_chain_db;
-    if (get_core_transfers("Daily mining reward").size()) {
+    const bool trusted = use_checkpoint();
+    if (checkpoint.completed.count("Daily mining reward") ||
+        (!trusted && get_core_transfers("Daily mining reward").size())) {
         std::cout << "return1" << std::endl;
         referrer_bonus();
         return;
@@ -1010,15 +1097,15 @@ void application::bonus_schedule_loop()
     bonus_storage.push_back(op_info(from_account, 1000, "Daily mining reward", true));
     auto& idx = d.get_index_type<chain::account_index>();
     const auto asset = my->_chain_db->get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
-    idx.inspect_all_objects( [&d,this,&asset](const chain::object& obj){
+    idx.inspect_all_objects( [&d,this,&asset,trusted](const chain::object& obj){
         const chain::account_object& account = static_cast<const chain::account_object&>(obj);
 
         auto balance = d.get_balance(account.id, asset->id).amount;
         if (balance.value == 0) return;
         
-        auto bonuses = get_daily_bonus(account.id);
-        if (bonuses.size()) return;
-        
+        if (checkpoint.daily_rewards.count(account.id)) return;
+        if (!trusted && get_daily_bonus(account.id)) return;
+
         uint64_t quantity = 0.0065 * balance.value;
         if (quantity < 1) return;
         try {
@@ -1031,18 +1118,106 @@ void application::bonus_schedule_loop()
 }
 
 void application::issue_from_storage() {
-    const auto SEND_STRANSACTION_EVERY = fc::milliseconds(71); //ms
     if (!bonus_storage.size()) return;
 
-    auto asset = *my->_chain_db->get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
-    auto elem = bonus_storage.back();
-    bonus_storage.pop_back();
-    if (elem.is_core_transfer) {
-        bonus_issued(elem.memo_string);
-    } else {
-    	issue_bonus(elem.to_account, elem.quantity, elem.memo_string);
+    auto& db = *my->_chain_db;
+    const auto& params = db.get_global_properties().parameters;
+    const uint64_t round_size = std::min<uint64_t>(params.maximum_block_size / 2, max_bonus_round_size);
+
+    // the completion transfer is only sent once the rewards it marks as done are included
+    if (bonus_storage.back().is_core_transfer && !checkpoint.pending.empty()) {
+        fc::schedule([this]{issue_from_storage();},
+                     fc::time_point::now() + fc::seconds(params.block_interval), "issue_from_storage");
+        return;
     }
-    fc::time_point next_wakeup( fc::time_point::now() + SEND_STRANSACTION_EVERY);
+
+    // the entries are issued from the back like before; a completion transfer is sent in a round of its own
+    vector<op_info> entries;
+    while (bonus_storage.size() && entries.size() < round_size / min_bonus_operation_size) {
+        if (bonus_storage.back().is_core_transfer && entries.size()) break;
+        entries.push_back(bonus_storage.back());
+        bonus_storage.pop_back();
+        if (entries.back().is_core_transfer) break;
+    }
+
+    // encrypting the memos and signing are the expensive parts, both run on the worker pool
+    const auto asst = *db.get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
+    const auto exchange = db.get<account_object>(chain::account_id_type(19));
+    vector<operation> ops(entries.size());
+    fc::parallel_for(0, entries.size(), [this,&entries,&ops,&asst,&exchange](size_t i) {
+        ops[i] = make_bonus_operation(entries[i], asst, exchange);
+    });
+
+    // the transactions and the round are bounded by their packed size, a placeholder signature is
+    // counted until the transactions are signed
+    vector<signed_transaction> trxs;
+    vector<size_t> trx_first_entry;
+    uint64_t round_bytes = 0;
+    size_t used = 0;
+    auto start_transaction = [&db,&trxs,&trx_first_entry,&used]() {
+        trxs.emplace_back();
+        trxs.back().set_expiration(db.get_slot_time(120));
+        trxs.back().set_reference_block(db.get_dynamic_global_properties().head_block_id);
+        trxs.back().signatures.emplace_back();
+        trx_first_entry.push_back(used);
+    };
+    for (; used < ops.size(); ++used) {
+        auto& op = ops[used];
+        db.current_fee_schedule().set_fee(op);
+        if (trxs.empty())
+            start_transaction();
+        trxs.back().operations.push_back(op);
+        if (trxs.back().operations.size() > 1 && fc::raw::pack_size(trxs.back()) > params.maximum_transaction_size) {
+            trxs.back().operations.pop_back();
+            round_bytes += fc::raw::pack_size(trxs.back());
+            start_transaction();
+            trxs.back().operations.push_back(op);
+        }
+        if (used && round_bytes + fc::raw::pack_size(trxs.back()) > round_size) {
+            trxs.back().operations.pop_back();
+            if (trxs.back().operations.empty()) {
+                trxs.pop_back();
+                trx_first_entry.pop_back();
+            }
+            break;
+        }
+    }
+    // the rewards which did not fit are issued in the next round, in the same order
+    for (size_t i = entries.size(); i > used; --i)
+        bonus_storage.push_back(entries[i - 1]);
+    entries.erase(entries.begin() + used, entries.end());
+    trx_first_entry.push_back(used);
+
+    const auto& chain_id = db.get_chain_id();
+    fc::parallel_for(0, trxs.size(), [this,&trxs,&chain_id](size_t i) {
+        trxs[i].signatures.clear();
+        trxs[i].sign(*p_key, chain_id);
+    });
+
+    // the rewards are recorded once the transactions are seen in a block, see confirm_bonus_transactions
+    for (size_t t = 0; t < trxs.size(); ++t) {
+        auto& pending = checkpoint.pending[trxs[t].id()];
+        pending.expiration = trxs[t].expiration;
+        for (size_t i = trx_first_entry[t]; i < trx_first_entry[t + 1]; ++i) {
+            const auto& elem = entries[i];
+            bonus_payment payment;
+            payment.account = elem.to_account.id;
+            payment.quantity = elem.quantity;
+            payment.core_transfer = elem.is_core_transfer;
+            if (elem.is_core_transfer || elem.memo_string == "Daily mining reward")
+                payment.kind = elem.memo_string;
+            else
+                payment.kind = "Referral reward";
+            pending.payments.push_back(payment);
+        }
+    }
+    save_checkpoint();
+
+    my->_p2p_network->broadcast_transactions(trxs);
+    ilog("Issued ${n} rewards in ${t} transactions, ${l} left", ("n", entries.size())("t", trxs.size())("l", bonus_storage.size()));
+
+    if (!bonus_storage.size()) return;
+    fc::time_point next_wakeup( fc::time_point::now() + fc::seconds(params.block_interval));
     fc::schedule([this]{issue_from_storage();},
                  next_wakeup, "issue_from_storage");
 }
@@ -1051,7 +1226,9 @@ void application::referrer_bonus()
 {
  auto& d = *my->_chain_db;
  const auto& idx = d.get_index_type<chain::account_index>();
- if (get_core_transfers("Referral reward").size()) {
+ const bool trusted = use_checkpoint();
+ if (checkpoint.completed.count("Referral reward") ||
+     (!trusted && get_core_transfers("Referral reward").size())) {
      std::cout << "return2" << std::endl;
      return;
  }
@@ -1062,7 +1239,8 @@ void application::referrer_bonus()
 
      const uint64_t balance = d.get_balance(account.id, asset->id).amount.value;
      if (balance < 200 * PRECISION) return;
-     auto history = get_history(account_id_type(account.id));
+     if (checkpoint.referral_rewards.count(account.id)) return;
+     auto history = trusted ? vector<operation_history_object>() : get_history(account_id_type(account.id));
      for( auto h = history.begin(); h < history.end(); h++) {
          if (h->op.which() == 14) {
              auto op = h->op.get<asset_issue_operation>();
@@ -1073,8 +1251,7 @@ void application::referrer_bonus()
              }
          }
      }
-     auto bonuses = get_daily_bonus(account.id);
-     if (!bonuses.size()) return;
+     if (!get_daily_bonus(account.id)) return;
 
      uint64_t bonus_value = 0;
      std::vector<account_object> level_1, level_2, level_3;
@@ -1137,35 +1314,31 @@ void application::referrer_bonus()
          }
          if (bonus_percent == 0) return;
          for (auto& ref : level_1) {
-             auto bonuses = get_daily_bonus(ref.id);
-             if (bonuses.size()) {
-                 int bonus = bonuses[0].asset_to_issue.amount.value * bonus_percent;
+             if (auto daily_bonus = get_daily_bonus(ref.id)) {
+                 int bonus = daily_bonus * bonus_percent;
                  bonus_value += bonus;
                  ref_s << sep << "{\"i\":" << ref.get_id().instance.value << ",\"l\":1" << ",\"v\":" << bonus << "}";
                  sep = ",";
              }
          }
          for (auto& ref : level_2) {
-             auto bonuses = get_daily_bonus(ref.id);
-             if (bonuses.size()) {
-                 int bonus = bonuses[0].asset_to_issue.amount.value * bonus_percent;
+             if (auto daily_bonus = get_daily_bonus(ref.id)) {
+                 int bonus = daily_bonus * bonus_percent;
                  bonus_value += bonus;
                  ref_s << sep << "{\"i\":" << ref.get_id().instance.value << ",\"l\":2" << ",\"v\":" << bonus << "}";
              }
          }
          for (auto& ref : level_3) {
-             auto bonuses = get_daily_bonus(ref.id);
-             if (bonuses.size()) {
-                 int bonus = bonuses[0].asset_to_issue.amount.value * bonus_percent;
+             if (auto daily_bonus = get_daily_bonus(ref.id)) {
+                 int bonus = daily_bonus * bonus_percent;
                  bonus_value += bonus;
                  ref_s << sep << "{\"i\":" << ref.get_id().instance.value << ",\"l\":3" << ",\"v\":" << bonus << "}";
              }
          }
      } else {
          for (auto& ref : level_1) {
-             auto bonuses = get_daily_bonus(ref.id);
-             if (bonuses.size()) {
-                 int bonus = bonuses[0].asset_to_issue.amount.value * 0.25;
+             if (auto daily_bonus = get_daily_bonus(ref.id)) {
+                 int bonus = daily_bonus * 0.25;
                  bonus_value += bonus;
                  ref_s << sep << "{\"i\":" << ref.get_id().instance.value << ",\"l\":1" << ",\"v\":" << bonus << "}";
                  sep = ",";
@@ -1181,31 +1354,87 @@ void application::referrer_bonus()
  fc::schedule([this]{issue_from_storage();},
              next_wakeup, "issue_from_storage");
 }
-void application::bonus_issued(std::string with_memo) {
-    auto exchange = my->_chain_db->get<account_object>(chain::account_id_type(19));
+chain::operation application::make_bonus_operation(const op_info& elem, const chain::asset_object& asst,
+                                                   const chain::account_object& exchange)const
+{
+    const auto& to_account = elem.is_core_transfer ? exchange : elem.to_account;
+    memo_data memo;
+    memo.from = from_account.options.memo_key;
+    memo.to = to_account.options.memo_key;
+    memo.set_message(*p_key, to_account.options.memo_key, elem.memo_string);
 
-    chain::transfer_operation op;
-    op.from = from_account.id;
-    op.to = exchange.id;
-    op.amount = asset(1000);
-    
-    op.memo = memo_data();
-    op.memo->from = from_account.options.memo_key;
-    op.memo->to = exchange.options.memo_key;
-    op.memo->set_message(*p_key,exchange.options.memo_key, with_memo);
-
-    chain::signed_transaction trx;
-    trx.operations.push_back(op);
-    auto dyn_props = my->_chain_db->get_dynamic_global_properties();
-    trx.set_reference_block( dyn_props.head_block_id );
-    my->_chain_db->current_fee_schedule().set_fee( trx.operations.back() );
-    
-    trx.set_expiration( my->_chain_db->get_slot_time( 120 ) );
-    trx.sign(*p_key, my->_chain_db->get_chain_id());
-    // my->_chain_db->push_transaction(trx);
-    my->_p2p_network->broadcast_transaction(trx);
+    if (elem.is_core_transfer) {
+        chain::transfer_operation op;
+        op.from = from_account.id;
+        op.to = exchange.id;
+        op.amount = asset(elem.quantity);
+        op.memo = memo;
+        return op;
+    }
+    chain::asset_issue_operation op;
+    op.issuer = asst.issuer;
+    op.asset_to_issue = asst.amount(elem.quantity);
+    op.issue_to_account = to_account.id;
+    op.memo = memo;
+    return op;
 }
-    
+
+bool application::use_checkpoint()
+{
+    const fc::path file = my->_data_dir / "bonus_checkpoint.json";
+    if (!checkpoint_loaded) {
+        checkpoint_loaded = true;
+        if (fc::exists(file)) {
+            try {
+                checkpoint = fc::json::from_file(file).as<bonus_checkpoint>(10);
+            } catch (const fc::exception& e) {
+                wlog("Ignoring unreadable bonus checkpoint ${f}: ${e}", ("f", file)("e", e.to_detail_string()));
+                checkpoint = bonus_checkpoint();
+            }
+            // the transactions broadcast before the restart are known to the chain until they expire
+            const auto& db = *my->_chain_db;
+            vector<chain::transaction_id_type> pending_ids;
+            for (const auto& pending : checkpoint.pending)
+                pending_ids.push_back(pending.first);
+            for (const auto& id : pending_ids)
+                if (db.is_known_transaction(id))
+                    checkpoint.confirm(id);
+            if (checkpoint.drop_expired(db.head_block_time())) {
+                wlog("Bonus transactions expired while the node was down, the account histories are scanned");
+                checkpoint.trusted = false;
+            }
+        }
+    }
+    if (checkpoint.date != bonus_day()) {
+        checkpoint.start_day(bonus_day());
+        save_checkpoint();
+    }
+    return checkpoint.trusted;
+}
+
+void application::save_checkpoint()const
+{
+    fc::json::save_to_file(checkpoint, my->_data_dir / "bonus_checkpoint.json");
+}
+
+void application::confirm_bonus_transactions(const signed_block& b)
+{
+    if (checkpoint.pending.empty()) return;
+    bool changed = false;
+    for (const auto& trx : b.transactions)
+        changed |= checkpoint.confirm(trx.id());
+    // the node saw every block since the transactions were broadcast, so the expired ones were not included
+    if (checkpoint.drop_expired(b.timestamp)) {
+        wlog("Bonus transactions expired without being included, the rewards are issued again by the next pass");
+        // the pass is not complete, so its completion transfer is left to the next pass
+        bonus_storage.erase(std::remove_if(bonus_storage.begin(), bonus_storage.end(),
+                                           [](const op_info& elem) { return elem.is_core_transfer; }),
+                            bonus_storage.end());
+        changed = true;
+    }
+    if (changed) save_checkpoint();
+}
+
 std::tuple<std::vector<account_object>, int> application::get_referrers(account_id_type account_id)
 {
     auto& d = *my->_chain_db;
@@ -1226,34 +1455,34 @@ std::tuple<std::vector<account_object>, int> application::get_referrers(account_
     return std::make_tuple(result, count);
 }
     
-std::vector<asset_issue_operation> application::get_daily_bonus(chain::account_id_type account_id)
+uint64_t application::get_daily_bonus(chain::account_id_type account_id)
 {
+    auto itr = checkpoint.daily_rewards.find(account_id);
+    if (itr != checkpoint.daily_rewards.end()) return itr->second;
+    if (checkpoint.trusted) return 0;
+
     auto history = get_history(account_id);
-    std::vector<asset_issue_operation> result;
     for( auto h = history.begin(); h < history.end(); h++) {
         if (h->op.which() == 14) {
             auto op = h->op.get<asset_issue_operation>();
             if ("Daily mining reward" == op.memo->get_message(*p_key, op.memo->to)) {
-                result.push_back(op);
+                return op.asset_to_issue.amount.value;
             };
         }
     }
-    return result;
+    return 0;
 }
     
 vector<operation_history_object> application::get_history(account_id_type account)
 {
     auto& db = *my->_chain_db;
     vector<operation_history_object> result;
-    const auto& stats = account(db).statistics(db);
-        
-    const account_transaction_history_object* node = &stats.most_recent_op(db);
-    
-    while(date_string(time_point(db.fetch_block_by_number(node->operation_id.operator()(db).block_num)->timestamp)) == date_string(time_point::now() - fc::hours(9))) {
-        result.push_back( node->operation_id(db) );
-        if (node->next == account_transaction_history_id_type()) break;
-        node = &node->next(db);
-    }
+    // archived operations are continued from the history store
+    graphene::history::visit_account_history(db, history_store(), account, [&](const operation_history_object& h) {
+        if (date_string(time_point(db.fetch_block_by_number(h.block_num)->timestamp)) != bonus_day()) return false;
+        result.push_back(h);
+        return true;
+    });
     return result;
 }
     
@@ -1263,10 +1492,8 @@ vector<transfer_operation> application::get_core_transfers(std::string with_memo
     account_id_type from = from_account.id;
     auto& db = *my->_chain_db;
     vector<transfer_operation> result;
-    const auto& stats = from(db).statistics(db);
-    const account_transaction_history_object* node = &stats.most_recent_op(db);
-    while(date_string(time_point(db.fetch_block_by_number(node->operation_id.operator()(db).block_num)->timestamp)) >= date_string(time_point::now() - fc::hours(9))) {
-       auto op_hist = node->operation_id(db);
+    graphene::history::visit_account_history(db, history_store(), from, [&](const operation_history_object& op_hist) {
+        if (date_string(time_point(db.fetch_block_by_number(op_hist.block_num)->timestamp)) < bonus_day()) return false;
         if (op_hist.op.which() == 0) {
             auto op = op_hist.op.get<transfer_operation>();
             if (op.memo.valid() && 
@@ -1278,36 +1505,11 @@ vector<transfer_operation> application::get_core_transfers(std::string with_memo
                 }
             }
         }
-        if (node->next == account_transaction_history_id_type()) break;
-        node = &node->next(db);
-    }
+        return true;
+    });
     return result;
 }
 
-void application::issue_bonus(const chain::account_object& to_account, long long quant, std::string with_memo)
-{
-    auto asst = *my->_chain_db->get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
-    
-    chain::signed_transaction trx;
-    chain::asset_issue_operation op;
-    op.issuer = asst.issuer;
-    op.asset_to_issue = asst.amount(quant);
-    op.issue_to_account = to_account.id;
-    
-    op.memo = memo_data();
-    op.memo->from = from_account.options.memo_key;
-    op.memo->to = to_account.options.memo_key;
-    op.memo->set_message(*p_key,to_account.options.memo_key, with_memo);
-    trx.operations.push_back(op);
-    trx.set_expiration( my->_chain_db->get_slot_time( 120 ) );
-    auto dyn_props = my->_chain_db->get_dynamic_global_properties();
-    trx.set_reference_block( dyn_props.head_block_id );
-    my->_chain_db->current_fee_schedule().set_fee( trx.operations.back() );
-    trx.sign(*p_key, my->_chain_db->get_chain_id());
-    // my->_chain_db->push_transaction(trx);
-    my->_p2p_network->broadcast_transaction(trx);
-}
-
 std::shared_ptr<abstract_plugin> application::get_plugin(const string& name) const
 {
    return my->_plugins[name];
@@ -1323,6 +1525,15 @@ std::shared_ptr<chain::database> application::chain_database() const
    return my->_chain_db;
 }
 
+graphene::history::operation_history_store* application::history_store() const
+{
+   auto itr = my->_plugins.find( "history" );
+   if( itr == my->_plugins.end() )
+      return nullptr;
+   auto plugin = std::dynamic_pointer_cast<graphene::history::history_plugin>( itr->second );
+   return plugin ? plugin->history_store() : nullptr;
+}
+
 void application::set_block_production(bool producing_blocks)
 {
    my->_is_block_producer = producing_blocks;
@@ -51,6 +51,13 @@ class application_impl : public net::node_delegate
 
       virtual void handle_transaction(const graphene::net::trx_message& transaction_message) override;
 
+      /**
+       * Runs on a worker thread: validates the transaction and recovers its signature keys, so that
+       * handle_transaction() only has to check the authorities against the chain state.
+       */
+      virtual void prevalidate_block(const graphene::net::block_message& blk_msg) override;
+      virtual void prevalidate_transaction(const graphene::net::trx_message& transaction_message) override;
+
       virtual void handle_message(const message& message_to_process) override;
 
       bool is_included_block(const block_id_type& block_id);
@@ -180,6 +187,9 @@ class application_impl : public net::node_delegate
       std::map<string, std::shared_ptr<abstract_plugin>> _plugins;
 
       bool _is_finished_syncing = false;
+
+      /// the outcome of prevalidate_transaction(), kept until handle_transaction() takes it
+      prevalidated_transactions _prevalidated_transactions;
    };
 
 }}} // namespace graphene::app::detail
\ No newline at end of file
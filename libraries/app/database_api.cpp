@@ -25,6 +25,7 @@
 #include "database_api_impl.hxx"
 
 #include <graphene/chain/get_config.hpp>
+#include <graphene/history/operation_history_store.hpp>
 #include <graphene/chain/settings_object.hpp>
 #include <graphene/protocol/pts_address.hpp>
 #include <graphene/protocol/asset.hpp>
@@ -53,12 +54,13 @@ namespace graphene { namespace app {
 //                                                                  //
 //////////////////////////////////////////////////////////////////////
 
-database_api::database_api( graphene::chain::database& db )
-   : my( new database_api_impl( db ) ) {}
+database_api::database_api( graphene::chain::database& db, graphene::history::operation_history_store* history_store )
+   : my( new database_api_impl( db, history_store ) ) {}
 
 database_api::~database_api() {}
 
-database_api_impl::database_api_impl( graphene::chain::database& db ):_db(db)
+database_api_impl::database_api_impl( graphene::chain::database& db, graphene::history::operation_history_store* history_store )
+   :_db(db), _history_store(history_store)
 {
    wlog("creating database api ${x}", ("x",int64_t(this)) );
    _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids) {
@@ -113,6 +115,7 @@ fc::variants database_api_impl::get_objects(const vector<object_id_type>& ids) c
                      // exceptions
                      if ((id.space() == implementation_ids) && (id.type() == impl_blind_transfer2_object_type)) return { };
                      if ((id.space() == protocol_ids) && (id.type() == cheque_object_type)) return { };
+                     if ((id.space() == implementation_ids) && (id.type() == impl_cheque_payee_object_type)) return { };
 
                      if (auto obj = _db.find_object(id))
                      {
@@ -631,6 +634,16 @@ dynamic_global_property_object database_api_impl::get_dynamic_global_properties(
    return _db.get(dynamic_global_property_id_type());
 }
 
+block_timing_statistics database_api::get_block_timing_statistics()const
+{
+   return my->get_block_timing_statistics();
+}
+
+block_timing_statistics database_api_impl::get_block_timing_statistics()const
+{
+   return _db.get_block_timing_statistics();
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Keys                                                             //
@@ -1411,24 +1424,44 @@ database_api_impl::get_all_fund_deposits_by_period(uint32_t period, uint32_t sta
    result.reserve(100);
    uint32_t new_start = 0;
 
-   const auto& dep_by_id = _db.get_index_type<fund_deposit_index>().indices().get<by_fund_id>();
-   auto itr = dep_by_id.begin();
+   const auto& dep_by_period = _db.get_index_type<fund_deposit_index>().indices().get<by_period>();
+   auto range = dep_by_period.equal_range(period);
    uint32_t i = 0;
-   while ( (i >= start) && (i < limit) && (itr != dep_by_id.end()) )
+   for (auto itr = range.first; (itr != range.second) && (result.size() < limit); ++itr, ++i)
    {
-      const fund_deposit_object& o = *itr;
-
-      if (o.period == period)
+      if (i >= start)
       {
-         result.emplace_back(o);
+         result.emplace_back(*itr);
          new_start = i;
-         ++i;
       }
+   }
+
+   return std::make_pair(result, new_start);
+}
 
+vector<fund_deposit_object>
+database_api::get_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start, uint32_t limit) const {
+   return my->get_fund_deposits_by_period(period, start, limit);
+}
+
+vector<fund_deposit_object>
+database_api_impl::get_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start, uint32_t limit) const
+{
+   FC_ASSERT( limit <= 100 );
+
+   vector<fund_deposit_object> result;
+   result.reserve(limit);
+
+   const auto& dep_by_period = _db.get_index_type<fund_deposit_index>().indices().get<by_period>();
+   auto itr = dep_by_period.lower_bound(boost::make_tuple(period, object_id_type(start)));
+   auto end = dep_by_period.upper_bound(period);
+   while ( (itr != end) && (result.size() < limit) )
+   {
+      result.emplace_back(*itr);
       ++itr;
    }
 
-   return std::make_pair(result, new_start);
+   return result;
 }
 
 asset database_api::get_fund_deposits_amount_by_account(fund_id_type fund_id, account_id_type account_id) const {
@@ -2803,14 +2836,30 @@ int64_t database_api_impl::get_user_count_with_balances(fc::time_point_sec start
          auto balance = _db.get_balance(account->id, asset->id).amount.value;
          if (balance < 1) continue;
 
-         const auto& stats = account->statistics(_db);
-         const account_transaction_history_object* node = &stats.most_recent_op(_db);
-         //uint32_t ops_count = stats.total_ops;
-         while (true) {
-            if (node->next == account_transaction_history_id_type()) break;
-            node = &node->next(_db);
+         // the first operation of the account, archived ones are older than those in the object database
+         optional<operation_history_object> first;
+         if (_history_store && !_history_store->account_history(account->id).empty()) {
+            first = _history_store->fetch(operation_history_id_type(_history_store->account_history(account->id).front().operation));
+         }
+         else {
+            const auto& stats = account->statistics(_db);
+            const account_transaction_history_object* node = nullptr;
+            if (stats.most_recent_op != account_transaction_history_id_type()) {
+               node = _db.find(stats.most_recent_op);
+            }
+            // links to pruned objects end the walk
+            while (node && node->next != account_transaction_history_id_type()) {
+               const account_transaction_history_object* older = _db.find(node->next);
+               if (!older) break;
+               node = older;
+            }
+            const operation_history_object* op = node ? _db.find(node->operation_id) : nullptr;
+            if (op) {
+               first = *op;
+            }
          }
-         auto& hist = node->operation_id(_db);
+         if (!first.valid()) continue;
+         const operation_history_object& hist = *first;
          if (hist.op.which() == 5) { // account_create_operation 
             auto op = hist.op.get<account_create_operation>();
             fc::time_point_sec create_time = _db.fetch_block_by_number(hist.block_num)->timestamp;
@@ -2864,4 +2913,30 @@ database_api_impl::get_users_with_asset(const asset_id_type& asst, uint32_t star
    return {last_item_num, v_result};
 }
 
+vector<account_id_type>
+database_api::get_asset_holders(asset_id_type asset_id, account_id_type start, uint32_t limit) const {
+   return my->get_asset_holders(asset_id, start, limit);
+}
+
+vector<account_id_type>
+database_api_impl::get_asset_holders(asset_id_type asset_id, account_id_type start, uint32_t limit) const
+{
+   FC_ASSERT( limit <= 100 );
+   FC_ASSERT( _db.find(asset_id), "There is no asset with ID ${id}", ("id", asset_id) );
+
+   vector<account_id_type> result;
+   result.reserve(limit);
+
+   const auto& idx = _db.get_index_type<account_balance_index>().indices().get<by_asset_holder>();
+   auto itr = idx.lower_bound(boost::make_tuple(asset_id, true, start));
+   auto end = idx.upper_bound(boost::make_tuple(asset_id, true));
+   while ( (itr != end) && (result.size() < limit) )
+   {
+      result.emplace_back(itr->owner);
+      ++itr;
+   }
+
+   return result;
+}
+
 } } // graphene::app
@@ -10,7 +10,7 @@ namespace graphene { namespace app {
 class database_api_impl : public std::enable_shared_from_this<database_api_impl>
 {
    public:
-      explicit database_api_impl( graphene::chain::database& db );
+      database_api_impl( graphene::chain::database& db, graphene::history::operation_history_store* history_store );
       ~database_api_impl();
 
       // Objects
@@ -36,6 +36,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       fc::variant_object get_config() const;
       chain_id_type get_chain_id() const;
       dynamic_global_property_object get_dynamic_global_properties() const;
+      block_timing_statistics get_block_timing_statistics() const;
 
       // Keys
       vector<vector<account_id_type>> get_key_references( vector<public_key_type> key ) const;
@@ -63,6 +64,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       fc::variant_object get_user_count_by_ranks() const;
       int64_t get_user_count_with_balances(fc::time_point_sec start, fc::time_point_sec end) const;
       std::pair<uint32_t, std::vector<account_id_type>> get_users_with_asset(const asset_id_type& asst, uint32_t start, uint32_t limit) const;
+      vector<account_id_type> get_asset_holders(asset_id_type asset_id, account_id_type start, uint32_t limit) const;
       vector<account_id_type> get_account_references(account_id_type account_id) const;
       optional<restricted_account_object> get_restricted_account(account_id_type account_id) const;
       vector<optional<account_object>> lookup_account_names(const vector<string>& account_names)const;
@@ -89,6 +91,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       vector<fund_deposit_object>     get_fund_deposits(const std::string& fund_name_or_id, uint32_t start, uint32_t limit) const;
       pair<vector<fund_deposit_object>, uint32_t>
                                       get_all_fund_deposits_by_period(uint32_t period, uint32_t start, uint32_t limit) const;
+      vector<fund_deposit_object>     get_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start, uint32_t limit) const;
       asset                           get_fund_deposits_amount_by_account(fund_id_type fund_id, account_id_type account_id) const;
       vector<fund_deposit_object>     get_account_deposits(account_id_type account_id, uint32_t start, uint32_t limit) const;
       vector<market_address_object>   get_market_addresses(account_id_type account_id, uint32_t start, uint32_t limit) const;
@@ -197,6 +200,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       boost::signals2::scoped_connection _pending_trx_connection;
       map<pair<asset_id_type,asset_id_type>, std::function<void(const variant&)>> _market_subscriptions;
       graphene::chain::database& _db;
+      graphene::history::operation_history_store* _history_store;
 };
 
 } } // graphene::app
@@ -40,12 +40,20 @@
 #include <fc/network/ip.hpp>
 
 #include <boost/container/flat_set.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
 
 #include <functional>
 #include <map>
 #include <string>
 #include <vector>
 
+namespace graphene { namespace history {
+   class operation_history_store;
+} }
+
 namespace graphene { namespace app {
    using namespace graphene::chain;
    using namespace graphene::market_history;
@@ -171,6 +179,17 @@ namespace graphene { namespace app {
          flat_set<uint32_t> get_market_history_buckets()const;
 
       private:
+           graphene::history::operation_history_store* history_store()const;
+           /** @return the operation from the object database or from the on-disk history store */
+           optional<operation_history_object> find_operation(operation_history_id_type id)const;
+           /**
+            * Visits operations of the account from the most recent to the oldest, reversible ones
+            * from the object database and then the irreversible ones from the history store.
+            * The walk stops when @p visit returns false.
+            */
+           void visit_account_history(account_id_type account,
+                                      const std::function<bool(const operation_history_object&)>& visit)const;
+
            application& _app;
    };
 
@@ -213,8 +232,21 @@ namespace graphene { namespace app {
             processed_transaction trx;
          };
 
+         struct broadcast_result
+         {
+            transaction_id_type id;
+            bool                accepted = false;
+            /// why the transaction was rejected
+            optional<string>    error;
+         };
+
          typedef std::function<void(variant/*transaction_confirmation*/)> confirmation_callback;
 
+         /// limit of @ref broadcast_transactions
+         static const size_t max_broadcast_batch_size = 1000;
+         /// default limit of the callbacks waiting for their transaction to be included into a block
+         static const size_t max_pending_confirmations = 100000;
+
          /**
           * @brief Broadcast a transaction to the network
           * @param trx The transaction to broadcast
@@ -224,9 +256,20 @@ namespace graphene { namespace app {
           */
          void broadcast_transaction(const signed_transaction& trx);
 
+         /**
+          * @brief Broadcast a batch of transactions to the network
+          * @param trxs The transactions to broadcast, at most max_broadcast_batch_size
+          * @return One result per transaction, in the order of @p trxs
+          *
+          * The stateless checks and the recovery of the signing keys run in parallel, then the transactions are
+          * applied to the local database one after the other. A rejected transaction does not stop the batch.
+          * All accepted transactions are advertised to the peers together.
+          */
+         vector<broadcast_result> broadcast_transactions(const vector<signed_transaction>& trxs);
+
          /** this version of broadcast transaction registers a callback method that will be called when the transaction is
           * included into a block.  The callback method includes the transaction id, block number, and transaction number in the
-          * block.
+          * block. The callback is dropped without being called once the transaction has expired.
           */
          void broadcast_transaction_with_callback( confirmation_callback cb, const signed_transaction& trx);
          void broadcast_transaction_with_callback_new( confirmation_callback cb, const signed_transaction& trx);
@@ -244,9 +287,36 @@ namespace graphene { namespace app {
           * to be notified when a particular txid is included in a block.
           */
          void on_applied_block( const signed_block& b );
+
+         /// @brief Not reflected. Limits the number of pending confirmation callbacks, max_pending_confirmations by default
+         void set_max_pending_confirmations( size_t limit );
+         /// @brief Not reflected. @return number of callbacks waiting for their transaction
+         size_t pending_confirmations()const;
       private:
+         struct pending_confirmation
+         {
+            transaction_id_type   id;
+            time_point_sec        expiration;
+            confirmation_callback callback;
+         };
+         struct by_expiration;
+         typedef boost::multi_index_container<
+            pending_confirmation,
+            boost::multi_index::indexed_by<
+               boost::multi_index::hashed_unique<
+                  BOOST_MULTI_INDEX_MEMBER( pending_confirmation, transaction_id_type, id ), std::hash<transaction_id_type> >,
+               boost::multi_index::ordered_non_unique< boost::multi_index::tag<by_expiration>,
+                  BOOST_MULTI_INDEX_MEMBER( pending_confirmation, time_point_sec, expiration ) >
+            >
+         > pending_confirmation_index;
+
+         /// makes room for the callback of @p id by dropping expired ones, asserts that the table is not full
+         void reserve_callback( const transaction_id_type& id );
+         void add_callback( const signed_transaction& trx, confirmation_callback cb );
+
          boost::signals2::scoped_connection             _applied_block_connection;
-         map<transaction_id_type,confirmation_callback> _callbacks;
+         pending_confirmation_index                     _callbacks;
+         size_t                                         _max_pending_confirmations = max_pending_confirmations;
          application&                                   _app;
    };
 
@@ -400,6 +470,8 @@ extern template class fc::api<graphene::app::login_api>;
 FC_REFLECT( graphene::app::listtransactions_result, (transfer)(confirmations) );
 FC_REFLECT( graphene::app::network_broadcast_api::transaction_confirmation,
         (id)(block_num)(trx_num)(trx) )
+FC_REFLECT( graphene::app::network_broadcast_api::broadcast_result,
+        (id)(accepted)(error) )
 FC_REFLECT( graphene::app::verify_range_result,
         (success)(min_val)(max_val) )
 FC_REFLECT( graphene::app::verify_range_proof_rewind_result,
@@ -430,6 +502,7 @@ FC_API(graphene::app::secure_api,
 )
 FC_API(graphene::app::network_broadcast_api,
        (broadcast_transaction)
+       (broadcast_transactions)
        (broadcast_transaction_with_callback)
        (broadcast_transaction_with_callback_new)
        (broadcast_block)
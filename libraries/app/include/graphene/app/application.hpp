@@ -27,8 +27,12 @@
 #include <graphene/net/node.hpp>
 #include <graphene/chain/database.hpp>
 
+#include <fc/container/flat.hpp>
+
 #include <boost/program_options.hpp>
 
+namespace graphene { namespace history { class operation_history_store; } }
+
 namespace graphene { namespace app {
    namespace detail { class application_impl; }
    using std::string;
@@ -47,6 +51,54 @@ namespace graphene { namespace app {
       std::string memo_string;
       bool is_core_transfer;
    };
+
+   /// a reward of a broadcast transaction
+   struct bonus_payment
+   {
+      chain::account_id_type account;
+      uint64_t               quantity = 0;
+      /// the memo of a completion transfer, else "Daily mining reward" or "Referral reward"
+      string                 kind;
+      bool                   core_transfer = false;
+   };
+
+   /// a broadcast transaction of rewards which was not seen in a block yet
+   struct bonus_pending_transaction
+   {
+      fc::time_point_sec         expiration;
+      std::vector<bonus_payment> payments;
+   };
+
+   /**
+    * Rewards issued on one day, kept in the data directory so that a restarted node neither pays an
+    * account twice nor has to scan the account histories to find out who has been paid already.
+    * Rewards are only recorded once their transaction was included in a block.
+    */
+   struct bonus_checkpoint
+   {
+      /// the day as date_string() returns it, the entries below are only valid for this day
+      string                                             date;
+      /// whether the checkpoint knows every reward of the day, else the account histories are scanned
+      bool                                               trusted = false;
+      /// daily mining reward issued to every account
+      fc::flat_map<chain::account_id_type, uint64_t>     daily_rewards;
+      /// accounts which received the referral reward
+      fc::flat_set<chain::account_id_type>               referral_rewards;
+      /// memos of the completion transfers sent to the exchange
+      fc::flat_set<string>                               completed;
+      /// broadcast transactions which were not included in a block yet
+      fc::flat_map<chain::transaction_id_type, bonus_pending_transaction> pending;
+
+      /// forgets the rewards of the previous day, a node which kept a checkpoint then knows all of the new day
+      void start_day( const string& day );
+      /// records the rewards of a pending transaction which was included in a block
+      /// @return false if the transaction is not pending
+      bool confirm( const chain::transaction_id_type& id );
+      /// forgets the pending transactions which expired before @p now without being confirmed
+      /// @return true if any was dropped
+      bool drop_expired( fc::time_point_sec now );
+   };
+
    class application
    {
       public:
@@ -92,6 +144,8 @@ namespace graphene { namespace app {
 
          net::node_ptr                    p2p_node();
          std::shared_ptr<chain::database> chain_database()const;
+         /// @return the on-disk operation history store of the history plugin, or nullptr if it is not used
+         graphene::history::operation_history_store* history_store()const;
 
          void set_block_production(bool producing_blocks);
          fc::optional< api_access_info > get_api_access_info( const string& username )const;
@@ -109,20 +163,31 @@ namespace graphene { namespace app {
          fc::optional<fc::ecc::private_key> p_key;
          std::vector<op_info> bonus_storage;
          chain::account_object from_account;
+         bonus_checkpoint checkpoint;
+         bool checkpoint_loaded = false;
        
          void bonus_schedule();
          void bonus_schedule_loop();
          void referrer_bonus();
-         void issue_bonus(const chain::account_object& account, long long amount, std::string with_memo);
-         void bonus_issued(std::string with_memo);
          void issue_from_storage();
+         chain::operation make_bonus_operation(const op_info& elem, const chain::asset_object& asst,
+                                               const chain::account_object& exchange)const;
+         bool use_checkpoint();
+         void save_checkpoint()const;
+         /// moves the rewards of the pending transactions included in @p b to the checkpoint
+         void confirm_bonus_transactions(const chain::signed_block& b);
          std::vector<chain::operation_history_object> get_history(chain::account_id_type account);
          std::vector<chain::transfer_operation> get_core_transfers(std::string with_memo);
          std::tuple<std::vector<chain::account_object>,int> get_referrers(chain::account_id_type);
       //    std::tuple<std::vector<chain::account_object>,int> scan_referrers(std::vector<chain::account_object> level_2);
-         std::vector<chain::asset_issue_operation> get_daily_bonus(chain::account_id_type);
+         /// the daily mining reward the account received today, 0 if none
+         uint64_t get_daily_bonus(chain::account_id_type);
          boost::program_options::options_description _cli_options;
          boost::program_options::options_description _cfg_options;
    };
 
 } }
+
+FC_REFLECT( graphene::app::bonus_payment, (account)(quantity)(kind)(core_transfer) )
+FC_REFLECT( graphene::app::bonus_pending_transaction, (expiration)(payments) )
+FC_REFLECT( graphene::app::bonus_checkpoint, (date)(trusted)(daily_rewards)(referral_rewards)(completed)(pending) )
@@ -58,6 +58,8 @@
 #include <memory>
 #include <vector>
 
+namespace graphene { namespace history { class operation_history_store; } }
+
 namespace graphene { namespace app {
 
 using namespace graphene::chain;
@@ -149,7 +151,8 @@ struct max_transfer_info
 class database_api
 {
    public:
-      database_api(graphene::chain::database& db);
+      /// @param history_store archived operation history, used for account histories if not null
+      database_api(graphene::chain::database& db, graphene::history::operation_history_store* history_store = nullptr);
       ~database_api();
 
       /////////////
@@ -247,6 +250,13 @@ class database_api
        */
       dynamic_global_property_object get_dynamic_global_properties()const;
 
+      /**
+       * @brief Retrieve where the time of applying blocks went since the node started
+       * @return histograms of block phases, operation evaluation and application per operation type,
+       * plugin applied_block handlers and undo state sizes, times are in microseconds
+       */
+      block_timing_statistics get_block_timing_statistics()const;
+
       //////////
       // Keys //
       //////////
@@ -304,10 +314,21 @@ class database_api
 
       /**
        * @return number of the last element in query and user ids who have asset 'asst'
+       * @note 'start' counts all balance objects of all assets, use @ref get_asset_holders to page through holders
        */
       std::pair<uint32_t, std::vector<account_id_type>>
       get_users_with_asset(const asset_id_type& asst, uint32_t start, uint32_t limit) const;
 
+      /**
+       * @brief Get ids of accounts which have a positive balance of the asset, ordered by account id
+       * @param asset_id ID of the asset
+       * @param start Lower bound of the first account id to return
+       * @param limit Maximum number of accounts to fetch (must not exceed 100)
+       * @return ids of holders, to get the next page pass the last returned id + 1 as 'start'
+       */
+      vector<account_id_type>
+      get_asset_holders(asset_id_type asset_id, account_id_type start, uint32_t limit) const;
+
       /**
        * @brief Fetch all objects relevant to the specified accounts and subscribe to updates
        * @param callback Function to call with updates
@@ -443,12 +464,23 @@ class database_api
       /**
        * @brief Get all fund deposits alphabetically by id
        * @param period Period (in days)
+       * @param start Number of deposits with this period to skip
        * @param limit Maximum number of deposits to fetch (must not exceed 100)
        * @return the fund deposits found | new start position
        */
       pair<vector<fund_deposit_object>, uint32_t>
       get_all_fund_deposits_by_period(uint32_t period, uint32_t start, uint32_t limit) const;
 
+      /**
+       * @brief Get fund deposits with the given period, ordered by id
+       * @param period Period (in days)
+       * @param start Lower bound of the first deposit id to return
+       * @param limit Maximum number of deposits to fetch (must not exceed 100)
+       * @return the fund deposits found, to get the next page pass the last returned id + 1 as 'start'
+       */
+      vector<fund_deposit_object>
+      get_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start, uint32_t limit) const;
+
       /**
        * @brief Get sum of all user's deposits
        * @param fund_id ID of fund
@@ -779,6 +811,7 @@ FC_API(graphene::app::database_api,
    (get_config)
    (get_chain_id)
    (get_dynamic_global_properties)
+   (get_block_timing_statistics)
 
    // Keys
    (get_key_references)
@@ -797,6 +830,7 @@ FC_API(graphene::app::database_api,
    (get_user_count_by_ranks)
    (get_user_count_with_balances)
    (get_users_with_asset)
+   (get_asset_holders)
    (get_full_accounts)
    (get_bonus_balances)
    (get_account_by_name)
@@ -825,6 +859,7 @@ FC_API(graphene::app::database_api,
    (get_fund_by_owner)
    (get_fund_deposits)
    (get_all_fund_deposits_by_period)
+   (get_fund_deposits_by_period)
    (get_fund_deposits_amount_by_account)
    (get_account_deposits)
 
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/protocol/transaction.hpp>
+
+#include <fc/container/flat.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace graphene { namespace chain { class database; } }
+
+namespace graphene { namespace app {
+
+   using graphene::protocol::signed_transaction;
+   using graphene::protocol::transaction_id_type;
+
+   /**
+    * @brief Results of the transaction checks done on a worker thread
+    *
+    * prevalidate() validates a transaction and recovers its signature keys without touching the chain
+    * state, push_transaction() later takes the result on the chain thread so that only the authorities
+    * remain to be checked.  Transactions the node never hands over are dropped, oldest first, once there
+    * are too many.
+    */
+   class prevalidated_transactions
+   {
+      public:
+         /// the outcome of prevalidate()
+         struct result
+         {
+            std::vector<graphene::protocol::signature_type>   signatures; ///< the result only applies to a transaction with these signatures
+            fc::flat_set<graphene::protocol::public_key_type> signature_keys;
+            fc::exception_ptr                                 error;
+         };
+
+         static const size_t default_max_size = 10000;
+
+         explicit prevalidated_transactions( size_t max_size = default_max_size ) : _max_size( max_size ) {}
+
+         /// checks trx and keeps the outcome, safe to call from any thread
+         void prevalidate( const signed_transaction& trx, const graphene::protocol::chain_id_type& chain_id );
+         /// keeps r as the outcome of the checks of the transaction id, replacing an older one
+         void insert( const transaction_id_type& id, result r );
+         /// removes the outcome kept for trx, returns it if it was made for the same signatures
+         fc::optional<result> take( const signed_transaction& trx );
+
+         /**
+          * Pushes trx to db, reusing the outcome of prevalidate() if there is one.  Without it the
+          * transaction is pushed with all of its checks.
+          */
+         void push_transaction( graphene::chain::database& db, const signed_transaction& trx );
+
+         size_t size()const;
+
+      private:
+         typedef std::list<transaction_id_type> order_type;
+
+         const size_t _max_size;
+         mutable std::mutex _mutex;
+         order_type _order; ///< oldest first
+         std::unordered_map<transaction_id_type, std::pair<result, order_type::iterator>> _results;
+   };
+
+} } // graphene::app
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/app/prevalidated_transactions.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+
+namespace graphene { namespace app {
+
+using namespace graphene::chain;
+
+void prevalidated_transactions::prevalidate( const signed_transaction& trx, const chain_id_type& chain_id )
+{
+   result r;
+   r.signatures = trx.signatures;
+   try {
+      trx.validate();
+      r.signature_keys = trx.get_signature_keys( chain_id );
+   } catch( const fc::exception& e ) {
+      r.error = e.dynamic_copy_exception();
+   }
+   insert( trx.id(), std::move( r ) );
+}
+
+void prevalidated_transactions::insert( const transaction_id_type& id, result r )
+{
+   std::lock_guard<std::mutex> lock( _mutex );
+   auto itr = _results.find( id );
+   if( itr != _results.end() )
+   {
+      itr->second.first = std::move( r );
+      // the replaced outcome counts as the newest one
+      _order.splice( _order.end(), _order, itr->second.second );
+      return;
+   }
+   _results.emplace( id, std::make_pair( std::move( r ), _order.insert( _order.end(), id ) ) );
+   while( _order.size() > _max_size )
+   {
+      _results.erase( _order.front() );
+      _order.pop_front();
+   }
+}
+
+fc::optional<prevalidated_transactions::result> prevalidated_transactions::take( const signed_transaction& trx )
+{
+   fc::optional<result> r;
+   std::lock_guard<std::mutex> lock( _mutex );
+   auto itr = _results.find( trx.id() );
+   if( itr == _results.end() )
+      return r;
+   if( itr->second.first.signatures == trx.signatures )
+      r = std::move( itr->second.first );
+   _order.erase( itr->second.second );
+   _results.erase( itr );
+   return r;
+}
+
+void prevalidated_transactions::push_transaction( database& db, const signed_transaction& trx )
+{
+   fc::optional<result> prevalidated = take( trx );
+   if( !prevalidated )
+   {
+      db.push_transaction( trx );
+      return;
+   }
+   if( prevalidated->error )
+      prevalidated->error->dynamic_rethrow_exception();
+
+   // the signatures were recovered on a worker thread, only the authorities need the chain state
+   auto get_active = [&db]( account_id_type id ) { return &id(db).active; };
+   auto get_owner  = [&db]( account_id_type id ) { return &id(db).owner;  };
+   graphene::protocol::verify_authority( trx.operations, prevalidated->signature_keys, get_active, get_owner,
+                                         db.get_global_properties().parameters.max_authority_depth );
+   db.push_transaction( trx, database::skip_transaction_signatures );
+}
+
+size_t prevalidated_transactions::size()const
+{
+   std::lock_guard<std::mutex> lock( _mutex );
+   return _results.size();
+}
+
+} } // graphene::app
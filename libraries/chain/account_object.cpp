@@ -219,6 +219,15 @@ void account_mature_balance_object::consider_mining(uint16_t minied_minutes) {
     balance = balance.value * (minied_minutes / minutes_in_day);
 }
 
+void account_mature_balance_object::reset(share_type real_balance, uint32_t epoch)
+{
+    balance = real_balance;
+    history.clear();
+    history.push_back(mature_balances_history(real_balance, real_balance));
+    mandatory_transfer = false;
+    maturity_epoch = epoch;
+}
+
 void account_statistics_object::process_fees(const account_object& a, database& d) const
 {
    if( pending_fees > 0 || pending_vested_fees > 0 )
@@ -472,7 +481,7 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_object,
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_balance_object,
                                 (graphene::db::object),
-                                (owner)(asset_type)(balance)(mandatory_transfer)
+                                (owner)(asset_type)(balance)(mandatory_transfer)(maturity_epoch)
                               )
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_statistics_object,
@@ -508,7 +517,7 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::bonus_balances_object,
                               )
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_mature_balance_object,
                                 (graphene::db::object),
-                                (owner)(asset_type)(balance)(history)(mandatory_transfer)
+                                (owner)(asset_type)(balance)(history)(mandatory_transfer)(maturity_epoch)
                               )
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::account_object )
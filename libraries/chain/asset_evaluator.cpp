@@ -119,15 +119,16 @@ object_id_type asset_create_evaluator::do_apply( const asset_create_operation& o
          a.fee_pool = core_fee_paid; //op.calculate_fee(db().current_fee_schedule()).value / 2;
       });
 
+   auto next_asset_id = db().get_index_type<asset_index>().get_next_id();
+
    asset_bitasset_data_id_type bit_asset_id;
    if( op.bitasset_opts.valid() )
       bit_asset_id = db().create<asset_bitasset_data_object>( [&]( asset_bitasset_data_object& a ) {
+            a.asset_id = next_asset_id;
             a.options = *op.bitasset_opts;
             a.is_prediction_market = op.is_prediction_market;
          }).id;
 
-   auto next_asset_id = db().get_index_type<asset_index>().get_next_id();
-
    const asset_object& new_asset =
      db().create<asset_object>( [&]( asset_object& a ) {
          a.issuer = op.issuer;
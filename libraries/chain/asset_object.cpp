@@ -45,6 +45,14 @@ share_type asset_bitasset_data_object::max_force_settlement_volume(share_type cu
    return static_cast<uint64_t>(volume);
 }
 
+void feed_update_index::mark( const object& obj )
+{
+   if( obj.id.space() == asset_bitasset_data_object::space_id )
+      _updated->insert( static_cast<const asset_bitasset_data_object&>( obj ).asset_id );
+   else if( static_cast<const asset_object&>( obj ).is_market_issued() )
+      _updated->insert( asset_id_type( obj.id ) );
+}
+
 void graphene::chain::asset_bitasset_data_object::update_median_feeds(time_point_sec current_time)
 {
    current_feed_publication_time = current_time;
@@ -169,6 +177,7 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::asset_dynamic_data_object, (gra
                     (fee_burnt) )
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::asset_bitasset_data_object, (graphene::db::object),
+                    (asset_id)
                     (options)
                     (feeds)
                     (current_feed)
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/block_timing.hpp>
+#include <graphene/protocol/operations.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <sstream>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+const char* const phase_names[] = {
+   "transactions",
+   "update_global_dynamic_data",
+   "update_signing_witness",
+   "update_last_irreversible_block",
+   "chain_maintenance",
+   "create_block_summary",
+   "clear_expired_transactions",
+   "clear_expired_proposals",
+   "clear_expired_orders",
+   "update_expired_feeds",
+   "update_withdraw_permissions",
+   "update_witness_schedule",
+   "applied_block",
+   "notify_changed_objects"
+};
+static_assert( sizeof(phase_names) / sizeof(phase_names[0]) == size_t(block_phase::phase_count),
+               "every block phase needs a name" );
+
+struct operation_name_visitor
+{
+   typedef string result_type;
+   template<typename Op>
+   string operator()( const Op& )const
+   {
+      string name = fc::get_typename<Op>::name();
+      auto pos = name.rfind( ':' );
+      return pos == string::npos ? name : name.substr( pos + 1 );
+   }
+};
+
+string operation_name( int which )
+{
+   operation op;
+   op.set_which( which );
+   return op.visit( operation_name_visitor() );
+}
+
+} // anonymous namespace
+
+void timing_histogram::add( uint64_t value )
+{
+   if( buckets.empty() )
+      buckets.resize( bucket_count );
+   uint32_t bucket = 0;
+   for( uint64_t v = value; v != 0 && bucket + 1 < bucket_count; v >>= 1 )
+      ++bucket;
+   ++buckets[bucket];
+   ++count;
+   total += value;
+   max = std::max( max, value );
+}
+
+block_timing_collector::block_timing_collector()
+   : _evaluate( operation::count() ), _apply( operation::count() )
+{
+   _block_phases.fill( 0 );
+}
+
+void block_timing_collector::block_started()
+{
+   _block_phases.fill( 0 );
+   _block_start = fc::time_point::now();
+   _phase_start = _block_start;
+}
+
+void block_timing_collector::phase_finished( block_phase phase )
+{
+   const auto now = fc::time_point::now();
+   const int64_t elapsed = ( now - _phase_start ).count();
+   _phases[size_t(phase)].add( elapsed );
+   _block_phases[size_t(phase)] += elapsed;
+   _phase_start = now;
+}
+
+void block_timing_collector::block_finished( uint32_t block_num, size_t undo_old_values, size_t undo_new_ids, size_t undo_removed )
+{
+   const auto elapsed = fc::time_point::now() - _block_start;
+   ++_blocks;
+   _block_time.add( elapsed.count() );
+   _undo_old_values.add( undo_old_values );
+   _undo_new_ids.add( undo_new_ids );
+   _undo_removed.add( undo_removed );
+
+   if( _log_threshold.count() > 0 && elapsed >= _log_threshold )
+   {
+      std::ostringstream phases;
+      for( size_t i = 0; i < _block_phases.size(); ++i )
+         if( _block_phases[i] > 0 )
+            phases << ' ' << phase_names[i] << '=' << _block_phases[i];
+      wlog( "Block ${n} took ${t} us to apply, phases in us:${p}, undo state: ${o} modified, ${c} created, ${r} removed",
+            ("n", block_num)("t", elapsed.count())("p", phases.str())
+            ("o", undo_old_values)("c", undo_new_ids)("r", undo_removed) );
+   }
+}
+
+void block_timing_collector::record_operation( int which, bool apply, fc::microseconds duration )
+{
+   auto& histograms = apply ? _apply : _evaluate;
+   if( which >= 0 && size_t(which) < histograms.size() )
+      histograms[which].add( duration.count() );
+}
+
+void block_timing_collector::record_observer( const char* name, fc::microseconds duration )
+{
+   _observers[name].add( duration.count() );
+}
+
+block_timing_statistics block_timing_collector::get_statistics()const
+{
+   block_timing_statistics result;
+   result.blocks = _blocks;
+   result.block_time = _block_time;
+   for( size_t i = 0; i < _phases.size(); ++i )
+      if( _phases[i].count > 0 )
+         result.phases[phase_names[i]] = _phases[i];
+   for( const auto& observer : _observers )
+   {
+      // the same name may be passed from several translation units at different addresses
+      auto& histogram = result.observers[observer.first];
+      if( histogram.buckets.empty() )
+         histogram.buckets.resize( timing_histogram::bucket_count );
+      for( size_t i = 0; i < observer.second.buckets.size(); ++i )
+         histogram.buckets[i] += observer.second.buckets[i];
+      histogram.count += observer.second.count;
+      histogram.total += observer.second.total;
+      histogram.max = std::max( histogram.max, observer.second.max );
+   }
+   for( size_t i = 0; i < _evaluate.size(); ++i )
+   {
+      if( _evaluate[i].count > 0 )
+         result.evaluate[operation_name( i )] = _evaluate[i];
+      if( _apply[i].count > 0 )
+         result.apply[operation_name( i )] = _apply[i];
+   }
+   result.undo_old_values = _undo_old_values;
+   result.undo_new_ids = _undo_new_ids;
+   result.undo_removed = _undo_removed;
+   return result;
+}
+
+void block_timing_collector::reset()
+{
+   const auto threshold = _log_threshold;
+   *this = block_timing_collector();
+   _log_threshold = threshold;
+}
+
+} } // graphene::chain
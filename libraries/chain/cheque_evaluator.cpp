@@ -102,7 +102,7 @@ namespace graphene { namespace chain {
          o.status = cheque_status::cheque_new;
          o.amount_payee = op.payee_amount.amount;
          o.amount_remaining = cheque_amount;
-         o.allocate_payees(op.payee_count);
+         o.payees_count = op.payee_count;
       });
 
       // edc daily limit counter
@@ -142,11 +142,9 @@ void_result cheque_use_evaluator::do_evaluate( const cheque_use_operation& op )
    FC_ASSERT((op.amount.amount == cheque_obj_ptr->amount_payee), "Cheque amount is invalid!");
    FC_ASSERT((op.amount.asset_id == cheque_obj_ptr->asset_id), "Cheque asset id is invalid!");
 
-   for (const cheque_object::payee_item& item: cheque_obj_ptr->payees)
-   {
-      FC_ASSERT((item.payee != op.account_id)
-                , "Cheque code '${code}' has been already used for account '${account}'", ("rcode", op.code)("account", op.account_id));
-   }
+   const auto& payee_idx = d.get_index_type<cheque_payee_index>().indices().get<by_cheque_payee>();
+   FC_ASSERT(payee_idx.find(boost::make_tuple(cheque_obj_ptr->get_id(), op.account_id)) == payee_idx.end()
+             , "Cheque code '${code}' has been already used for account '${account}'", ("rcode", op.code)("account", op.account_id));
 
    return void_result();
 
@@ -161,8 +159,16 @@ object_id_type cheque_use_evaluator::do_apply( const cheque_use_operation& op )
 
    const cheque_object& cheque = *cheque_obj_ptr;
 
+   d.adjust_balance(op.account_id, asset(cheque.amount_payee, cheque.asset_id));
+
+   d.create<cheque_payee_object>([&](cheque_payee_object& o) {
+      o.cheque = cheque.get_id();
+      o.payee = op.account_id;
+      o.datetime_used = d.head_block_time();
+   });
+
    d.modify(cheque, [&](chain::cheque_object& o) {
-      o.process_payee(op.account_id, d);
+      o.process_payee(d.head_block_time());
    });
 
    return cheque.get_id();
@@ -197,20 +203,6 @@ void_result cheque_reverse_evaluator::do_apply( const cheque_reverse_operation&
 
    const cheque_object& obj = *cheque_obj_ptr;
 
-   // collect unused amounts from payees array
-   std::vector<cheque_object::payee_item> payees = cheque_obj_ptr->payees;
-
-   for (cheque_object::payee_item& item: payees)
-   {
-      if (item.status == cheque_status::cheque_new)
-      {
-         // set all payees to drawer id
-         item.payee = obj.drawer;
-         item.datetime_used = d.head_block_time();
-         item.status = cheque_status::cheque_used;
-      }
-   }
-
    // return amount to the owner balance
    if (obj.amount_remaining > 0) {
       d.adjust_balance(obj.drawer, asset(obj.amount_remaining, obj.asset_id));
@@ -220,7 +212,6 @@ void_result cheque_reverse_evaluator::do_apply( const cheque_reverse_operation&
    {
       o.datetime_used  = d.head_block_time();
       o.status = cheque_status::cheque_undo;
-      o.payees = payees;
       o.amount_remaining = 0;
    });
 
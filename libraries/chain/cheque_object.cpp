@@ -8,42 +8,18 @@
 
 namespace graphene { namespace chain {
 
-   void cheque_object::allocate_payees(uint32_t payees_count) {
-      payees.resize(payees_count);
-   }
-
-   void cheque_object::process_payee(account_id_type payee, database& db)
+   void cheque_object::process_payee(fc::time_point_sec now)
    {
       // if cheque is already used then exit...
       if (status == cheque_status::cheque_used) { return; }
 
-      int used_count = 0;
-      bool check_used = false;
-      for (uint32_t i = 0; i < payees.size(); i++)
-      {
-         // if have unused payee item
-         if (!check_used && (payees[i].status == cheque_status::cheque_new))
-         {
-            // adjust balance for payee user
-            db.adjust_balance(payee, asset(amount_payee, asset_id));
-
-            // fill used payee item
-            payees[i].status = cheque_status::cheque_used;
-            payees[i].payee = payee;
-            payees[i].datetime_used = db.head_block_time();
+      amount_remaining -= amount_payee;
+      ++payees_used;
 
-            amount_remaining -= amount_payee;
-            check_used = true;
-            ++used_count;
-         }
-         else if (payees[i].status == cheque_status::cheque_used) {
-            ++used_count;
-         }
-      }
-      if (used_count == (int)payees.size())
+      if (payees_used == payees_count)
       {
          status = cheque_status::cheque_used;
-         datetime_used = db.head_block_time();
+         datetime_used = now;
       }
    }
 
@@ -59,7 +35,13 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::cheque_object, (graphene::db::o
                     (amount_remaining)
                     (asset_id)
                     (status)
-                    (payees) )
+                    (payees_count)
+                    (payees_used) )
+
+FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::cheque_payee_object, (graphene::db::object),
+                    (cheque)
+                    (payee)
+                    (datetime_used) )
 
-GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::cheque_object::payee_item)
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::cheque_object )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::cheque_payee_object )
@@ -53,16 +53,22 @@ asset database::get_balance_for_bonus( account_id_type owner, asset_id_type asse
    {
       auto& mat_index = get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
       auto itr = mat_index.find( boost::make_tuple( owner, asset_id ) );
-      if ( (itr == mat_index.end()) || ( ( asset_obj.params.mandatory_transfer > 0 ) && !itr->mandatory_transfer ) ) {
+      const uint32_t epoch = get_dynamic_global_properties().maturity_epoch;
+      if ( (itr == mat_index.end()) || ( ( asset_obj.params.mandatory_transfer > 0 ) && !itr->is_mandatory_transfer( epoch ) ) ) {
          return asset(0, asset_id);
       }
+      // not refreshed since the last reset, so it matures the whole real balance
+      if ( itr->maturity_epoch != epoch ) {
+         return get_balance( owner, asset_id );
+      }
       return itr->get_balance();
    }
    else
    {
       auto& bal_index = get_index_type<account_balance_index>().indices().get<by_account_asset>();
       auto itr = bal_index.find( boost::make_tuple( owner, asset_id ) );
-      if ( itr == bal_index.end() || ( ( asset_obj.params.mandatory_transfer > 0 ) && !itr->mandatory_transfer ) ) {
+      if ( itr == bal_index.end() || ( ( asset_obj.params.mandatory_transfer > 0 )
+                                       && !itr->is_mandatory_transfer( get_dynamic_global_properties().maturity_epoch ) ) ) {
          return asset(0, asset_id);
       }
       auto balance = itr->get_balance();
@@ -86,7 +92,7 @@ asset database::get_mature_balance(account_id_type owner, asset_id_type asset_id
    // auto& asset_obj = asset_id(*this);
    auto& index = get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
    auto itr = index.find(boost::make_tuple(owner, asset_id));
-   if( itr == index.end() || !itr->mandatory_transfer ) //  && !owner_account.is_market))
+   if( itr == index.end() || !itr->is_mandatory_transfer( get_dynamic_global_properties().maturity_epoch ) ) //  && !owner_account.is_market))
       return asset(0, asset_id);
    return itr->get_balance();
 }
@@ -121,10 +127,12 @@ void database::adjust_balance(account_id_type account, asset delta )
                  ("a",account(*this).name)
                  ("b",to_pretty_string(asset(0,delta.asset_id)))
                  ("r",to_pretty_string(-delta)));
-      create<account_balance_object>([account,&delta](account_balance_object& b) {
+      const uint32_t epoch = get_dynamic_global_properties().maturity_epoch;
+      create<account_balance_object>([account,&delta,epoch](account_balance_object& b) {
          b.owner = account;
          b.asset_type = delta.asset_id;
          b.balance = delta.amount.value;
+         b.maturity_epoch = epoch;
       });
 
       // disable maturity for EDC
@@ -132,11 +140,12 @@ void database::adjust_balance(account_id_type account, asset delta )
             || ((delta.asset_id == EDC_ASSET) && (head_block_time() < HARDFORK_622_TIME))) )
       {
          create<account_mature_balance_object>(
-         [this, account, delta, &interval_part](account_mature_balance_object& b) {
+         [this, account, delta, &interval_part, epoch](account_mature_balance_object& b) {
             b.owner = account;
             b.asset_type = delta.asset_id;
             b.balance = delta.amount.value * interval_part;
             b.history.push_back(mature_balances_history(delta.amount, b.balance));
+            b.maturity_epoch = epoch;
          });
       }
    }
@@ -151,6 +160,7 @@ void database::adjust_balance(account_id_type account, asset delta )
                    ("r", to_pretty_string(-delta)));
 
       }
+      refresh_maturity(*itr);
       auto asset_params = delta.asset_id(*this).params;
       modify(*itr, [delta, asset_params](account_balance_object& b)
       {
@@ -322,6 +332,7 @@ void database::consider_mining_in_mature_balances()
          auto& mat_index = get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
          auto mat_itr = mat_index.find( boost::make_tuple( account.get_id(), asset.get_id() ) );
          if ( mat_itr == mat_index.end() ) { return; }
+         refresh_maturity( account.get_id(), asset.get_id() );
          modify( *mat_itr, [mined_minutes]( account_mature_balance_object& b ) {
             b.consider_mining( mined_minutes );
          });
@@ -345,6 +356,7 @@ void database::consider_mining_old()
       auto& mat_index = get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
       auto mat_itr = mat_index.find(boost::make_tuple(account.get_id(), asset->get_id()));
       if (mat_itr == mat_index.end()) return;
+      refresh_maturity(account.get_id(), asset->get_id());
       modify(*mat_itr, [mined_minutes](account_mature_balance_object& b) {
          b.consider_mining(mined_minutes);
       });
@@ -452,7 +464,8 @@ void database::issue_referral()
    int minutes_in_1_day = 1440;
    auto online_info = get( accounts_online_id_type() ).online_info;
    double default_online_part = online_info.size() ? 0 : 1;
-   referral_tree rtree( idx, bal_idx, edc_asset->id, account_id_type(), &mat_bal_idx );
+   referral_tree rtree( idx, bal_idx, edc_asset->id, account_id_type(), &mat_bal_idx,
+                        get_dynamic_global_properties().maturity_epoch );
    rtree.form();
    auto ops = rtree.scan();
 
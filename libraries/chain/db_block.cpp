@@ -81,12 +81,33 @@ optional<signed_block> database::fetch_block_by_number( uint32_t num )const
    // return optional<signed_block>();
 }
 
-const signed_transaction& database::get_recent_transaction(const transaction_id_type& trx_id) const
+signed_transaction database::get_recent_transaction(const transaction_id_type& trx_id) const
 {
    auto& index = get_index_type<transaction_index>().indices().get<by_trx_id>();
    auto itr = index.find(trx_id);
    FC_ASSERT(itr != index.end());
-   return itr->trx;
+
+   // the recorded position is tried first, the transactions are scanned if it is off, e.g. after a fork switch
+   auto find_in = [&trx_id]( const auto& trxs, uint32_t position ) -> const signed_transaction* {
+      if( position < trxs.size() && trxs[position].id() == trx_id )
+         return &trxs[position];
+      for( const auto& trx : trxs )
+         if( trx.id() == trx_id )
+            return &trx;
+      return nullptr;
+   };
+
+   if( itr->block_num > head_block_num() )
+   {
+      if( auto trx = find_in( _pending_tx, itr->trx_in_block ) )
+         return *trx;
+   }
+   else if( auto block = fetch_block_by_number( itr->block_num ) )
+   {
+      if( auto trx = find_in( block->transactions, itr->trx_in_block ) )
+         return *trx;
+   }
+   FC_THROW_EXCEPTION( fc::key_not_found_exception, "Transaction ${id} is not available", ("id", trx_id) );
 }
 
 std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of_fork) const
@@ -122,6 +143,12 @@ bool database::push_block(const signed_block& new_block, uint32_t skip)
          detail::without_pending_transactions( *this, std::move(_pending_tx),
             [&]() {
                result = _push_block(new_block);
+               // the block is committed and no undo session is open until the pending transactions are restored
+               if( _undo_db.active_sessions() == 0 )
+               {
+                  prune_old_entities( _pruning_chunk_size );
+                  committed_block( new_block );
+               }
             });
       });
    return result;
@@ -455,6 +482,7 @@ void database::pop_block()
    _fork_db.pop_block();
    _block_id_to_block.remove( head_id );
    pop_undo();
+   mark_all_feeds_for_update();
 
    _popped_tx.insert( _popped_tx.begin(), head_block->transactions.begin(), head_block->transactions.end() );
 
@@ -514,7 +542,13 @@ void database::apply_block( const signed_block& next_block, uint32_t skip )
    }
 
    detail::with_skip_flags(*this, skip, [&](){
-         _apply_block( next_block );
+         try {
+            _apply_block( next_block );
+         } catch( ... ) {
+            // the changes of the block are undone, but the feed update marks it consumed are gone
+            mark_all_feeds_for_update();
+            throw;
+         }
       });
    return;
 }
@@ -524,6 +558,9 @@ void database::_apply_block( const signed_block& next_block )
    uint32_t next_block_num = next_block.block_num();
    uint32_t skip = get_node_properties().skip_flags;
    _applied_ops.clear();
+#ifndef GRAPHENE_DISABLE_BLOCK_TIMING
+   _block_timing.block_started();
+#endif
 
    if (!(skip & skip_block_size_check)) {
       FC_ASSERT( fc::raw::pack_size(next_block) <= get_global_properties().parameters.maximum_block_size );
@@ -559,25 +596,39 @@ void database::_apply_block( const signed_block& next_block )
        * for transactions when validating broadcast transactions or
        * when building a block.
        */
-      apply_transaction( trx, skip | skip_transaction_signatures );
+      // the processed transaction is not needed, so it is neither copied nor filled
+      detail::with_skip_flags( *this, skip | skip_transaction_signatures, [&]() {
+         _apply_transaction( trx, true, false );
+      });
       ++_current_trx_in_block;
    }
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, transactions );
 
    update_global_dynamic_data(next_block);
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, update_global_dynamic_data );
    update_signing_witness(signing_witness, next_block);
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, update_signing_witness );
    update_last_irreversible_block();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, update_last_irreversible_block );
 
    // Are we at the maintenance interval?
    if( maint_needed ) {
       perform_chain_maintenance(next_block, global_props);
+      GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, chain_maintenance );
    }
 
    create_block_summary(next_block);
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, create_block_summary );
    clear_expired_transactions();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, clear_expired_transactions );
    clear_expired_proposals();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, clear_expired_proposals );
    clear_expired_orders();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, clear_expired_orders );
    update_expired_feeds();       // this will update expired feeds and some core exchange rates
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, update_expired_feeds );
    update_withdraw_permissions();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, update_withdraw_permissions );
 
    // n.b., update_maintenance_flag() happens this late
    // because get_slot_time() / get_slot_at_time() is needed above
@@ -586,6 +637,7 @@ void database::_apply_block( const signed_block& next_block )
    // to be called for header validation?
    update_maintenance_flag( maint_needed );
    update_witness_schedule();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, update_witness_schedule );
 
    if (!_node_property_object.debug_updates.empty()) {
       apply_debug_updates();
@@ -594,25 +646,32 @@ void database::_apply_block( const signed_block& next_block )
    // notify observers that the block has been applied
    applied_block( next_block ); //emit
    _applied_ops.clear();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, applied_block );
 
    notify_changed_objects();
+   GRAPHENE_BLOCK_PHASE_TIMER( _block_timing, notify_changed_objects );
+
+#ifndef GRAPHENE_DISABLE_BLOCK_TIMING
+   if( _undo_db.enabled() )
+   {
+      const auto& head_undo = _undo_db.head();
+      _block_timing.block_finished( next_block_num, head_undo.old_values.size(), head_undo.new_ids.size(), head_undo.removed.size() );
+   }
+   else
+      _block_timing.block_finished( next_block_num, 0, 0, 0 );
+#endif
 } FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
 
 void database::notify_changed_objects()
 { try {
-   if( _undo_db.enabled() ) 
+   if( _undo_db.enabled() && !_replaying )
    {
       const auto& head_undo = _undo_db.head();
-      vector<object_id_type> changed_ids;  changed_ids.reserve(head_undo.old_values.size());
+      vector<object_id_type> changed_ids;
+      changed_ids.reserve( head_undo.old_values.size() + head_undo.new_ids.size() + head_undo.removed.size() );
       for( const auto& item : head_undo.old_values ) changed_ids.push_back(item.first);
       for( const auto& item : head_undo.new_ids ) changed_ids.push_back(item);
-      vector<const object*> removed;
-      removed.reserve( head_undo.removed.size() );
-      for( const auto& item : head_undo.removed )
-      {
-         changed_ids.push_back( item.first );
-         removed.emplace_back( item.second.get() );
-      }
+      for( const auto& item : head_undo.removed ) changed_ids.push_back( item.first );
       changed_objects(changed_ids);
    }
 } FC_CAPTURE_AND_RETHROW() }
@@ -627,11 +686,13 @@ processed_transaction database::apply_transaction(const signed_transaction& trx,
    return result;
 }
 
-processed_transaction database::_apply_transaction(const signed_transaction& trx, bool need_apply_address_creation)
+processed_transaction database::_apply_transaction(const signed_transaction& trx, bool need_apply_address_creation,
+                                                   bool need_result)
 { try {
    uint32_t skip = get_node_properties().skip_flags;
 
-   if( true || !(skip&skip_validate) )   /* issue #505 explains why this skip_flag is disabled */
+   /* issue #505 explains why this skip_flag is disabled, it is only honored for blocks replayed from our own block log */
+   if( !_replaying || !(skip&skip_validate) )
       trx.validate();
 
    auto& trx_idx = get_mutable_index_type<transaction_index>();
@@ -639,10 +700,10 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    auto trx_id = trx.id();
    if( !(skip & skip_transaction_dupe_check) )
    {
-      GRAPHENE_ASSERT( trx_idx.indices().get<by_trx_id>().find(trx.id()) == trx_idx.indices().get<by_trx_id>().end(),
+      GRAPHENE_ASSERT( trx_idx.indices().get<by_trx_id>().find(trx_id) == trx_idx.indices().get<by_trx_id>().end(),
                        duplicate_transaction,
                        "Transaction '${txid}' is already in the database",
-                       ("txid",trx.id()) );
+                       ("txid",trx_id) );
    }
    transaction_evaluation_state eval_state(this);
    const chain_parameters& chain_parameters = get_global_properties().parameters;
@@ -677,33 +738,49 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    //Insert transaction into unique transactions database.
    if( !(skip & skip_transaction_dupe_check) )
    {
+      const bool in_block = _current_block_num > head_block_num();
       create<transaction_history_object>([&](transaction_history_object& transaction) {
          transaction.trx_id = trx_id;
-         transaction.trx = trx;
+         transaction.expiration = trx.expiration;
+         transaction.block_num = head_block_num() + 1;
+         // a pushed transaction is appended to the pending transactions after it is applied
+         transaction.trx_in_block = in_block ? _current_trx_in_block : _pending_tx.size();
       });
    }
 
-   eval_state.operation_results.reserve(trx.operations.size());
+   // replayed blocks were checked when they were first applied and nobody uses their processed transactions
+   need_result = need_result && !_replaying;
+   if( need_result )
+      eval_state.operation_results.reserve(trx.operations.size());
 
    //Finally process the operations
-   processed_transaction ptrx(trx);
    _current_op_in_trx = 0;
-   for( const auto& op : ptrx.operations )
+   for( const auto& op : trx.operations )
    {
       if( op.which() == operation::tag<add_address_operation>::value
           && !need_apply_address_creation) {
         continue;
       }
-      eval_state.operation_results.emplace_back(apply_operation(eval_state, op));
+      if( need_result )
+         eval_state.operation_results.emplace_back(apply_operation(eval_state, op));
+      else
+         apply_operation(eval_state, op);
       ++_current_op_in_trx;
    }
-   ptrx.operation_results = std::move(eval_state.operation_results);
+
+   if( _replaying )
+      return processed_transaction();
 
    //Make sure the temp account has no non-zero balances
    const auto& index = get_index_type<account_balance_index>().indices().get<by_account_asset>();
    auto range = index.equal_range( boost::make_tuple( GRAPHENE_TEMP_ACCOUNT ) );
    std::for_each(range.first, range.second, [](const account_balance_object& b) { FC_ASSERT(b.balance == 0); });
 
+   if( !need_result )
+      return processed_transaction();
+
+   processed_transaction ptrx(trx);
+   ptrx.operation_results = std::move(eval_state.operation_results);
    return ptrx;
 } FC_CAPTURE_AND_RETHROW( (trx) ) }
 
@@ -713,9 +790,9 @@ operation_result database::apply_operation(transaction_evaluation_state& eval_st
    uint64_t u_which = uint64_t( i_which );
    FC_ASSERT( i_which >= 0, "Negative operation tag in operation ${op}", ("op",op) );
    FC_ASSERT( u_which < _operation_evaluators.size(), "No registered evaluator for operation ${op}", ("op",op) );
-   unique_ptr<op_evaluator>& eval = _operation_evaluators[ u_which ];
+   op_evaluator eval = _operation_evaluators[ u_which ];
    FC_ASSERT( eval, "No registered evaluator for operation ${op}", ("op",op) );
-   auto result = eval->evaluate( eval_state, op, true );
+   auto result = eval( eval_state, op, true );
    auto op_id = push_applied_operation( op );
    set_applied_operation_result( op_id, result );
    return result;
@@ -134,7 +134,7 @@ const uint8_t worker_object::type_id;
 
 void database::initialize_evaluators()
 {
-   _operation_evaluators.resize(255);
+   _operation_evaluators.assign( operation::count(), nullptr );
    register_evaluator<account_create_evaluator>();
    register_evaluator<account_update_evaluator>();
    register_evaluator<account_update_authorities_evaluator>();
@@ -224,7 +224,7 @@ void database::initialize_indexes()
    _undo_db.set_max_size( GRAPHENE_MIN_UNDO_HISTORY );
 
    // protocol object indexes
-   add_index<primary_index<asset_index>>();
+   add_index<primary_index<asset_index>>()->add_secondary_index<feed_update_index>( &_feed_updates );
    add_index<primary_index<force_settlement_index>>();
    add_index<primary_index<fund_index>>();
    add_index<primary_index<fund_deposit_index>>();
@@ -254,7 +254,7 @@ void database::initialize_indexes()
    add_index<primary_index<account_balance_index                        >>();
    add_index<primary_index<account_mature_balance_index                 >>();
    add_index<primary_index<bonus_balances_index                         >>();
-   add_index<primary_index<asset_bitasset_data_index                    >>();
+   add_index<primary_index<asset_bitasset_data_index                    >>()->add_secondary_index<feed_update_index>( &_feed_updates );
    add_index<primary_index<simple_index<global_property_object         >>>();
    add_index<primary_index<simple_index<dynamic_global_property_object >>>();
    add_index<primary_index<simple_index<account_statistics_object      >>>();
@@ -266,6 +266,7 @@ void database::initialize_indexes()
    add_index<primary_index<special_authority_index                     >>();
    add_index<primary_index<buyback_index                               >>();
    add_index<primary_index<blind_transfer2_index                       >>();
+   add_index<primary_index<cheque_payee_index                          >>();
    add_index<primary_index<market_address_index                        >>();
 
    add_index<primary_index<simple_index<fba_accumulator_object    >>>();
@@ -579,6 +580,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
          }
 
          bitasset_data_id = create<asset_bitasset_data_object>([&](asset_bitasset_data_object& b) {
+            b.asset_id = new_asset_id;
             b.options.short_backing_asset = core_asset.id;
             b.options.minimum_feeds = GRAPHENE_DEFAULT_MINIMUM_FEEDS;
          }).id;
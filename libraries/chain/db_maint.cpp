@@ -883,8 +883,8 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
    });
 
    // Reset all BitAsset force settlement volumes to zero
-   for( const asset_bitasset_data_object* d : get_index_type<asset_bitasset_data_index>() )
-      modify(*d, [](asset_bitasset_data_object& d) { d.force_settled_volume = 0; });
+   for( const asset_bitasset_data_object& d : get_index_type<asset_bitasset_data_index>().indices() )
+      modify(d, [](asset_bitasset_data_object& d) { d.force_settled_volume = 0; });
 
    // process_budget needs to run at the bottom because
    //   it needs to know the next_maintenance_time
@@ -925,31 +925,6 @@ void database::clear_old_entities()
    {
       fc::time_point tp = head_block_time() - fc::days(history_size);
 
-      // all history objects
-      {
-         auto history_index = get_index_type<operation_history_index>().indices().get<by_time>().lower_bound(tp);
-         auto begin_iter = get_index_type<operation_history_index>().indices().get<by_time>().begin();
-         while (begin_iter != history_index) {
-            remove(*begin_iter++);
-         }
-      }
-      // issue_bonuses_old() depends on account_transaction_history_object
-      if (head_block_time() > HARDFORK_617_TIME)
-      {
-         auto history_index = get_index_type<account_transaction_history_index>().indices().get<by_time>().lower_bound(tp);
-         auto begin_iter = get_index_type<account_transaction_history_index>().indices().get<by_time>().begin();
-         while (begin_iter != history_index) {
-            remove(*begin_iter++);
-         }
-      }
-      // reference-objects for fund operations
-      {
-         auto history_index = get_index_type<fund_transaction_history_index>().indices().get<by_time>().lower_bound(tp);
-         auto begin_iter = get_index_type<fund_transaction_history_index>().indices().get<by_time>().begin();
-         while (begin_iter != history_index) {
-            remove(*begin_iter++);
-         }
-      }
       // blind transfer objects
       {
          auto history_index = get_index_type<blind_transfer2_index>().indices().get<by_datetime>().lower_bound(tp);
@@ -966,6 +941,12 @@ void database::clear_old_entities()
             remove(*begin_iter++);
          }
       }
+
+      // old history is pruned in chunks after every block, see prune_old_entities()
+      ilog("Pruned ${n} old history objects in ${c} chunks, ${t} us total, ${m} us max per chunk",
+           ("n", _pruning_stats.pruned())("c", _pruning_stats.chunks)
+           ("t", _pruning_stats.total_time.count())("m", _pruning_stats.max_chunk_time.count()));
+      _pruning_stats = pruning_statistics();
    }
 
    // cancel online_info for all users
@@ -1017,51 +998,61 @@ void database::process_cheques()
 {
    const dynamic_global_property_object& dpo = get_dynamic_global_properties();
    const global_property_object& gpo = get_global_properties();
-   const auto& idx_cheques = get_index_type<cheque_index>().indices().get<by_id>();
+   const auto& idx_cheques = get_index_type<cheque_index>().indices().get<by_status_exp>();
    transaction_evaluation_state eval(this);
 
-   std::vector<cheque_id_type> to_remove;
+   /**
+    * change cheque status from 'cheque_status::new' to 'cheque_status::cheque_undo'
+    * and return amount to the maker if overdue. Only the new cheques which have expired are visited,
+    * they are reversed in id order like before, so that the virtual operations keep their order */
+   const time_point_sec expired = dpo.next_maintenance_time - gpo.parameters.maintenance_interval;
+   std::vector<cheque_id_type> to_reverse;
+   for (auto itr = idx_cheques.lower_bound(cheque_status::cheque_new);
+        itr != idx_cheques.end() && itr->status == cheque_status::cheque_new && itr->datetime_expiration <= expired;
+        ++itr)
+   {
+      to_reverse.push_back(itr->get_id());
+   }
+   std::sort(to_reverse.begin(), to_reverse.end());
 
-   // we need to remove expired cheques and return amounts to the owners balances
-   for (const cheque_object& cheque_obj: idx_cheques)
+   for (const cheque_id_type& obj_id: to_reverse)
    {
-      /**
-       * change cheque status from 'cheque_status::new' to 'cheque_status::cheque_undo'
-       * and return amount to the maker if overdue */
-      if ( (cheque_obj.status == cheque_status::cheque_new)
-           && ((dpo.next_maintenance_time - gpo.parameters.maintenance_interval) >= cheque_obj.datetime_expiration) )
-      {
-         cheque_reverse_operation op;
-         op.cheque_id  = cheque_obj.get_id();
-         op.account_id = cheque_obj.drawer;
-         op.amount     = cheque_obj.get_remaining_amount();
+      const cheque_object& cheque_obj = obj_id(*this);
 
-         try
-         {
-            op.validate();
-            apply_operation(eval, op);
-         } catch (fc::assert_exception& e) {  }
-      }
+      cheque_reverse_operation op;
+      op.cheque_id  = cheque_obj.get_id();
+      op.account_id = cheque_obj.drawer;
+      op.amount     = cheque_obj.get_remaining_amount();
 
-      if (get_history_size() > 0)
+      try
       {
-         const time_point& tp = head_block_time() - fc::days(get_history_size());
-         if ((cheque_obj.status != cheque_status::cheque_new) && (cheque_obj.datetime_expiration < tp)) {
-            to_remove.push_back(cheque_obj.get_id());
-         }
+         op.validate();
+         apply_operation(eval, op);
+      } catch (fc::assert_exception& e) {  }
+   }
+
+   if (get_history_size() == 0) { return; }
+
+   // remove used and canceled cheques together with their payees
+   const time_point_sec tp = head_block_time() - fc::days(get_history_size());
+   std::vector<cheque_id_type> to_remove;
+   for (cheque_status status: { cheque_status::cheque_used, cheque_status::cheque_undo })
+   {
+      auto itr = idx_cheques.lower_bound(status);
+      const auto end = idx_cheques.lower_bound(boost::make_tuple(status, tp));
+      for (; itr != end; ++itr) {
+         to_remove.push_back(itr->get_id());
       }
    }
 
-   // remove canceled cheques
-   if (to_remove.size() > 0)
+   const auto& idx_payees = get_index_type<cheque_payee_index>().indices().get<by_cheque_payee>();
+   for (const cheque_id_type& obj_id: to_remove)
    {
-      for (const cheque_id_type& obj_id: to_remove)
-      {
-         auto itr = get_index_type<cheque_index>().indices().get<by_id>().find(obj_id);
-         if (itr != get_index_type<cheque_index>().indices().get<by_id>().end()) {
-            remove(*itr);
-         }
+      auto payee_itr = idx_payees.lower_bound(obj_id);
+      while (payee_itr != idx_payees.end() && payee_itr->cheque == obj_id) {
+         remove(*payee_itr++);
       }
+      remove(obj_id(*this));
    }
 }
 
@@ -1135,7 +1126,8 @@ void database::issue_bonuses_before_620()
    const auto& bal_idx = get_index_type<account_balance_index>();
    auto& mat_bal_idx = get_index_type<account_mature_balance_index>();
    transaction_evaluation_state eval(this);
-   referral_tree rtree( idx, bal_idx, asset->id, account_id_type(), &mat_bal_idx );
+   referral_tree rtree( idx, bal_idx, asset->id, account_id_type(), &mat_bal_idx,
+                        get_dynamic_global_properties().maturity_epoch );
    auto& issuer_list = asset->issuer(*this).blacklisted_accounts;
    auto& alpha_list = ALPHA_ACCOUNT_ID(*this).blacklisted_accounts;
 
@@ -1302,24 +1294,38 @@ void database::issue_bonuses_old() {
    });
 }
 void database::clear_account_mature_balance_index() {
+   // balances are reset lazily, see refresh_maturity()
+   modify(get_dynamic_global_properties(), [](dynamic_global_property_object& dgp) {
+      ++dgp.maturity_epoch;
+   });
+}
+
+void database::refresh_maturity(const account_balance_object& bal_object)
+{
+   const uint32_t epoch = get_dynamic_global_properties().maturity_epoch;
+   if (bal_object.maturity_epoch != epoch)
+   {
+      modify(bal_object, [epoch](account_balance_object& obj) {
+         obj.mandatory_transfer = false;
+         obj.maturity_epoch = epoch;
+      });
+   }
    auto& idx = get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
-   auto& balance_idx = get_index_type<account_balance_index>().indices().get<by_account_asset>();
-   for (auto& bal_object: balance_idx)
+   auto itr = idx.find(boost::make_tuple(bal_object.owner, bal_object.asset_type));
+   if (itr != idx.end() && itr->maturity_epoch != epoch)
    {
-      modify(bal_object, [&](account_balance_object& mat_obj) {
-         mat_obj.mandatory_transfer = false;
+      // the real balance has not changed since the reset, otherwise the object would be fresh already
+      modify(*itr, [&](account_mature_balance_object& mat_obj) {
+         mat_obj.reset(bal_object.balance, epoch);
       });
-      auto itr = idx.find(boost::make_tuple(bal_object.owner, bal_object.asset_type));
-      if (itr != idx.end())
-      {
-         modify(*itr, [&](account_mature_balance_object& mat_obj) {
-            mat_obj.asset_type = bal_object.asset_type;
-            mat_obj.balance = bal_object.balance;
-            mat_obj.history.clear();
-            mat_obj.mandatory_transfer = false;
-            mat_obj.history.push_back(mature_balances_history(bal_object.balance, bal_object.balance));
-         });
-      }
    }
 }
+
+void database::refresh_maturity(account_id_type owner, asset_id_type asset_id)
+{
+   auto& balance_idx = get_index_type<account_balance_index>().indices().get<by_account_asset>();
+   auto itr = balance_idx.find(boost::make_tuple(owner, asset_id));
+   if (itr != balance_idx.end())
+      refresh_maturity(*itr);
+}
 } }
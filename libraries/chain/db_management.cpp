@@ -35,6 +35,28 @@
 
 namespace graphene { namespace chain {
 
+namespace detail {
+/// leaves replay mode and enables undo again when reindex exits, also on failure
+struct replay_mode_restorer
+{
+   replay_mode_restorer( bool& replaying, undo_database& undo_db )
+      : _replaying( replaying ), _undo_db( undo_db )
+   {
+      _undo_db.disable();
+      _replaying = true;
+   }
+
+   ~replay_mode_restorer()
+   {
+      _replaying = false;
+      _undo_db.enable();
+   }
+
+   bool&          _replaying;
+   undo_database& _undo_db;
+};
+} // detail
+
 database::database()
 {
    initialize_indexes();
@@ -65,7 +87,7 @@ void database::reindex(fc::path data_dir, const genesis_state_type& initial_allo
    const auto last_block_num = last_block->block_num();
 
    ilog( "Replaying blocks..." );
-   _undo_db.disable();
+   detail::replay_mode_restorer replay_mode( _replaying, _undo_db );
    for( uint32_t i = 1; i <= last_block_num; ++i )
    {
       if( i % 2000 == 0 ) std::cerr << "   " << double(i*100)/last_block_num << "%   "<<i << " of " <<last_block_num<<"   \n";
@@ -94,11 +116,16 @@ void database::reindex(fc::path data_dir, const genesis_state_type& initial_allo
                           skip_transaction_dupe_check |
                           skip_tapos_check |
                           skip_witness_schedule_check |
-                          skip_authority_check);
+                          skip_authority_check |
+                          skip_block_size_check |
+                          skip_validate);
+      prune_old_entities( _pruning_chunk_size );
+      committed_block( *block );
    }
-   _undo_db.enable();
    auto end = fc::time_point::now();
-   ilog( "Done reindexing, elapsed time: ${t} sec", ("t",double((end-start).count())/1000000.0 ) );
+   ilog( "Done reindexing, elapsed time: ${t} sec, ${n} blocks/sec",
+         ("t",double((end-start).count())/1000000.0)
+         ("n",uint64_t(head_block_num()) * 1000000 / std::max<int64_t>((end-start).count(), 1)) );
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
 void database::wipe(const fc::path& data_dir, bool include_blocks)
@@ -138,6 +165,7 @@ void database::open(
               FC_ASSERT( head_block_num() == 0, "last block ID does not match current chain state" );
          }
       }
+      mark_all_feeds_for_update();
       _opened = true;
       //idump((head_block_id())(head_block_num()));
    }
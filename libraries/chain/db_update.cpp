@@ -26,9 +26,11 @@
 #include <graphene/chain/db_with.hpp>
 
 #include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/fund_object.hpp>
 #include <graphene/chain/global_property_object.hpp>
 #include <graphene/chain/hardfork.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/chain/operation_history_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
 #include <graphene/chain/transaction_history_object.hpp>
 #include <graphene/chain/withdraw_permission_object.hpp>
@@ -162,8 +164,8 @@ void database::clear_expired_transactions()
    //Transactions must have expired by at least two forking windows in order to be removed.
    auto& transaction_idx = static_cast<transaction_index&>(get_mutable_index(implementation_ids, impl_transaction_history_object_type));
    const auto& dedupe_index = transaction_idx.indices().get<by_expiration>();
-   while( (!dedupe_index.empty()) && (head_block_time() > dedupe_index.rbegin()->trx.expiration) )
-      transaction_idx.remove(*dedupe_index.rbegin());
+   while( (!dedupe_index.empty()) && (head_block_time() > dedupe_index.begin()->expiration) )
+      transaction_idx.remove(*dedupe_index.begin());
 } FC_CAPTURE_AND_RETHROW() }
 
 void database::clear_expired_proposals()
@@ -428,35 +430,68 @@ void database::clear_expired_orders()
 
 void database::update_expired_feeds()
 {
-   auto& asset_idx = get_index_type<asset_index>().indices().get<by_type>();
-   auto itr = asset_idx.lower_bound( true /** market issued */ );
-   while( itr != asset_idx.end() )
+   if( head_block_time() < HARDFORK_615_TIME )
    {
-      const asset_object& a = *itr;
-      ++itr;
-      assert( a.is_market_issued() );
-
-      const asset_bitasset_data_object& b = a.bitasset_data(*this);
-      bool feed_is_expired;
-      if( head_block_time() < HARDFORK_615_TIME )
-         feed_is_expired = b.feed_is_expired_before_hardfork_615( head_block_time() );
-      else
-         feed_is_expired = b.feed_is_expired( head_block_time() );
-      if( feed_is_expired )
+      auto& asset_idx = get_index_type<asset_index>().indices().get<by_type>();
+      auto itr = asset_idx.lower_bound( true /** market issued */ );
+      while( itr != asset_idx.end() )
       {
-         modify(b, [this](asset_bitasset_data_object& a) {
-            a.update_median_feeds(head_block_time());
-         });
-         check_call_orders(b.current_feed.settlement_price.base.asset_id(*this));
+         const asset_object& a = *itr;
+         ++itr;
+         assert( a.is_market_issued() );
+         update_expired_feed( a, a.bitasset_data(*this).feed_is_expired_before_hardfork_615( head_block_time() ) );
       }
-      if( !b.current_feed.core_exchange_rate.is_null() &&
-          a.options.core_exchange_rate != b.current_feed.core_exchange_rate )
-         modify(a, [&b](asset_object& a) {
-            a.options.core_exchange_rate = b.current_feed.core_exchange_rate;
-         });
+      _feed_updates.clear();
+      return;
+   }
+
+   // only the assets whose feed expires and those changed since the last block can need an update
+   const auto& expiration_idx = get_index_type<asset_bitasset_data_index>().indices().get<by_feed_expiration>();
+   for( auto itr = expiration_idx.begin(); itr != expiration_idx.end() && itr->feed_is_expired( head_block_time() ); ++itr )
+      _feed_updates.insert( itr->asset_id );
+
+   // the assets are visited in id order like all market issued assets were. Updating an asset marks it again,
+   // such marks and those of assets visited already are looked at in the next block
+   optional<asset_id_type> last;
+   while( true )
+   {
+      auto itr = last ? _feed_updates.upper_bound( *last ) : _feed_updates.begin();
+      if( itr == _feed_updates.end() )
+         break;
+      last = *itr;
+      _feed_updates.erase( itr );
+
+      // the asset may have been created by a pending transaction or a popped block only
+      const asset_object* a = find( *last );
+      if( a == nullptr )
+         continue;
+      update_expired_feed( *a, a->bitasset_data(*this).feed_is_expired( head_block_time() ) );
    }
 }
 
+void database::mark_all_feeds_for_update()
+{
+   for( const auto& bitasset : get_index_type<asset_bitasset_data_index>().indices() )
+      _feed_updates.insert( bitasset.asset_id );
+}
+
+void database::update_expired_feed( const asset_object& a, bool feed_is_expired )
+{
+   const asset_bitasset_data_object& b = a.bitasset_data(*this);
+   if( feed_is_expired )
+   {
+      modify(b, [this](asset_bitasset_data_object& a) {
+         a.update_median_feeds(head_block_time());
+      });
+      check_call_orders(b.current_feed.settlement_price.base.asset_id(*this));
+   }
+   if( !b.current_feed.core_exchange_rate.is_null() &&
+       a.options.core_exchange_rate != b.current_feed.core_exchange_rate )
+      modify(a, [&b](asset_object& a) {
+         a.options.core_exchange_rate = b.current_feed.core_exchange_rate;
+      });
+}
+
 void database::update_maintenance_flag( bool new_maintenance_flag )
 {
    modify( get_dynamic_global_properties(), [&]( dynamic_global_property_object& dpo )
@@ -476,4 +511,55 @@ void database::update_withdraw_permissions()
       remove(*permit_index.begin());
 }
 
+uint32_t database::prune_old_entities( uint32_t max_objects )
+{ try {
+   // pruned objects bypass undo history, a removal inside a session could not be undone
+   if( history_size <= 0 || max_objects == 0 || _undo_db.active_sessions() > 0 )
+      return 0;
+
+   // Only objects of blocks before the last irreversible one are pruned, popping blocks can never
+   // bring them back, and they are older than the history size, so no reversible block changed them.
+   const uint32_t last_irreversible_block = get_dynamic_global_properties().last_irreversible_block_num;
+   if( last_irreversible_block != _pruning_irreversible_block.first )
+   {
+      const optional<signed_block> block = fetch_block_by_number( last_irreversible_block );
+      _pruning_irreversible_block = std::make_pair( last_irreversible_block,
+                                                    block.valid() ? block->timestamp : fc::time_point_sec() );
+   }
+
+   const fc::time_point start = fc::time_point::now();
+   const fc::time_point_sec tp = std::min( fc::time_point_sec( head_block_time() - fc::days(history_size) ),
+                                            _pruning_irreversible_block.second );
+   uint32_t pruned = 0;
+
+   auto prune_older = [&]( const auto& idx, uint64_t& counter, const auto& get_time )
+   {
+      while( pruned < max_objects && !idx.empty() && get_time( *idx.begin() ) < tp )
+      {
+         prune( *idx.begin() );
+         ++counter;
+         ++pruned;
+      }
+   };
+
+   prune_older( get_index_type<operation_history_index>().indices().get<by_time>(), _pruning_stats.operation_history,
+                []( const operation_history_object& o ) { return o.block_time; } );
+   // issue_bonuses_old() depends on account_transaction_history_object
+   if( head_block_time() > HARDFORK_617_TIME )
+      prune_older( get_index_type<account_transaction_history_index>().indices().get<by_time>(), _pruning_stats.account_history,
+                   []( const account_transaction_history_object& o ) { return o.block_time; } );
+   prune_older( get_index_type<fund_transaction_history_index>().indices().get<by_time>(), _pruning_stats.fund_history,
+                []( const fund_transaction_history_object& o ) { return o.block_time; } );
+
+   if( pruned > 0 )
+   {
+      const fc::microseconds elapsed = fc::time_point::now() - start;
+      ++_pruning_stats.chunks;
+      _pruning_stats.total_time += elapsed;
+      if( elapsed > _pruning_stats.max_chunk_time )
+         _pruning_stats.max_chunk_time = elapsed;
+   }
+   return pruned;
+} FC_CAPTURE_AND_RETHROW( (max_objects) ) }
+
 } }
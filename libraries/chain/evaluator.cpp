@@ -38,23 +38,16 @@
 
 namespace graphene { namespace chain {
 database& generic_evaluator::db()const { return trx_state->db(); }
+block_timing_collector& generic_evaluator::block_timing()const { return trx_state->db().get_block_timing(); }
 
    operation_result generic_evaluator::start_evaluate( transaction_evaluation_state& eval_state, const operation& op, bool apply )
    { try {
       trx_state = &eval_state;
-      const database& d = db();
 
       //check_required_authorities(op);
-      if (d.head_block_time() > HARDFORK_620_TIME)
-      {
-         if (op.which() == operation::tag<transfer_operation>::value)
-         {
-            const transfer_operation& tr_op = op.get<transfer_operation>();
+      if (op.which() == operation::tag<transfer_operation>::value)
+         check_fee_asset( op.get<transfer_operation>() );
 
-            asset_id_type should_pay_in = tr_op.amount.asset_id(d).params.fee_paying_asset;
-            FC_ASSERT( tr_op.fee.asset_id == should_pay_in, "You should pay fee in ${a}. Payed in ${b}", ("a", should_pay_in(d).symbol)("b", tr_op.fee.asset_id) );
-         }
-      }
       auto result = evaluate( op );
 
       if( apply ) result = this->apply( op );
@@ -62,6 +55,16 @@ database& generic_evaluator::db()const { return trx_state->db(); }
       return result;
    } FC_CAPTURE_AND_RETHROW() }
 
+   void generic_evaluator::check_fee_asset( const transfer_operation& op )
+   {
+      const database& d = db();
+      if (d.head_block_time() > HARDFORK_620_TIME)
+      {
+         asset_id_type should_pay_in = op.amount.asset_id(d).params.fee_paying_asset;
+         FC_ASSERT( op.fee.asset_id == should_pay_in, "You should pay fee in ${a}. Payed in ${b}", ("a", should_pay_in(d).symbol)("b", op.fee.asset_id) );
+      }
+   }
+
    void generic_evaluator::prepare_fee(account_id_type account_id, asset fee)
    {
       const database& d = db();
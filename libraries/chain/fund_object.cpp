@@ -105,22 +105,56 @@ void fund_object::process(database& db) const
    h_item.create_datetime = db.head_block_time();
 
    const auto& users_idx = db.get_index_type<account_index>().indices().get<by_id>();
-   std::vector<fund_deposit_id_type> deps_to_remove;
 
-   // find own fund deposits
-   auto range = db.get_index_type<fund_deposit_index>().indices().get<by_fund_id>().equal_range(id);
-   std::for_each(range.first, range.second, [&](const fund_deposit_object& dep)
+   // everything below is constant during maintenance, so it is looked up once per fund
+   const time_point_sec now = db.head_block_time();
+   const bool hf_624 = (now >= HARDFORK_624_TIME);
+   const bool hf_625 = (now > HARDFORK_625_TIME);
+   const bool hf_626 = (now >= HARDFORK_626_TIME);
+   const bool hf_627 = (now > HARDFORK_627_TIME);
+   const bool hf_628 = (now > HARDFORK_628_TIME);
+   const time_point_sec prev_maintenance_time = dpo.next_maintenance_time - gpo.parameters.maintenance_interval;
+   const asset_dynamic_data_object& asst_dyn_data = asst.dynamic_asset_data_id(db);
+
+   flat_map<uint32_t, fund_options::payment_rate> rates_by_period;
+   for (const fund_options::payment_rate& item: payment_rates) {
+      rates_by_period.emplace(item.period, item); // the first rate of a period wins, as in get_payment_rate()
+   }
+
+   // same as database::check_supply_overflow(), the supply grows with every payment
+   auto supply_limited = [&](share_type quantity) {
+      if ((asst_dyn_data.current_supply + quantity) > asst.options.max_supply) {
+         return asst.amount(asst.options.max_supply - asst_dyn_data.current_supply);
+      }
+      return asst.amount(quantity);
+   };
+
+   // returned deposits, the fund balance is reduced once after all deposits are processed
+   share_type returned_deposits;
+
+   // find own active deposits, they are collected first because processing disables overdue ones
+   std::vector<const fund_deposit_object*> deposits;
+   {
+      auto range = db.get_index_type<fund_deposit_index>().indices().get<by_fund_enabled>().equal_range(boost::make_tuple(id, true));
+      for (auto itr = range.first; itr != range.second; ++itr) {
+         deposits.push_back(&*itr);
+      }
+   }
+
+   for (const fund_deposit_object* dep_ptr: deposits)
    {
+      const fund_deposit_object& dep = *dep_ptr;
       auto user_ptr = users_idx.find(dep.account_id);
 
       if (dep.enabled && (user_ptr != users_idx.end())) // dep.enabled: important condition for full-history nodes
       {
          const account_object& acc = *user_ptr;
-         const optional<fund_options::payment_rate>& p_rate = get_payment_rate(dep.period);
+         auto rate_itr = rates_by_period.find(dep.period);
+         const fund_options::payment_rate* p_rate = (rate_itr != rates_by_period.end()) ? &rate_itr->second : nullptr;
 
-         bool is_valid = (db.head_block_time() >= HARDFORK_626_TIME) ? (dep.daily_payment.value > 0) : p_rate.valid();
+         bool is_valid = hf_626 ? (dep.daily_payment.value > 0) : (p_rate != nullptr);
 
-         if ( (db.head_block_time() > HARDFORK_627_TIME)
+         if ( hf_627
               && (asst.get_id() == EDC_ASSET)
               && !dep.can_use_percent
             ) { is_valid = false; }
@@ -129,15 +163,15 @@ void fund_object::process(database& db) const
          {
             asset asst_quantity;
 
-            if (db.head_block_time() >= HARDFORK_626_TIME) {
-               asst_quantity = db.check_supply_overflow(asst.amount(dep.daily_payment));
+            if (hf_626) {
+               asst_quantity = supply_limited(dep.daily_payment);
             }
             else
             {
                share_type quantity = db.get_deposit_daily_payment(dep.percent, p_rate->period, dep.amount.amount);
 
                if (quantity.value > 0) {
-                  asst_quantity = db.check_supply_overflow(asst.amount(quantity));
+                  asst_quantity = supply_limited(quantity);
                }
             }
 
@@ -161,17 +195,17 @@ void fund_object::process(database& db) const
          }
 
          // return deposit amount to user and remove deposit if overdue
-         if ((dpo.next_maintenance_time - gpo.parameters.maintenance_interval) >= dep.datetime_end)
+         if (prev_maintenance_time >= dep.datetime_end)
          {
             bool dep_was_overdue = true;
 
-            if (db.head_block_time() >= HARDFORK_624_TIME)
+            if (hf_624)
             {
                if (acc.deposits_autorenewal_enabled)
                {
                   dep_was_overdue = false;
 
-                  if (db.head_block_time() > HARDFORK_625_TIME)
+                  if (hf_625)
                   {
                      chain::deposit_renewal_operation op;
                      op.account_id = dep.account_id;
@@ -179,14 +213,12 @@ void fund_object::process(database& db) const
                      op.percent = dep.percent;
 
                      // fund may already have new percents, updating...
-                     if (p_rate.valid() && !dep.manual_percent_enabled) {
+                     if (p_rate && !dep.manual_percent_enabled) {
                         op.percent = p_rate->percent;
                      }
 
-                     if (db.head_block_time() >= HARDFORK_626_TIME)
-                     {
-                        op.datetime_end = db.get_dynamic_global_properties().next_maintenance_time
-                                          - db.get_global_properties().parameters.maintenance_interval + (86400 * dep.period);
+                     if (hf_626) {
+                        op.datetime_end = prev_maintenance_time + (86400 * dep.period);
                      }
                      else {
                         op.datetime_end = dep.datetime_end + (86400 * dep.period);
@@ -203,7 +235,7 @@ void fund_object::process(database& db) const
                   {
                      db.modify(dep, [&](fund_deposit_object& dep)
                      {
-                        if (p_rate.valid()) {
+                        if (p_rate) {
                            dep.percent = p_rate->percent;
                         }
                         dep.datetime_end = db.get_dynamic_global_properties().last_budget_time + (86400 * dep.period);
@@ -214,11 +246,7 @@ void fund_object::process(database& db) const
 
             if (dep_was_overdue)
             {
-               // remove deposit
-               deps_to_remove.emplace_back(dep.get_id());
-
-               if ( (db.head_block_time() <= HARDFORK_628_TIME)
-                    || ((db.head_block_time() > HARDFORK_628_TIME) && (dep.amount.amount > 0)) )
+               if ( !hf_628 || (dep.amount.amount > 0) )
                {
                   // return deposit to user
                   chain::fund_withdrawal_operation op;
@@ -226,7 +254,7 @@ void fund_object::process(database& db) const
                   op.fund_id = id;
                   op.asset_to_issue = asst.amount(dep.amount.amount);
                   op.issue_to_account = dep.account_id;
-                  op.datetime = db.head_block_time();
+                  op.datetime = now;
 
                   try
                   {
@@ -234,10 +262,7 @@ void fund_object::process(database& db) const
                      db.apply_operation(eval, op);
                   } catch (fc::assert_exception& e) {}
 
-                  // reduce fund balance
-                  db.modify(*this, [&](chain::fund_object& f) {
-                     f.balance -= dep.amount.amount;
-                  });
+                  returned_deposits += dep.amount.amount;
 
                   // disable deposit
                   db.modify(dep, [&](chain::fund_deposit_object& f) {
@@ -247,7 +272,15 @@ void fund_object::process(database& db) const
             }
          }
       }
-   });
+   }
+
+   // reduce fund balance
+   if (returned_deposits != 0)
+   {
+      db.modify(*this, [&](chain::fund_object& f) {
+         f.balance -= returned_deposits;
+      });
+   }
 
    /***************** make payment to fund owner *****************/
 
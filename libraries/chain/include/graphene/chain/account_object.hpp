@@ -113,9 +113,13 @@ namespace graphene { namespace chain {
          asset_id_type     asset_type;
          share_type        balance;
          bool              mandatory_transfer = false;
+         /// maturity epoch of mandatory_transfer, see @ref dynamic_global_property_object::maturity_epoch
+         uint32_t          maturity_epoch = 0;
 
          asset get_balance()const { return asset(balance, asset_type); }
          void  adjust_balance(const asset& delta);
+         bool  is_holder()const { return balance > 0; }
+         bool  is_mandatory_transfer(uint32_t epoch)const { return maturity_epoch == epoch && mandatory_transfer; }
    };
 
    struct referral_balance_info {
@@ -186,10 +190,15 @@ namespace graphene { namespace chain {
          share_type        balance;
          bool              mandatory_transfer = false;  
          vector<mature_balances_history> history;
+         /// the object is reset to the real balance when it is older than the current maturity epoch
+         uint32_t          maturity_epoch = 0;
 
          asset get_balance()const { return asset(balance, asset_type); }
+         bool  is_mandatory_transfer(uint32_t epoch)const { return maturity_epoch == epoch && mandatory_transfer; }
          void  adjust_balance(const asset& delta, const asset& real_balance, const int64_t mandatory_transfer);
          void  consider_mining(uint16_t minied_minutes);
+         /// resets maturity to the @p real_balance as of the start of the @p epoch
+         void  reset(share_type real_balance, uint32_t epoch);
    };
 
    class restricted_account_object : public graphene::db::abstract_object<restricted_account_object>
@@ -536,6 +545,7 @@ namespace graphene { namespace chain {
 
    struct by_account_asset;
    struct by_asset_balance;
+   struct by_asset_holder;
    struct by_account;
    /**
     * @ingroup object_index
@@ -563,6 +573,20 @@ namespace graphene { namespace chain {
                std::greater< share_type >,
                std::less< account_id_type >
             >
+         >,
+         // holders (balance > 0) of an asset come first, ordered by owner, so they can be paged by account id
+         ordered_unique< tag<by_asset_holder>,
+            composite_key<
+               account_balance_object,
+               member<account_balance_object, asset_id_type, &account_balance_object::asset_type>,
+               const_mem_fun<account_balance_object, bool, &account_balance_object::is_holder>,
+               member<account_balance_object, account_id_type, &account_balance_object::owner>
+            >,
+            composite_key_compare<
+               std::less< asset_id_type >,
+               std::greater< bool >,
+               std::less< account_id_type >
+            >
          >
       >
    > account_balance_object_multi_index_type;
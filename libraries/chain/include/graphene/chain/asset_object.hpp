@@ -180,6 +180,9 @@ namespace graphene { namespace chain {
          static const uint8_t space_id = implementation_ids;
          static const uint8_t type_id  = impl_asset_bitasset_data_object_type;
 
+         /// The asset this data belongs to
+         asset_id_type asset_id;
+
          /// The tunable options for BitAssets are stored in this field.
          bitasset_options options;
 
@@ -236,7 +239,7 @@ namespace graphene { namespace chain {
          >
       >
    > asset_bitasset_data_object_multi_index_type;
-   typedef flat_index<asset_bitasset_data_object> asset_bitasset_data_index;
+   typedef generic_index<asset_bitasset_data_object, asset_bitasset_data_object_multi_index_type> asset_bitasset_data_index;
 
    struct by_symbol;
    struct by_type;
@@ -255,6 +258,27 @@ namespace graphene { namespace chain {
    > asset_object_multi_index_type;
    typedef generic_index<asset_object, asset_object_multi_index_type> asset_index;
 
+   /**
+    *  @brief Collects the market issued assets whose options or bitasset data changed
+    *
+    *  This is a secondary index on the asset_index and the asset_bitasset_data_index. The core exchange rate of
+    *  an asset only has to be synchronized with its feed after one of them changed, so update_expired_feeds()
+    *  looks at the collected assets and the assets whose feed expires instead of at every market issued asset.
+    */
+   class feed_update_index : public secondary_index
+   {
+      public:
+         explicit feed_update_index( flat_set<asset_id_type>* updated ) : _updated( updated ) {}
+
+         virtual void object_inserted( const object& obj ) override { mark( obj ); }
+         virtual void object_modified( const object& after ) override { mark( after ); }
+
+      private:
+         void mark( const object& obj );
+
+         flat_set<asset_id_type>* _updated;
+   };
+
 } } // graphene::chain
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::asset_object)
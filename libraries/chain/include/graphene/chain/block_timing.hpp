@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/types.hpp>
+
+#include <fc/time.hpp>
+
+#include <array>
+
+/**
+ * Block timing is collected unless the tree is configured with -DGRAPHENE_DISABLE_BLOCK_TIMING=ON,
+ * in which case the GRAPHENE_*_TIMER macros expand to nothing and the statistics stay empty.
+ */
+#ifdef GRAPHENE_DISABLE_BLOCK_TIMING
+#  define GRAPHENE_BLOCK_PHASE_TIMER( collector, phase )
+#  define GRAPHENE_OPERATION_TIMER( collector, which, apply )
+#  define GRAPHENE_BLOCK_OBSERVER_TIMER( collector, name )
+#else
+#  define GRAPHENE_BLOCK_PHASE_TIMER( collector, phase ) \
+      (collector).phase_finished( graphene::chain::block_phase::phase )
+#  define GRAPHENE_OPERATION_TIMER( collector, which, apply ) \
+      graphene::chain::scoped_operation_timer _operation_timer( collector, which, apply )
+#  define GRAPHENE_BLOCK_OBSERVER_TIMER( collector, name ) \
+      graphene::chain::scoped_observer_timer _observer_timer( collector, name )
+#endif
+
+namespace graphene { namespace chain {
+
+   /**
+    * Log2 histogram of durations in microseconds or of sizes. Bucket 0 counts zeros and bucket i
+    * counts the values in [2^(i-1), 2^i), the last bucket also counts everything above.
+    */
+   struct timing_histogram
+   {
+      static const uint32_t bucket_count = 24;
+
+      uint64_t         count = 0;
+      uint64_t         total = 0;
+      uint64_t         max   = 0;
+      vector<uint64_t> buckets;
+
+      void add( uint64_t value );
+   };
+
+   /// steps of database::_apply_block, in the order in which they run
+   enum class block_phase : uint8_t
+   {
+      transactions,
+      update_global_dynamic_data,
+      update_signing_witness,
+      update_last_irreversible_block,
+      chain_maintenance,
+      create_block_summary,
+      clear_expired_transactions,
+      clear_expired_proposals,
+      clear_expired_orders,
+      update_expired_feeds,
+      update_withdraw_permissions,
+      update_witness_schedule,
+      applied_block,
+      notify_changed_objects,
+      phase_count
+   };
+
+   struct block_timing_statistics
+   {
+      uint64_t                           blocks = 0;
+      /// time of _apply_block in microseconds
+      timing_histogram                   block_time;
+      flat_map<string, timing_histogram> phases;
+      /// time spent in the applied_block handlers of plugins
+      flat_map<string, timing_histogram> observers;
+      /// evaluation and application time per operation type, of blocks and of pending transactions
+      flat_map<string, timing_histogram> evaluate;
+      flat_map<string, timing_histogram> apply;
+      /// size of the undo state of each block
+      timing_histogram                   undo_old_values;
+      timing_histogram                   undo_new_ids;
+      timing_histogram                   undo_removed;
+   };
+
+   /**
+    * @brief Collects where the time of applying blocks goes
+    *
+    * The database marks the end of every phase of _apply_block, evaluators record the time of each
+    * operation and plugins the time of their applied_block handlers. Recording is a clock read and
+    * a few increments, names are only resolved when the statistics are fetched.
+    *
+    * Blocks slower than the log threshold are logged with their phase breakdown.
+    */
+   class block_timing_collector
+   {
+      public:
+         block_timing_collector();
+
+         /// a zero threshold disables logging of slow blocks
+         void set_log_threshold( fc::microseconds threshold ) { _log_threshold = threshold; }
+
+         void block_started();
+         void phase_finished( block_phase phase );
+         void block_finished( uint32_t block_num, size_t undo_old_values, size_t undo_new_ids, size_t undo_removed );
+
+         void record_operation( int which, bool apply, fc::microseconds duration );
+         /// @param name a string literal, observers are keyed by its address and only named on get_statistics()
+         void record_observer( const char* name, fc::microseconds duration );
+
+         block_timing_statistics get_statistics()const;
+         void reset();
+
+      private:
+         typedef std::array<timing_histogram, size_t(block_phase::phase_count)> phase_histograms;
+
+         phase_histograms                                        _phases;
+         std::array<int64_t, size_t(block_phase::phase_count)>   _block_phases;
+         vector<timing_histogram>                                _evaluate;
+         vector<timing_histogram>                                _apply;
+         flat_map<const char*, timing_histogram>                 _observers;
+         timing_histogram                                        _block_time;
+         timing_histogram                                        _undo_old_values;
+         timing_histogram                                        _undo_new_ids;
+         timing_histogram                                        _undo_removed;
+         uint64_t                                                _blocks = 0;
+         fc::time_point                                          _block_start;
+         fc::time_point                                          _phase_start;
+         fc::microseconds                                        _log_threshold;
+   };
+
+   class scoped_operation_timer
+   {
+      public:
+         scoped_operation_timer( block_timing_collector& collector, int which, bool apply )
+            : _collector( collector ), _which( which ), _apply( apply ), _start( fc::time_point::now() ) {}
+         ~scoped_operation_timer() { _collector.record_operation( _which, _apply, fc::time_point::now() - _start ); }
+
+      private:
+         block_timing_collector& _collector;
+         int                     _which;
+         bool                    _apply;
+         fc::time_point          _start;
+   };
+
+   class scoped_observer_timer
+   {
+      public:
+         scoped_observer_timer( block_timing_collector& collector, const char* name )
+            : _collector( collector ), _name( name ), _start( fc::time_point::now() ) {}
+         ~scoped_observer_timer() { _collector.record_observer( _name, fc::time_point::now() - _start ); }
+
+      private:
+         block_timing_collector& _collector;
+         const char*             _name;
+         fc::time_point          _start;
+   };
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::timing_histogram, (count)(total)(max)(buckets) )
+FC_REFLECT( graphene::chain::block_timing_statistics,
+            (blocks)(block_time)(phases)(observers)(evaluate)(apply)(undo_old_values)(undo_new_ids)(undo_removed) )
@@ -23,8 +23,8 @@ namespace graphene { namespace chain {
       static const uint8_t type_id  = cheque_object_type;
 
       cheque_id_type            get_id() const { return id; }
-      void                      allocate_payees(uint32_t payees_count);
-      void                      process_payee(account_id_type payee, database& db);
+      /// pays out one subcheque, the payee itself is recorded in a cheque_payee_object
+      void                      process_payee(fc::time_point_sec now);
 
       asset get_remaining_amount() const {
          return asset(amount_remaining, asset_id);
@@ -57,27 +57,43 @@ namespace graphene { namespace chain {
       // cheque status (send / receive)
       cheque_status status = cheque_status::cheque_new;
 
-      // all payees are initialize on creation time in
-      struct payee_item
-      {
-         // account which has used part of cheque
-         account_id_type payee;
+      // number of subcheques
+      uint32_t payees_count = 0;
 
-         // cheque date and time, when it was used
-         fc::time_point_sec datetime_used;
+      // number of subcheques which have been used
+      uint32_t payees_used = 0;
 
-         // subcheque status
-         cheque_status status = cheque_status::cheque_new;
-      };
+   }; // cheque_object
+
+   /**
+    * @class cheque_payee_object
+    * @ingroup object
+    *
+    * A used subcheque. Every payee of a cheque is a separate object, so that redeeming a cheque neither
+    * scans nor copies the payees which came before.
+    */
+   class cheque_payee_object: public db::abstract_object<cheque_payee_object>
+   {
+   public:
+      static const uint8_t space_id = implementation_ids;
+      static const uint8_t type_id  = impl_cheque_payee_object_type;
 
-      std::vector<payee_item> payees;
+      cheque_id_type     cheque;
 
-   }; // cheque_object
+      // account which has used part of cheque
+      account_id_type    payee;
+
+      // subcheque date and time, when it was used
+      fc::time_point_sec datetime_used;
+   };
 
    struct by_drawer;
    struct by_code;
    struct by_datetime_exp;
    struct by_datetime_creation;
+   struct by_status_exp;
+   struct by_cheque_payee;
+   struct by_payee;
 
    /**
     * @ingroup object_index
@@ -89,7 +105,14 @@ namespace graphene { namespace chain {
          ordered_unique<tag<by_code>, member<cheque_object, std::string, &cheque_object::code>>,
          ordered_non_unique<tag<by_drawer>, member<cheque_object, account_id_type, &cheque_object::drawer>>,
          ordered_non_unique<tag<by_datetime_creation>, member<cheque_object, fc::time_point_sec, &cheque_object::datetime_creation>>,
-         ordered_non_unique<tag<by_datetime_exp>, member<cheque_object, fc::time_point_sec, &cheque_object::datetime_expiration>>
+         ordered_non_unique<tag<by_datetime_exp>, member<cheque_object, fc::time_point_sec, &cheque_object::datetime_expiration>>,
+         ordered_unique<tag<by_status_exp>,
+            composite_key<cheque_object,
+               member<cheque_object, cheque_status, &cheque_object::status>,
+               member<cheque_object, fc::time_point_sec, &cheque_object::datetime_expiration>,
+               member<object, object_id_type, &object::id>
+            >
+         >
       >
    > cheque_object_index_type;
 
@@ -98,16 +121,40 @@ namespace graphene { namespace chain {
     */
    typedef generic_index<cheque_object, cheque_object_index_type> cheque_index;
 
+   /**
+    * @ingroup object_index
+    */
+   typedef multi_index_container<
+   cheque_payee_object,
+   indexed_by<
+         ordered_unique<tag<by_id>, member<object, object_id_type, &object::id>>,
+         ordered_unique<tag<by_cheque_payee>,
+            composite_key<cheque_payee_object,
+               member<cheque_payee_object, cheque_id_type, &cheque_payee_object::cheque>,
+               member<cheque_payee_object, account_id_type, &cheque_payee_object::payee>
+            >
+         >,
+         ordered_unique<tag<by_payee>,
+            composite_key<cheque_payee_object,
+               member<cheque_payee_object, account_id_type, &cheque_payee_object::payee>,
+               member<cheque_payee_object, cheque_id_type, &cheque_payee_object::cheque>
+            >
+         >
+      >
+   > cheque_payee_object_index_type;
+
+   /**
+    * @ingroup object_index
+    */
+   typedef generic_index<cheque_payee_object, cheque_payee_object_index_type> cheque_payee_index;
+
 }}
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::cheque_object)
-
-FC_REFLECT( graphene::chain::cheque_object::payee_item,
-            (payee)
-            (datetime_used)
-            (status));
+MAP_OBJECT_ID_TO_TYPE(graphene::chain::cheque_payee_object)
 
 FC_REFLECT_TYPENAME( graphene::chain::cheque_object )
+FC_REFLECT_TYPENAME( graphene::chain::cheque_payee_object )
 
-GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::cheque_object::payee_item )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::cheque_object )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::cheque_payee_object )
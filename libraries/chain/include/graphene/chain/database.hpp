@@ -31,6 +31,7 @@
 #include <graphene/chain/block_database.hpp>
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/chain/evaluator.hpp>
+#include <graphene/chain/block_timing.hpp>
 #include <graphene/chain/tree.hpp>
 
 #include <graphene/db/object_database.hpp>
@@ -45,7 +46,6 @@
 namespace graphene { namespace chain {
    using graphene::db::abstract_object;
    using graphene::db::object;
-   class op_evaluator;
    class transaction_evaluation_state;
    class proposal_object;
    class operation_history_object;
@@ -57,6 +57,24 @@ namespace graphene { namespace chain {
 
    struct budget_record;
 
+   /**
+    * @brief Counters of the history pruning enabled by --fast, see @ref database::prune_old_entities
+    */
+   struct pruning_statistics
+   {
+      uint64_t         operation_history = 0;
+      uint64_t         account_history = 0;
+      uint64_t         fund_history = 0;
+      uint32_t         chunks = 0;
+      fc::microseconds total_time;
+      fc::microseconds max_chunk_time;
+
+      uint64_t pruned()const
+      {
+         return operation_history + account_history + fund_history;
+      }
+   };
+
    /**
     *   @class database
     *   @brief tracks the blockchain state in an extensible manner
@@ -107,6 +125,9 @@ namespace graphene { namespace chain {
           *
           * This method may be called after or instead of @ref database::open, and will rebuild the object graph by
           * replaying blockchain history. When this method exits successfully, the database will be open.
+          *
+          * The blocks come from our own block log and were fully checked when they were first applied, so they are
+          * applied in replay mode, see @ref is_replaying.
           */
          void reindex(fc::path data_dir, const genesis_state_type& initial_allocation = genesis_state_type());
 
@@ -119,6 +140,20 @@ namespace graphene { namespace chain {
          void wipe(const fc::path& data_dir, bool include_blocks);
          void close(bool rewind = true);
          void set_history_size(int _history_size) { history_size = _history_size; }
+         /// maximum number of old history objects pruned after each block
+         void set_pruning_chunk_size(uint32_t chunk_size) { _pruning_chunk_size = chunk_size; }
+         const pruning_statistics& get_pruning_statistics()const { return _pruning_stats; }
+
+         /// timing of _apply_block phases, operations and applied_block observers
+         block_timing_collector& get_block_timing() { return _block_timing; }
+         block_timing_statistics get_block_timing_statistics()const { return _block_timing.get_statistics(); }
+
+         /**
+          * @return true while @ref reindex applies blocks from the block log. In replay mode skip_validate is honored,
+          * transactions are not copied into the returned processed_transaction, the temp account balance check is
+          * skipped and no object change notifications are emitted. applied_block is still emitted for the plugins.
+          */
+         bool is_replaying()const { return _replaying; }
 
          void enable_referrer_mode() { _referrer_mode_enabled = true; }
          bool referrer_mode_is_enabled() { return _referrer_mode_enabled; }
@@ -134,7 +169,7 @@ namespace graphene { namespace chain {
          block_id_type              get_block_id_for_num( uint32_t block_num )const;
          optional<signed_block>     fetch_block_by_id( const block_id_type& id )const;
          optional<signed_block>     fetch_block_by_number( uint32_t num )const;
-         const signed_transaction&  get_recent_transaction( const transaction_id_type& trx_id )const;
+         signed_transaction         get_recent_transaction( const transaction_id_type& trx_id )const;
          std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
 
          /**
@@ -195,6 +230,12 @@ namespace graphene { namespace chain {
           */
          fc::signal<void(const signed_block&)>           applied_block;
 
+         /**
+          *  This signal is emitted after a pushed or replayed block has been committed, while no undo
+          *  session is open. Objects of irreversible blocks may be removed with prune() from here.
+          */
+         fc::signal<void(const signed_block&)>           committed_block;
+
          /**
           * This signal is emitted any time a new transaction is added to the pending
           * block state.
@@ -288,7 +329,7 @@ namespace graphene { namespace chain {
          void register_evaluator()
          {
             _operation_evaluators[
-               operation::tag<typename EvaluatorType::operation_type>::value].reset( new op_evaluator_impl<EvaluatorType>() );
+               operation::tag<typename EvaluatorType::operation_type>::value] = &evaluate_operation<EvaluatorType>;
          }
 
          //////////////////// db_balance.cpp ////////////////////
@@ -471,7 +512,7 @@ namespace graphene { namespace chain {
 
       private:
          optional<undo_database::session>       _pending_tx_session;
-         vector< unique_ptr<op_evaluator> >     _operation_evaluators;
+         vector< op_evaluator >                 _operation_evaluators;
 
          template<class Index>
          vector<std::reference_wrapper<const typename Index::object_type>> sort_votable_objects(size_t count)const;
@@ -487,7 +528,9 @@ namespace graphene { namespace chain {
 
       private:
          void                  _apply_block( const signed_block& next_block );
-         processed_transaction _apply_transaction( const signed_transaction& trx, bool need_apply_address_creation = true );
+         /// without @p need_result the operations are applied but no processed_transaction is built
+         processed_transaction _apply_transaction( const signed_transaction& trx, bool need_apply_address_creation = true,
+                                                   bool need_result = true );
 
          ///Steps involved in applying a new block
          ///@{
@@ -504,8 +547,11 @@ namespace graphene { namespace chain {
          void clear_expired_proposals();
          void clear_expired_orders();
          void update_expired_feeds();
+         void update_expired_feed( const asset_object& a, bool feed_is_expired );
+         void mark_all_feeds_for_update();
          void update_maintenance_flag( bool new_maintenance_flag );
          void update_withdraw_permissions();
+         uint32_t prune_old_entities( uint32_t max_objects );
          bool check_for_blackswan( const asset_object& mia, bool enable_black_swan = true );
 
          ///Steps performed only at maintenance intervals
@@ -523,6 +569,9 @@ namespace graphene { namespace chain {
          void issue_bonuses();
          bool bonus_allowed(account_id_type issue_to_account, asset asset_to_issue, account_id_type issuer);
          void clear_account_mature_balance_index();
+         /// applies the maturity reset of the current epoch to the balance and its mature balance
+         void refresh_maturity(const account_balance_object& bal_object);
+         void refresh_maturity(account_id_type owner, asset_id_type asset_id);
          void update_active_witnesses();
          void update_active_committee_members();
          void update_worker_votes();
@@ -541,8 +590,17 @@ namespace graphene { namespace chain {
          ///@}
 
          int history_size = 0;
+         uint32_t _pruning_chunk_size = 1000;
+         pruning_statistics _pruning_stats;
+         /// number and time of the last irreversible block seen by prune_old_entities()
+         std::pair<uint32_t, fc::time_point_sec> _pruning_irreversible_block;
+         block_timing_collector _block_timing;
+         /// market issued assets changed since update_expired_feeds() last looked at them, see feed_update_index.
+         /// The marks are neither undone nor saved, so all assets are marked after open and after undoing a block.
+         flat_set<asset_id_type> _feed_updates;
          // any LTM-member can create accounts
          bool _referrer_mode_enabled = false;
+         bool _replaying = false;
 
          vector< processed_transaction >        _pending_tx;
          fork_database                          _fork_db;
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #pragma once
+#include <graphene/chain/block_timing.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/transaction_evaluation_state.hpp>
 #include <graphene/protocol/operations.hpp>
@@ -69,6 +70,7 @@ namespace graphene { namespace chain {
       virtual void pay_fee();
 
       database& db()const;
+      block_timing_collector& block_timing()const;
 
       //void check_required_authorities(const operation& op);
    protected:
@@ -100,6 +102,14 @@ namespace graphene { namespace chain {
 
       object_id_type get_relative_id( object_id_type rel_id )const;
 
+      /**
+       * Checks done for every operation before it is evaluated. The transfer overload is picked at
+       * compile time, so other operations do not pay for a tag check.
+       */
+      void check_fee_asset( const transfer_operation& op );
+      template<typename Operation>
+      void check_fee_asset( const Operation& ) {}
+
       /**
        * pay_fee() for FBA subclass should simply call this method
        */
@@ -120,24 +130,6 @@ namespace graphene { namespace chain {
       transaction_evaluation_state*    trx_state;
    };
 
-   class op_evaluator
-   {
-   public:
-      virtual ~op_evaluator(){}
-      virtual operation_result evaluate(transaction_evaluation_state& eval_state, const operation& op, bool apply) = 0;
-   };
-
-   template<typename T>
-   class op_evaluator_impl : public op_evaluator
-   {
-   public:
-      virtual operation_result evaluate(transaction_evaluation_state& eval_state, const operation& op, bool apply = true) override
-      {
-         T eval;
-         return eval.start_evaluate(eval_state, op, apply);
-      }
-   };
-
    template<typename DerivedEvaluator>
    class evaluator : public generic_evaluator
    {
@@ -145,15 +137,51 @@ namespace graphene { namespace chain {
       virtual int get_type()const override { return operation::tag<typename DerivedEvaluator::operation_type>::value; }
 
       virtual operation_result evaluate(const operation& o) final override
+      {
+         return evaluate_typed( o, o.get<typename DerivedEvaluator::operation_type>() );
+      }
+
+      virtual operation_result apply(const operation& o) final override
+      {
+         return apply_typed( o.get<typename DerivedEvaluator::operation_type>() );
+      }
+
+      /**
+       * Evaluates and optionally applies @p op without going through the virtual interface,
+       * @p op has been extracted from @p o by the caller.
+       */
+      template<typename Operation>
+      operation_result start_evaluate_typed( transaction_evaluation_state& eval_state, const operation& o,
+                                             const Operation& op, bool apply )
+      { try {
+         trx_state = &eval_state;
+         check_fee_asset( op );
+
+         operation_result result;
+         {
+            GRAPHENE_OPERATION_TIMER( block_timing(), o.which(), false );
+            result = evaluate_typed( o, op );
+         }
+         if( apply )
+         {
+            GRAPHENE_OPERATION_TIMER( block_timing(), o.which(), true );
+            result = apply_typed( op );
+         }
+
+         return result;
+      } FC_CAPTURE_AND_RETHROW() }
+
+   protected:
+      template<typename Operation>
+      operation_result evaluate_typed( const operation& o, const Operation& op )
       {
          auto* eval = static_cast<DerivedEvaluator*>(this);
-         const auto& op = o.get<typename DerivedEvaluator::operation_type>();
 
          prepare_fee(op.fee_payer(), op.fee);
 
          if( !trx_state->skip_fee_schedule_check )
          {
-            share_type required_fee = calculate_fee_for_operation(op);
+            share_type required_fee = calculate_fee_for_operation(o);
 
             GRAPHENE_ASSERT( core_fee_paid >= required_fee,
                        insufficient_fee,
@@ -163,20 +191,38 @@ namespace graphene { namespace chain {
          return eval->do_evaluate(op);
       }
 
-      virtual operation_result apply(const operation& o) final override
+      template<typename Operation>
+      operation_result apply_typed( const Operation& op )
       {
          auto* eval = static_cast<DerivedEvaluator*>(this);
-         const auto& op = o.get<typename DerivedEvaluator::operation_type>();
 
          convert_fee();
 
          auto result = eval->do_apply(op);
-         
-         pay_fee();
+
+         eval->pay_fee();
 
          db_adjust_balance(op.fee_payer(), -fee_from_account);
 
          return result;
       }
    };
+
+   /**
+    * Entry of the evaluator dispatch table of the database, indexed by operation tag. Each entry
+    * is an instance of @ref evaluate_operation for the evaluator registered for that tag.
+    */
+   typedef operation_result (*op_evaluator)( transaction_evaluation_state& eval_state, const operation& op, bool apply );
+
+   /**
+    * Evaluates @p op with a DerivedEvaluator constructed on the stack. Every call on the evaluator
+    * is resolved at compile time, the only indirect call is the table lookup which selects
+    * this function.
+    */
+   template<typename DerivedEvaluator>
+   operation_result evaluate_operation( transaction_evaluation_state& eval_state, const operation& op, bool apply )
+   {
+      DerivedEvaluator eval;
+      return eval.start_evaluate_typed( eval_state, op, op.get<typename DerivedEvaluator::operation_type>(), apply );
+   }
 } }
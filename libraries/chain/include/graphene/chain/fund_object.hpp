@@ -157,6 +157,7 @@ namespace graphene { namespace chain {
 
    struct by_account_id;
    struct by_fund_id;
+   struct by_fund_enabled;
    struct by_period;
    struct by_datetime_end;
 
@@ -169,7 +170,20 @@ namespace graphene { namespace chain {
             ordered_unique<tag<by_id>, member<object, object_id_type, &object::id>>,
             ordered_non_unique<tag<by_account_id>, member<fund_deposit_object, account_id_type, &fund_deposit_object::account_id>>,
             ordered_non_unique<tag<by_fund_id>, member<fund_deposit_object, fund_id_type, &fund_deposit_object::fund_id>>,
-            ordered_non_unique<tag<by_period>, member<fund_deposit_object, uint32_t, &fund_deposit_object::period>>,
+            // active deposits of a fund, so that maintenance does not visit finished ones
+            ordered_unique<tag<by_fund_enabled>,
+               composite_key<fund_deposit_object,
+                  member<fund_deposit_object, fund_id_type, &fund_deposit_object::fund_id>,
+                  member<fund_deposit_object, bool, &fund_deposit_object::enabled>,
+                  member<object, object_id_type, &object::id>
+               >
+            >,
+            ordered_unique<tag<by_period>,
+               composite_key<fund_deposit_object,
+                  member<fund_deposit_object, uint32_t, &fund_deposit_object::period>,
+                  member<object, object_id_type, &object::id>
+               >
+            >,
             ordered_non_unique<tag<by_datetime_end>, member<fund_deposit_object, fc::time_point_sec, &fund_deposit_object::datetime_end>>
          >
    > fund_deposit_object_index_type;
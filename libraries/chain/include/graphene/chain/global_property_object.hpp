@@ -124,6 +124,12 @@ namespace graphene { namespace chain {
 
          uint32_t last_irreversible_block_num = 0;
 
+         /**
+          * Incremented when maintenance resets coin maturity. Balance and mature balance objects
+          * stamped with an older epoch are treated as reset and normalized when touched next.
+          */
+         uint32_t maturity_epoch = 0;
+
          enum dynamic_flag_bits
          {
             /**
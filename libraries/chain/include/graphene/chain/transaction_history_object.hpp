@@ -43,6 +43,9 @@ namespace graphene { namespace chain {
     * The purpose of this object is to enable the detection of duplicate transactions. When a transaction is included
     * in a block a transaction_history_object is added. At the end of block processing all transaction_history_objects that have
     * expired can be removed from the index.
+    *
+    * Only the id and the expiration are needed for that. The transaction itself is read from the block it was included
+    * in, or from the pending transactions while it is not in a block yet, see database::get_recent_transaction().
     */
    class transaction_history_object : public abstract_object<transaction_history_object>
    {
@@ -50,10 +53,12 @@ namespace graphene { namespace chain {
          static const uint8_t space_id = implementation_ids;
          static const uint8_t type_id  = impl_transaction_history_object_type;
 
-         signed_transaction  trx;
          transaction_id_type trx_id;
-
-         time_point_sec get_expiration()const { return trx.expiration; }
+         time_point_sec      expiration;
+         /// the block the transaction is in, a block after the head block while the transaction is pending
+         uint32_t            block_num = 0;
+         /// position in the block, or in the pending transactions while the transaction is pending
+         uint16_t            trx_in_block = 0;
    };
 
    struct by_expiration;
@@ -63,7 +68,7 @@ namespace graphene { namespace chain {
       indexed_by<
          ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
          hashed_unique< tag<by_trx_id>, BOOST_MULTI_INDEX_MEMBER(transaction_history_object, transaction_id_type, trx_id), std::hash<transaction_id_type> >,
-         ordered_non_unique< tag<by_expiration>, const_mem_fun<transaction_history_object, time_point_sec, &transaction_history_object::get_expiration > >
+         ordered_non_unique< tag<by_expiration>, member<transaction_history_object, time_point_sec, &transaction_history_object::expiration > >
       >
    > transaction_multi_index_type;
 
@@ -39,15 +39,17 @@ class referral_tree {
     const asset_id_type asset_id;
     account_id_type root_account;
     const account_mature_balance_index* mature_balances_idx;
+    uint32_t maturity_epoch;
     tree<leaf_info> form();
     tree<leaf_info> form_old();
     std::list<referral_info> scan();
     std::list<referral_info> scan_old();
     referral_tree(const account_index& accs, const account_balance_index& bals,
                   asset_id_type asst, account_id_type root_account = account_id_type(),
-                  const account_mature_balance_index* coin_maturity_bal_idx = nullptr)
+                  const account_mature_balance_index* coin_maturity_bal_idx = nullptr,
+                  uint32_t coin_maturity_epoch = 0)
                   : accounts_idx(accs), balances_idx(bals), asset_id(asst), root_account(root_account),
-                    mature_balances_idx(coin_maturity_bal_idx)
+                    mature_balances_idx(coin_maturity_bal_idx), maturity_epoch(coin_maturity_epoch)
     {
         int64_t zero_account_balance = get_balance(root_account).amount.value;
         int64_t zero_mature_balance = get_mature_balance(root_account).amount.value;
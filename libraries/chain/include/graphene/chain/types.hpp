@@ -55,4 +55,5 @@ GRAPHENE_DEFINE_IDS(chain, implementation_ids, impl_,
    (fund_history)                         // [idx: 24]
    (settings)
    (blind_transfer2)                      // [idx: 26]
+   (cheque_payee)
 )
@@ -72,7 +72,7 @@ namespace graphene { namespace chain {
         return asset(0, asset_id);
      auto &idx = mature_balances_idx->indices().get<by_account_asset>();
      auto itr = idx.find(boost::make_tuple(owner, asset_id));
-     if (itr == idx.end() || !itr->mandatory_transfer)
+     if (itr == idx.end() || !itr->is_mandatory_transfer(maturity_epoch))
         return asset(0, asset_id);
      return itr->get_balance();
   }
@@ -27,6 +27,7 @@
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
+#include <boost/mpl/size.hpp>
 
 namespace graphene { namespace db {
 
@@ -34,6 +35,29 @@ namespace graphene { namespace db {
    using namespace boost::multi_index;
 
    struct by_id;
+
+   namespace detail {
+      /// hashed indices are sized up front, the other index kinds have nothing to reserve
+      template<typename Index>
+      auto reserve_index( Index& idx, size_t count, int ) -> decltype( idx.reserve( count ), void() )
+      {
+         idx.reserve( count );
+      }
+      template<typename Index>
+      void reserve_index( Index&, size_t, long ) {}
+
+      template<typename Container, size_t N = 0>
+      typename std::enable_if< N == boost::mpl::size<typename Container::index_type_list>::value >::type
+      reserve_indices( Container&, size_t ) {}
+
+      template<typename Container, size_t N = 0>
+      typename std::enable_if< (N < boost::mpl::size<typename Container::index_type_list>::value) >::type
+      reserve_indices( Container& container, size_t count )
+      {
+         reserve_index( container.template get<N>(), count, 0 );
+         reserve_indices<Container, N + 1>( container, count );
+      }
+   }
    /**
     *  Almost all objects can be tracked and managed via a boost::multi_index container that uses
     *  an unordered_unique key on the object ID.  This template class adapts the generic index interface
@@ -54,6 +78,18 @@ namespace graphene { namespace db {
             return *insert_result.first;
          }
 
+         /// prepares the index for @p count objects loaded by primary_index::open
+         void reserve_for_load( size_t count ) { detail::reserve_indices( _indices, count ); }
+
+         /// inserts an object loaded in id order, the end of the id index is the position hint
+         const object& insert_loaded( ObjectType&& obj )
+         {
+            const auto size = _indices.size();
+            auto itr = _indices.insert( _indices.end(), std::move( obj ) );
+            FC_ASSERT( _indices.size() > size, "Could not insert object, most likely a uniqueness constraint was violated" );
+            return *itr;
+         }
+
          virtual const object&  create(const std::function<void(object&)>& constructor )override
          {
             ObjectType item;
@@ -27,6 +27,7 @@
 #include <fc/io/raw.hpp>
 #include <fc/io/json.hpp>
 #include <fc/crypto/sha256.hpp>
+#include <fc/thread/parallel.hpp>
 
 #include <fstream>
 #include <iostream>
@@ -95,8 +96,9 @@ namespace graphene { namespace db {
 
          /**
           *  Opens the index loading objects from a file
+          *  @return number of loaded objects
           */
-         virtual void open( const fc::path& db ) = 0;
+         virtual uint64_t open( const fc::path& db ) = 0;
          virtual void save( const fc::path& db ) = 0;
 
 
@@ -118,6 +120,18 @@ namespace graphene { namespace db {
          virtual void               modify( const object& obj, const std::function<void(object&)>& ) = 0;
          virtual void               remove( const object& obj ) = 0;
 
+         /**
+          * Removes @p obj without saving undo state and without notifying observers. Only objects which
+          * are not referenced by any pending undo state may be pruned, e.g. irreversible history objects.
+          */
+         virtual void               prune( const object& obj ) { remove( obj ); }
+
+         /**
+          * Modifies @p obj without saving undo state and without notifying observers, e.g. to drop links
+          * to pruned objects. Undoing a state which saved @p obj before restores the old value.
+          */
+         virtual void               modify_without_undo( const object& obj, const std::function<void(object&)>& m ) { modify( obj, m ); }
+
          /**
           *   When forming your lambda to modify obj, it is natural to have Object& be the signature, but
           *   that is not compatible with the type erasue required by the virtual method.  This method
@@ -343,9 +357,14 @@ namespace graphene { namespace db {
             return fc::sha256::hash(desc);
          }
 
-         virtual void open( const path& db )override
-         { 
-            if( !fc::exists( db ) ) return;
+         /**
+          *  The packed objects are decoded straight from the mapped file. Indexes with more than
+          *  load_chunk_size objects are decoded by the worker pool in chunks, then all objects are
+          *  inserted in id order. A truncated or undecodable object ends the index.
+          */
+         virtual uint64_t open( const path& db )override
+         {
+            if( !fc::exists( db ) ) return 0;
             fc::file_mapping fm( db.generic_string().c_str(), fc::read_only );
             fc::mapped_region mr( fm, fc::read_only, 0, fc::file_size(db) );
             fc::datastream<const char*> ds( (const char*)mr.get_address(), mr.get_size() );
@@ -354,14 +373,75 @@ namespace graphene { namespace db {
             fc::raw::unpack(ds, _next_id);
             fc::raw::unpack(ds, open_ver);
             FC_ASSERT( open_ver == get_object_version(), "Incompatible Version, the serialization of objects in this index has changed" );
+
+            // every object is saved as a packed vector<char>, only the position of its data is kept
+            vector< std::pair<const char*, uint32_t> > packed;
             try {
-               vector<char> tmp;
                while( ds.remaining() > 0 )
                {
-                  fc::raw::unpack( ds, tmp );
-                  load( tmp );
+                  fc::unsigned_int size;
+                  fc::raw::unpack( ds, size );
+                  FC_ASSERT( size.value <= ds.remaining() );
+                  packed.emplace_back( ds.pos(), size.value );
+                  ds.skip( size.value );
+               }
+            } catch ( const fc::exception&  ){}
+
+            DerivedIndex::reserve_for_load( packed.size() );
+            const size_t workers = packed.size() > load_chunk_size
+                                   ? std::max<size_t>( fc::asio::default_io_service_scope::get_num_threads(), 1 ) : 1;
+            const size_t batch_size = workers * load_chunk_size;
+            vector<object_type> batch;
+            uint64_t loaded = 0;
+            try {
+               for( size_t begin = 0; begin < packed.size(); begin += batch_size )
+               {
+                  const size_t end = std::min( packed.size(), begin + batch_size );
+                  batch.clear();
+                  batch.resize( end - begin );
+
+                  // returns the position of the first object which can not be decoded, or end
+                  auto decode = [&packed,&batch,begin,end]( size_t first, size_t last ) {
+                     for( size_t i = first; i < last; ++i )
+                     {
+                        try {
+                           fc::datastream<const char*> obj_ds( packed[i].first, packed[i].second );
+                           fc::raw::unpack( obj_ds, batch[i - begin] );
+                        } catch ( const fc::exception& ) {
+                           return i;
+                        }
+                     }
+                     return end;
+                  };
+
+                  size_t valid = end;
+                  if( workers > 1 )
+                  {
+                     vector< fc::future<size_t> > tasks;
+                     tasks.reserve( workers );
+                     for( size_t first = begin; first < end; first += load_chunk_size )
+                     {
+                        const size_t last = std::min( end, first + load_chunk_size );
+                        tasks.push_back( fc::do_parallel( [&decode,first,last] () { return decode( first, last ); } ) );
+                     }
+                     for( auto& task : tasks )
+                        valid = std::min( valid, task.wait() );
+                  }
+                  else
+                     valid = decode( begin, end );
+
+                  for( size_t i = begin; i < valid; ++i )
+                  {
+                     const auto& result = DerivedIndex::insert_loaded( std::move( batch[i - begin] ) );
+                     for( const auto& item : _sindex )
+                        item->object_inserted( result );
+                     ++loaded;
+                  }
+                  if( valid < end )
+                     break;
                }
             } catch ( const fc::exception&  ){}
+            return loaded;
          }
 
          virtual void save( const path& db ) override 
@@ -414,6 +494,22 @@ namespace graphene { namespace db {
             DerivedIndex::remove(obj);
          }
 
+         virtual void  prune( const object& obj ) override
+         {
+            for( const auto& item : _sindex )
+               item->object_removed( obj );
+            DerivedIndex::remove(obj);
+         }
+
+         virtual void  modify_without_undo( const object& obj, const std::function<void(object&)>& m ) override
+         {
+            for( const auto& item : _sindex )
+               item->about_to_modify( obj );
+            DerivedIndex::modify( obj, m );
+            for( const auto& item : _sindex )
+               item->object_modified( obj );
+         }
+
          virtual void modify( const object& obj, const std::function<void(object&)>& m )override
          {
             save_undo( obj );
@@ -449,6 +545,9 @@ namespace graphene { namespace db {
          }
 
       private:
+         /// number of objects decoded by one worker while opening a large index
+         static const size_t load_chunk_size = 20000;
+
          object_id_type                                 _next_id;
          const direct_index< object_type, DirectBits >* _direct_by_id = nullptr;
    };
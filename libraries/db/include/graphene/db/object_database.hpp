@@ -32,6 +32,15 @@
 
 namespace graphene { namespace db {
 
+   /// number of objects and time spent loading one index in object_database::open
+   struct index_load_statistics
+   {
+      uint8_t          space   = 0;
+      uint8_t          type    = 0;
+      uint64_t         objects = 0;
+      fc::microseconds elapsed;
+   };
+
    /**
     *   @class object_database
     *   @brief maintains a set of indexed objects that can be modified with multi-level rollback support
@@ -45,6 +54,8 @@ namespace graphene { namespace db {
          void reset_indexes() { _index.clear(); _index.resize(255); }
 
          void open(const fc::path& data_dir );
+         /// per-index results of the last @ref open, the slowest indexes first
+         const vector<index_load_statistics>& get_load_statistics()const { return _load_statistics; }
 
          /**
           * Saves the complete state of the object_database to disk, this could take a while
@@ -93,6 +104,14 @@ namespace graphene { namespace db {
 
          ///@}
 
+         /// Removes an object bypassing undo history, see @ref index::prune
+         void          prune( const object& obj ) { get_mutable_index(obj.id).prune( obj ); }
+         /// Modifies an object bypassing undo history, see @ref index::modify_without_undo
+         template<typename T, typename Lambda>
+         void modify_without_undo( const T& obj, const Lambda& m ) {
+            get_mutable_index(obj.id).modify_without_undo( obj, [&]( object& o ){ m( static_cast<T&>(o) ); } );
+         }
+
          template<typename T>
          static const T& cast( const object& obj )
          {
@@ -176,8 +195,11 @@ namespace graphene { namespace db {
 
          fc::path                                                  _data_dir;
          vector< vector< unique_ptr<index> > >                     _index;
+         vector< index_load_statistics >                           _load_statistics;
    };
 
 } } // graphene::db
 
+FC_REFLECT( graphene::db::index_load_statistics, (space)(type)(objects)(elapsed) )
+
 
@@ -59,6 +59,10 @@ namespace graphene { namespace db {
             modify_callback( *_objects[obj.id.instance()] );
          }
 
+         /// prepares the index for @p count objects loaded by primary_index::open
+         void reserve_for_load( size_t count ) { _objects.reserve( count ); }
+         const object& insert_loaded( T&& obj ) { return simple_index::insert( std::move( obj ) ); }
+
          virtual const object& insert( object&& obj )override
          {
             auto instance = obj.id.instance();
@@ -113,19 +113,40 @@ void object_database::open(const fc::path& data_dir)
        wlog("Ignoring locked object_database");
        return;
    }
-   std::vector<fc::future<void>> tasks;
-   tasks.reserve(200);
-   ilog("Opening object database from ${d} (WAIT until the process is finished) ...", ("d", data_dir));
+   const auto start = fc::time_point::now();
+   _load_statistics.clear();
    for( uint32_t space = 0; space < _index.size(); ++space )
       for( uint32_t type = 0; type  < _index[space].size(); ++type )
          if( _index[space][type] ) {
-            tasks.push_back( fc::do_parallel( [this,space,type] () {
-            _index[space][type]->open(_data_dir / "object_database" / fc::to_string(space) / fc::to_string(type));
-            }));
+            _load_statistics.emplace_back();
+            _load_statistics.back().space = space;
+            _load_statistics.back().type = type;
          }
+
+   std::vector<fc::future<void>> tasks;
+   tasks.reserve(_load_statistics.size());
+   ilog("Opening object database from ${d} (WAIT until the process is finished) ...", ("d", data_dir));
+   for( auto& stats : _load_statistics )
+      tasks.push_back( fc::do_parallel( [this,&stats] () {
+         const auto index_start = fc::time_point::now();
+         stats.objects = _index[stats.space][stats.type]->open(_data_dir / "object_database" / fc::to_string(stats.space) / fc::to_string(stats.type));
+         stats.elapsed = fc::time_point::now() - index_start;
+      }));
    for( auto& task : tasks )
    task.wait();
-   ilog( "Done opening object database." );
+
+   std::sort( _load_statistics.begin(), _load_statistics.end(),
+              []( const index_load_statistics& a, const index_load_statistics& b ) { return a.elapsed > b.elapsed; } );
+   uint64_t objects = 0;
+   for( const auto& stats : _load_statistics )
+   {
+      objects += stats.objects;
+      if( stats.objects > 0 )
+         ilog( "Loaded ${n} objects of index ${s}.${t} in ${ms} ms",
+               ("n", stats.objects)("s", stats.space)("t", stats.type)("ms", stats.elapsed.count() / 1000) );
+   }
+   ilog( "Done opening object database, ${n} objects in ${ms} ms.",
+         ("n", objects)("ms", (fc::time_point::now() - start).count() / 1000) );
 
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
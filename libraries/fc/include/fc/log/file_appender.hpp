@@ -19,11 +19,33 @@ class file_appender : public appender {
             microseconds                       rotation_interval;
             microseconds                       rotation_limit;
             uint32_t                           max_object_depth = FC_MAX_LOG_OBJECT_DEPTH;
+            /// queue the lines and write them in batches from a background thread, flush is then ignored
+            bool                               async = false;
+            /// lines the queue can hold before the logging threads are made to drop or to wait
+            uint32_t                           queue_size = 8192;
+            /// drop lines which do not fit into a full queue instead of waiting for the writer
+            bool                               drop_when_full = true;
+            /// the writer flushes the file after writing this many bytes...
+            uint32_t                           flush_size = 64 * 1024;
+            /// ...and at least this often while there are unflushed lines
+            microseconds                       flush_interval = seconds( 1 );
          };
+
+         /// counters of the asynchronous mode
+         struct statistics
+         {
+            uint64_t written = 0;
+            uint64_t dropped = 0;
+            uint64_t batches = 0;
+            uint64_t flushes = 0;
+         };
+
          file_appender( const variant& args );
          ~file_appender();
          virtual void log( const log_message& m )override;
 
+         statistics get_statistics()const;
+
       private:
          class impl;
          std::unique_ptr<impl> my;
@@ -32,4 +54,6 @@ class file_appender : public appender {
 
 #include <fc/reflect/reflect.hpp>
 FC_REFLECT( fc::file_appender::config,
-            (format)(filename)(flush)(rotate)(rotation_interval)(rotation_limit)(max_object_depth) )
+            (format)(filename)(flush)(rotate)(rotation_interval)(rotation_limit)(max_object_depth)
+            (async)(queue_size)(drop_when_full)(flush_size)(flush_interval) )
+FC_REFLECT( fc::file_appender::statistics, (written)(dropped)(batches)(flushes) )
@@ -13,8 +13,10 @@
 
 #include <array>
 #include <functional>
+#include <new>
 #include <stdexcept>
 #include <typeinfo>
+#include <utility>
 
 #include <fc/exception/exception.hpp>
 
@@ -23,9 +25,6 @@ namespace fc {
 // Implementation details, the user should not import this:
 namespace impl {
 
-template<int N, typename... Ts>
-struct storage_ops;
-
 template<typename X, typename... Ts>
 struct position;
 
@@ -45,100 +44,6 @@ struct copy_construct
    }
 };
 
-template<typename StaticVariant>
-struct move_construct
-{
-   typedef void result_type;
-   StaticVariant& sv;
-   move_construct( StaticVariant& s ):sv(s){}
-   template<typename T>
-   void operator()( T& v )const
-   {
-      sv.init( std::move(v) );
-   }
-};
-
-template<int N, typename T, typename... Ts>
-struct storage_ops<N, T&, Ts...> {
-    static void del(int n, void *data) {}
-    static void con(int n, void *data) {}
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, void *data, visitor& v) {}
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, void *data, const visitor& v) {}
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, const void *data, visitor& v) {}
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, const void *data, const visitor& v) {}
-};
-
-template<int N, typename T, typename... Ts>
-struct storage_ops<N, T, Ts...> {
-    static void del(int n, void *data) {
-        if(n == N) reinterpret_cast<T*>(data)->~T();
-        else storage_ops<N + 1, Ts...>::del(n, data);
-    }
-    static void con(int n, void *data) {
-        if(n == N) new(reinterpret_cast<T*>(data)) T();
-        else storage_ops<N + 1, Ts...>::con(n, data);
-    }
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, void *data, visitor& v) {
-        if(n == N) return v(*reinterpret_cast<T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
-    }
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, void *data, const visitor& v) {
-        if(n == N) return v(*reinterpret_cast<T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
-    }
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, const void *data, visitor& v) {
-        if(n == N) return v(*reinterpret_cast<const T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
-    }
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, const void *data, const visitor& v) {
-        if(n == N) return v(*reinterpret_cast<const T*>(data));
-        else return storage_ops<N + 1, Ts...>::apply(n, data, v);
-    }
-};
-
-template<int N>
-struct storage_ops<N> {
-    static void del(int n, void *data) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid.");
-    }
-    static void con(int n, void *data) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
-    }
-
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, void *data, visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
-    }
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, void *data, const visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
-    }
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, const void *data, visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
-    }
-    template<typename visitor>
-    static typename visitor::result_type apply(int n, const void *data, const visitor& v) {
-       FC_THROW_EXCEPTION( fc::assert_exception, "Internal error: static_variant tag is invalid." );
-    }
-};
-
 template<typename X>
 struct position<X> {
     static constexpr int pos = -1;
@@ -178,73 +83,91 @@ struct type_info<> {
     static constexpr size_t size = 0;
 };
 
-template<typename TTag>
-constexpr size_t size( TTag )
-{
-    return 0;
-}
+template<typename... Ts>
+struct max_alignment;
 
-template<typename TTag, typename A, typename...Ts>
-constexpr size_t size( TTag tag )
-{
-    return tag <= 0 ? sizeof(A) : size<TTag, Ts...>( --tag );
-}
+template<>
+struct max_alignment<> {
+    static constexpr size_t value = alignof(void*);
+};
 
+template<typename T, typename... Ts>
+struct max_alignment<T, Ts...> {
+    static constexpr size_t value = alignof(T) > max_alignment<Ts...>::value ? alignof(T) : max_alignment<Ts...>::value;
+};
 
-class dynamic_storage
+/**
+ * Storage of a static_variant value. Alternatives which fit into the inline buffer are kept
+ * in place, larger ones are allocated on the heap and the buffer holds the pointer.
+ */
+template<size_t Size, size_t Align>
+class inline_storage
 {
-    char* storage;
-public:
-    dynamic_storage();
+    alignas(Align) char _buf[Size];
 
-    ~dynamic_storage();
+    template<typename T>
+    using fits = std::integral_constant<bool, sizeof(T) <= Size && alignof(T) <= Align>;
 
-    void* data() const;
+    template<typename T>
+    T* get( std::true_type ) { return reinterpret_cast<T*>(_buf); }
+    template<typename T>
+    T* get( std::false_type ) { return *reinterpret_cast<T**>(_buf); }
+    template<typename T>
+    const T* get( std::true_type ) const { return reinterpret_cast<const T*>(_buf); }
+    template<typename T>
+    const T* get( std::false_type ) const { return *reinterpret_cast<T* const*>(_buf); }
 
-    void alloc( size_t size );
+    template<typename T, typename... Args>
+    void construct( std::true_type, Args&&... args ) { new(_buf) T( std::forward<Args>(args)... ); }
+    template<typename T, typename... Args>
+    void construct( std::false_type, Args&&... args ) { *reinterpret_cast<T**>(_buf) = new T( std::forward<Args>(args)... ); }
 
-    void release();
-};
+    template<typename T>
+    void destroy( std::true_type ) { reinterpret_cast<T*>(_buf)->~T(); }
+    template<typename T>
+    void destroy( std::false_type ) { delete *reinterpret_cast<T**>(_buf); }
+public:
+    template<typename T>
+    T* get() { return get<T>( fits<T>() ); }
+    template<typename T>
+    const T* get() const { return get<T>( fits<T>() ); }
 
+    template<typename T, typename... Args>
+    void construct( Args&&... args ) { construct<T>( fits<T>(), std::forward<Args>(args)... ); }
 
+    template<typename T>
+    void destroy() { destroy<T>( fits<T>() ); }
+};
 
-} // namespace impl
+/**
+ * Type erased operations on the storage, static_variant keeps a table of them indexed by tag
+ */
+template<typename Storage, typename T>
+struct storage_ops {
+    static void default_construct( Storage& s ) { s.template construct<T>(); }
+    static void copy_construct( Storage& s, const Storage& from ) { s.template construct<T>( *from.template get<T>() ); }
+    static void move_construct( Storage& s, Storage& from ) { s.template construct<T>( std::move( *from.template get<T>() ) ); }
+    static void destroy( Storage& s ) { s.template destroy<T>(); }
+    static void* data( Storage& s ) { return s.template get<T>(); }
+    static const void* const_data( const Storage& s ) { return s.template get<T>(); }
+};
 
-template<int L,typename Visitor,typename Data>
-static const std::array<typename Visitor::result_type(*)(Visitor&,Data),L>
-      init_wrappers( Visitor& v, Data d, typename Visitor::result_type(**funcs)(Visitor&,Data) = 0)
-{
-   return std::array<typename Visitor::result_type(*)(Visitor&,Data),L>();
-}
+template<typename Result, typename Visitor, typename Data, typename T>
+struct visit_op {
+    static Result invoke( Visitor& v, Data d ) { return v( *reinterpret_cast<T*>( d ) ); }
+};
 
-template<int L,typename Visitor,typename Data,typename T, typename ... Types>
-static const std::array<typename Visitor::result_type(*)(Visitor&,Data),L>
-      init_wrappers( Visitor& v, Data d, typename Visitor::result_type(**funcs)(Visitor&,Data) = 0 )
-{
-   std::array<typename Visitor::result_type(*)(Visitor&,Data),L> result{};
-   if( !funcs ) funcs = result.data();
-   *funcs++ = [] ( Visitor& v, Data d ) { return v( *reinterpret_cast<T*>( d ) ); };
-   init_wrappers<L,Visitor,Data,Types...>( v, d, funcs );
-   return result;
-}
-
-template<int L,typename Visitor,typename Data>
-static const std::array<typename Visitor::result_type(*)(Visitor&,Data),L>
-      init_const_wrappers( Visitor& v, Data d, typename Visitor::result_type(**funcs)(Visitor&,Data) = 0 )
-{
-   return std::array<typename Visitor::result_type(*)(Visitor&,Data),L>();
-}
+template<typename Result, typename Visitor, typename Data, typename T>
+struct const_visit_op {
+    static Result invoke( Visitor& v, Data d ) { return v( *reinterpret_cast<const T*>( d ) ); }
+};
 
-template<int L,typename Visitor,typename Data,typename T, typename ... Types>
-static const std::array<typename Visitor::result_type(*)(Visitor&,Data),L>
-      init_const_wrappers( Visitor& v, Data d, typename Visitor::result_type(**funcs)(Visitor&,Data) = 0 )
-{
-   std::array<typename Visitor::result_type(*)(Visitor&,Data),L> result{};
-   if( !funcs ) funcs = result.data();
-   *funcs++ = [] ( Visitor& v, Data d ) { return v( *reinterpret_cast<const T*>( d ) ); };
-   init_const_wrappers<L,Visitor,Data,Types...>( v, d, funcs );
-   return result;
-}
+} // namespace impl
+
+#ifndef FC_STATIC_VARIANT_MAX_INLINE_SIZE
+/// alternatives larger than this many bytes are stored on the heap
+#define FC_STATIC_VARIANT_MAX_INLINE_SIZE 256
+#endif
 
 template<typename... Types>
 class static_variant {
@@ -258,43 +181,83 @@ protected:
     template<typename X>
     using type_in_typelist = typename std::enable_if<impl::position<X, Types...>::pos != -1, X>::type; // type is in typelist of static_variant.
 
+    static constexpr size_t inline_size = impl::type_info<Types...>::size < FC_STATIC_VARIANT_MAX_INLINE_SIZE
+                                          ? impl::type_info<Types...>::size : FC_STATIC_VARIANT_MAX_INLINE_SIZE;
+    using storage_type = impl::inline_storage< (inline_size > sizeof(void*) ? inline_size : sizeof(void*)),
+                                               impl::max_alignment<Types...>::value >;
+
     tag_type _tag;
-    impl::dynamic_storage storage;
+    storage_type storage;
 
     template<typename X, typename = type_in_typelist<X>>
     void init(const X& x) {
+        storage.template construct<X>(x);
         _tag = impl::position<X, Types...>::pos;
-        storage.alloc( sizeof(X) );
-        new(storage.data()) X(x);
     }
 
     template<typename X, typename = type_in_typelist<X>>
     void init(X&& x) {
+        storage.template construct<X>( std::move(x) );
         _tag = impl::position<X, Types...>::pos;
-        storage.alloc( sizeof(X) );
-        new(storage.data()) X( std::move(x) );
     }
 
     void init_from_tag(tag_type tag)
     {
         FC_ASSERT( tag >= 0 );
         FC_ASSERT( tag < count() );
+        static const std::array<void(*)(storage_type&), sizeof...(Types)> ops =
+           { &impl::storage_ops<storage_type, Types>::default_construct... };
+        ops[tag]( storage );
         _tag = tag;
-        storage.alloc( impl::size<tag_type, Types...>( tag ) );
-        impl::storage_ops<0, Types...>::con(_tag, storage.data());
     }
 
+    void copy_from( const static_variant& cpy )
+    {
+        if( cpy._tag < 0 ) { _tag = -1; return; }
+        static const std::array<void(*)(storage_type&, const storage_type&), sizeof...(Types)> ops =
+           { &impl::storage_ops<storage_type, Types>::copy_construct... };
+        ops[cpy._tag]( storage, cpy.storage );
+        _tag = cpy._tag;
+    }
+
+    void move_from( static_variant& mv )
+    {
+        if( mv._tag < 0 ) { _tag = -1; return; }
+        static const std::array<void(*)(storage_type&, storage_type&), sizeof...(Types)> ops =
+           { &impl::storage_ops<storage_type, Types>::move_construct... };
+        ops[mv._tag]( storage, mv.storage );
+        _tag = mv._tag;
+    }
+
+    /// destroys the value and leaves the variant empty, so that a throwing copy or move into it
+    /// afterwards does not destroy the old value a second time
     void clean()
     {
-        impl::storage_ops<0, Types...>::del(_tag, storage.data() );
-        storage.release();
+        if( _tag < 0 ) return;
+        static const std::array<void(*)(storage_type&), sizeof...(Types)> ops =
+           { &impl::storage_ops<storage_type, Types>::destroy... };
+        ops[_tag]( storage );
+        _tag = -1;
     }
 
+    void* data()
+    {
+        if( _tag < 0 ) return nullptr;
+        static const std::array<void*(*)(storage_type&), sizeof...(Types)> ops =
+           { &impl::storage_ops<storage_type, Types>::data... };
+        return ops[_tag]( storage );
+    }
+
+    const void* data()const
+    {
+        if( _tag < 0 ) return nullptr;
+        static const std::array<const void*(*)(const storage_type&), sizeof...(Types)> ops =
+           { &impl::storage_ops<storage_type, Types>::const_data... };
+        return ops[_tag]( storage );
+    }
 
     template<typename StaticVariant>
     friend struct impl::copy_construct;
-    template<typename StaticVariant>
-    friend struct impl::move_construct;
 public:
     template<typename X, typename = type_in_typelist<X>>
     struct tag
@@ -315,12 +278,12 @@ public:
 
     static_variant( const static_variant& cpy )
     {
-       cpy.visit( impl::copy_construct<static_variant>(*this) );
+       copy_from( cpy );
     }
 
     static_variant( static_variant&& mv )
     {
-       mv.visit( impl::move_construct<static_variant>(*this) );
+       move_from( mv );
     }
 
     template<typename X, typename = type_in_typelist<X>>
@@ -342,14 +305,14 @@ public:
     {
        if( this == &v ) return *this;
        clean();
-       v.visit( impl::copy_construct<static_variant>(*this) );
+       copy_from( v );
        return *this;
     }
     static_variant& operator=( static_variant&& v )
     {
        if( this == &v ) return *this;
        clean();
-       v.visit( impl::move_construct<static_variant>(*this) );
+       move_from( v );
        return *this;
     }
     friend bool operator == ( const static_variant& a, const static_variant& b )
@@ -364,7 +327,7 @@ public:
     template<typename X, typename = type_in_typelist<X>>
     X& get() {
         if(_tag == impl::position<X, Types...>::pos) {
-            return *reinterpret_cast<X*>(storage.data());
+            return *storage.template get<X>();
         } else {
             FC_THROW_EXCEPTION( fc::assert_exception, "static_variant does not contain a value of type ${t}", ("t",fc::get_typename<X>::name()) );
         }
@@ -372,35 +335,37 @@ public:
     template<typename X, typename = type_in_typelist<X>>
     const X& get() const {
         if(_tag == impl::position<X, Types...>::pos) {
-            return *reinterpret_cast<const X*>(storage.data());
+            return *storage.template get<X>();
         } else {
             FC_THROW_EXCEPTION( fc::assert_exception, "static_variant does not contain a value of type ${t}", ("t",fc::get_typename<X>::name()) );
         }
     }
     template<typename visitor>
     typename visitor::result_type visit(visitor& v) {
-        return visit( _tag, v, (void*) storage.data() );
+        return visit( _tag, v, data() );
     }
 
     template<typename visitor>
     typename visitor::result_type visit(const visitor& v) {
-        return visit( _tag, v, (void*) storage.data() );
+        return visit( _tag, v, data() );
     }
 
     template<typename visitor>
     typename visitor::result_type visit(visitor& v)const {
-        return visit( _tag, v, (const void*) storage.data() );
+        return visit( _tag, v, data() );
     }
 
     template<typename visitor>
     typename visitor::result_type visit(const visitor& v)const {
-        return visit( _tag, v, (const void*) storage.data() );
+        return visit( _tag, v, data() );
     }
 
     template<typename visitor>
     static typename visitor::result_type visit( tag_type tag, visitor& v, void* data )
     {
-        static const auto wrappers = init_wrappers<impl::type_info<Types...>::count,visitor,void*,Types...>( v, data );
+        using result_type = typename visitor::result_type;
+        static const std::array<result_type(*)(visitor&,void*), sizeof...(Types)> wrappers =
+           { &impl::visit_op<result_type,visitor,void*,Types>::invoke... };
         FC_ASSERT( tag >= 0 && tag < count(), "Unsupported type ${tag}!", ("tag",tag) );
         return wrappers[tag]( v, data );
     }
@@ -408,7 +373,9 @@ public:
     template<typename visitor>
     static typename visitor::result_type visit( tag_type tag, const visitor& v, void* data )
     {
-        static const auto wrappers = init_wrappers<impl::type_info<Types...>::count,const visitor,void*,Types...>( v, data );
+        using result_type = typename visitor::result_type;
+        static const std::array<result_type(*)(const visitor&,void*), sizeof...(Types)> wrappers =
+           { &impl::visit_op<result_type,const visitor,void*,Types>::invoke... };
         FC_ASSERT( tag >= 0 && tag < count(), "Unsupported type ${tag}!", ("tag",tag) );
         return wrappers[tag]( v, data );
     }
@@ -416,7 +383,9 @@ public:
     template<typename visitor>
     static typename visitor::result_type visit( tag_type tag, visitor& v, const void* data )
     {
-        static const auto wrappers = init_const_wrappers<impl::type_info<Types...>::count,visitor,const void*,Types...>( v, data );
+        using result_type = typename visitor::result_type;
+        static const std::array<result_type(*)(visitor&,const void*), sizeof...(Types)> wrappers =
+           { &impl::const_visit_op<result_type,visitor,const void*,Types>::invoke... };
         FC_ASSERT( tag >= 0 && tag < count(), "Unsupported type ${tag}!", ("tag",tag) );
         return wrappers[tag]( v, data );
     }
@@ -424,7 +393,9 @@ public:
     template<typename visitor>
     static typename visitor::result_type visit( tag_type tag, const visitor& v, const void* data )
     {
-        static const auto wrappers = init_const_wrappers<impl::type_info<Types...>::count,const visitor,const void*,Types...>( v, data );
+        using result_type = typename visitor::result_type;
+        static const std::array<result_type(*)(const visitor&,const void*), sizeof...(Types)> wrappers =
+           { &impl::const_visit_op<result_type,const visitor,const void*,Types>::invoke... };
         FC_ASSERT( tag >= 0 && tag < count(), "Unsupported type ${tag}!", ("tag",tag) );
         return wrappers[tag]( v, data );
     }
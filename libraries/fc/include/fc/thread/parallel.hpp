@@ -30,16 +30,28 @@
 
 #include <boost/atomic/atomic.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <vector>
+
 namespace fc {
 
    namespace detail {
       class pool_impl;
 
+      /**
+       * A pool of worker threads with one task deque per worker. Idle workers steal tasks from
+       * the other workers' deques.
+       */
       class worker_pool {
       public:
          worker_pool();
          ~worker_pool();
          void post( task_base* task );
+         /** Queues all tasks at once and wakes up as many idle workers as there are tasks */
+         void post( const std::vector<task_base*>& tasks );
+         /** @return number of worker threads */
+         uint16_t size()const;
       private:
           pool_impl*    my;
       };
@@ -104,4 +116,62 @@ namespace fc {
       detail::get_worker_pool().post( tsk.get() );
       return r;
    }
+
+   /**
+    * Calls @p f( i ) for every i in [begin, end) on the worker pool, in chunks of @p grain indexes.
+    * By default the range is split into four chunks per worker. Returns when all chunks are done,
+    * the first exception thrown by a chunk is rethrown then.
+    *
+    * The chunks run concurrently, so @p f must only read shared state, e.g. the chain state outside
+    * of block application, and write to memory owned by index i.
+    */
+   template<typename Functor>
+   void parallel_for( size_t begin, size_t end, const Functor& f, size_t grain = 0 )
+   {
+      if( begin >= end )
+         return;
+      if( grain == 0 )
+         grain = std::max<size_t>( ( end - begin ) / ( 4 * detail::get_worker_pool().size() ), 1 );
+      if( end - begin <= grain )
+      {
+         for( size_t i = begin; i < end; ++i )
+            f( i );
+         return;
+      }
+
+      auto make_task = [&f]( size_t first, size_t last ) {
+         return [&f,first,last] () {
+            for( size_t i = first; i < last; ++i )
+               f( i );
+         };
+      };
+      typedef decltype( make_task( 0, 0 ) ) ChunkType;
+
+      std::vector<fc::future<void>> results;
+      std::vector<task_base*> tasks;
+      results.reserve( ( end - begin ) / grain + 1 );
+      tasks.reserve( results.capacity() );
+      for( size_t first = begin; first < end; first += grain )
+      {
+         typename task<void,sizeof(ChunkType)>::ptr tsk =
+            task<void,sizeof(ChunkType)>::create( make_task( first, std::min( end, first + grain ) ), "parallel_for" );
+         tsk->retain(); // released when the task has run, see do_parallel
+         results.emplace_back( std::dynamic_pointer_cast< promise<void> >( tsk ) );
+         tasks.push_back( tsk.get() );
+      }
+      detail::get_worker_pool().post( tasks );
+
+      std::exception_ptr error;
+      for( auto& result : results )
+      {
+         try {
+            result.wait();
+         } catch( ... ) {
+            if( !error )
+               error = std::current_exception();
+         }
+      }
+      if( error )
+         std::rethrow_exception( error );
+   }
 }
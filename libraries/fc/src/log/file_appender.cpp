@@ -5,11 +5,16 @@
 #include <fc/thread/scoped_lock.hpp>
 #include <fc/thread/thread.hpp>
 #include <fc/variant.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
+#include <atomic>
+#include <chrono>
 #include <iomanip>
 #include <queue>
 #include <sstream>
 #include <iostream>
+#include <thread>
 
 namespace fc {
 
@@ -20,7 +25,20 @@ namespace fc {
          ofstream                   out;
          boost::mutex               slock;
 
+         /// lines handed from the logging threads to the writer in async mode
+         std::unique_ptr< boost::lockfree::queue<std::string*> > lines;
+         std::atomic<uint64_t>      written{0};
+         std::atomic<uint64_t>      dropped{0};
+         std::atomic<uint64_t>      batches{0};
+         std::atomic<uint64_t>      flushes{0};
+
       private:
+         std::thread                _writer;
+         std::atomic<bool>          _stopping{false};
+         /// set while the writer sleeps, the producers only take _wake_lock to wake it up
+         std::atomic<bool>          _sleeping{false};
+         boost::mutex               _wake_lock;
+         boost::condition_variable  _wake;
          future<void>               _rotation_task;
          time_point_sec             _current_file_start_time;
 
@@ -52,10 +70,24 @@ namespace fc {
             {
                std::cerr << "error opening log file: " << cfg.filename.preferred_string() << "\n";
             }
+
+            if( cfg.async )
+            {
+               FC_ASSERT( cfg.queue_size > 0 && cfg.queue_size < 65535, "queue_size must be in [1, 65534]" );
+               FC_ASSERT( cfg.flush_interval > microseconds() );
+               lines.reset( new boost::lockfree::queue<std::string*>( cfg.queue_size ) );
+               _writer = std::thread( [this]() { write_lines(); } );
+            }
          }
 
          ~impl()
          {
+            if( _writer.joinable() )
+            {
+               _stopping = true;
+               wake_writer();
+               _writer.join();
+            }
             try
             {
               _rotation_task.cancel_and_wait("file_appender is destructing");
@@ -65,6 +97,86 @@ namespace fc {
             }
          }
 
+         /// called by the logging threads in async mode, never blocks unless drop_when_full is off
+         void enqueue( std::string&& line )
+         {
+            std::string* l = new std::string( std::move( line ) );
+            while( !lines->bounded_push( l ) )
+            {
+               if( cfg.drop_when_full )
+               {
+                  ++dropped;
+                  delete l;
+                  return;
+               }
+               wake_writer();
+               std::this_thread::yield();
+            }
+            if( _sleeping )
+               wake_writer();
+         }
+
+         void wake_writer()
+         {
+            boost::unique_lock<boost::mutex> lock( _wake_lock );
+            _wake.notify_one();
+         }
+
+         /// the writer thread: drains the queue in batches and applies the flush policy
+         void write_lines()
+         {
+            const auto interval = std::chrono::microseconds( cfg.flush_interval.count() );
+            auto last_flush = std::chrono::steady_clock::now();
+            uint64_t unflushed = 0;
+            uint64_t reported_drops = 0;
+            for( ;; )
+            {
+               const bool stopping = _stopping;
+               uint64_t count = 0;
+               {
+                  fc::scoped_lock<boost::mutex> lock( slock );
+                  std::string* l;
+                  while( lines->pop( l ) )
+                  {
+                     out << *l;
+                     unflushed += l->size();
+                     delete l;
+                     ++count;
+                  }
+                  const uint64_t drops = dropped;
+                  if( drops != reported_drops )
+                  {
+                     out << string( time_point::now() ) << " " << ( drops - reported_drops )
+                         << " log lines were dropped by the full queue\n";
+                     reported_drops = drops;
+                     unflushed += 1;
+                  }
+                  const auto now = std::chrono::steady_clock::now();
+                  if( unflushed >= cfg.flush_size || ( unflushed > 0 && ( now - last_flush >= interval || stopping ) ) )
+                  {
+                     out.flush();
+                     unflushed = 0;
+                     last_flush = now;
+                     ++flushes;
+                  }
+               }
+               if( count > 0 )
+               {
+                  written += count;
+                  ++batches;
+                  continue;
+               }
+               if( stopping )
+                  return;
+
+               boost::unique_lock<boost::mutex> lock( _wake_lock );
+               _sleeping = true;
+               if( lines->empty() && !_stopping )
+                  _wake.wait_for( lock, boost::chrono::microseconds( cfg.flush_interval.count() ) );
+               _sleeping = false;
+            }
+         }
+
          void rotate_files( bool initializing = false )
          {
              FC_ASSERT( cfg.rotate );
@@ -148,6 +260,16 @@ namespace fc {
 
    file_appender::~file_appender(){}
 
+   file_appender::statistics file_appender::get_statistics()const
+   {
+      statistics s;
+      s.written = my->written;
+      s.dropped = my->dropped;
+      s.batches = my->batches;
+      s.flushes = my->flushes;
+      return s;
+   }
+
    // MS THREAD METHOD  MESSAGE \t\t\t File:Line
    void file_appender::log( const log_message& m )
    {
@@ -174,10 +296,17 @@ namespace fc {
       line << "] ";
       std::string message = fc::format_string( m.get_format(), m.get_data(), my->cfg.max_object_depth );
       line << message.c_str();
+      line << "\t\t\t" << m.get_context().get_file() << ":" << m.get_context().get_line_number() << "\n";
+
+      if( my->lines )
+      {
+        my->enqueue( line.str() );
+        return;
+      }
 
       {
         fc::scoped_lock<boost::mutex> lock( my->slock );
-        my->out << line.str() << "\t\t\t" << m.get_context().get_file() << ":" << m.get_context().get_line_number() << "\n";
+        my->out << line.str();
         if( my->cfg.flush )
           my->out.flush();
       }
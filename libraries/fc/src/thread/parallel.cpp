@@ -23,111 +23,195 @@
  */
 
 #include <fc/thread/parallel.hpp>
-#include <fc/thread/spin_yield_lock.hpp>
+#include <fc/thread/spin_lock.hpp>
 #include <fc/thread/unique_lock.hpp>
 #include <fc/asio.hpp>
 
 #include <boost/atomic/atomic.hpp>
-#include <boost/lockfree/queue.hpp>
+
+#include <deque>
+#include <memory>
 
 namespace fc {
    namespace detail {
-      class idle_notifier_impl : public thread_idle_notifier
+      /**
+       * A pool thread with its own task deque. The worker takes new work from the back of its
+       * own deque and steals from the front of the other workers' deques. The last task of a
+       * deque is only stolen while its owner is busy, a woken or idle owner runs it itself.
+       */
+      class worker_impl : public thread_idle_notifier
       {
       public:
-         idle_notifier_impl()
-         {
-            is_idle.store(false);
-         }
+         enum worker_state { busy_state, idle_state, waking_state };
 
-         idle_notifier_impl( const idle_notifier_impl& copy )
+         worker_impl( uint32_t i, pool_impl* pool ) : id( i ), my_pool( pool )
          {
-            id = copy.id;
-            my_pool = copy.my_pool;
-            is_idle.store( copy.is_idle.load() );
+            state.store( busy_state );
          }
 
-         virtual ~idle_notifier_impl() {}
+         virtual ~worker_impl() {}
 
          virtual task_base* idle();
          virtual void       busy()
          {
-            is_idle.store(false);
+            state.store( busy_state );
+         }
+
+         void push( task_base* task )
+         {
+            fc::unique_lock<fc::spin_lock> lock( queue_lock );
+            queue.push_back( task );
+         }
+
+         task_base* pop_back()
+         {
+            fc::unique_lock<fc::spin_lock> lock( queue_lock );
+            if( queue.empty() )
+               return nullptr;
+            task_base* task = queue.back();
+            queue.pop_back();
+            return task;
+         }
+
+         task_base* steal( bool leave_last = false )
+         {
+            fc::unique_lock<fc::spin_lock> lock( queue_lock );
+            if( queue.empty() || ( leave_last && queue.size() == 1 ) )
+               return nullptr;
+            task_base* task = queue.front();
+            queue.pop_front();
+            return task;
          }
 
-         uint32_t            id;
-         pool_impl*          my_pool;
-         boost::atomic<bool> is_idle;
+         const uint32_t          id;
+         pool_impl* const        my_pool;
+         boost::atomic<int>      state;
+         fc::spin_lock           queue_lock;
+         std::deque<task_base*>  queue;
       };
 
+      /// the pool worker running on the current thread, if any
+      static thread_local worker_impl* current_worker = nullptr;
+
       class pool_impl
       {
       public:
          explicit pool_impl( const uint16_t num_threads )
-            : idle_threads( 2 * num_threads ), waiting_tasks( 200 )
          {
-            notifiers.resize( num_threads );
+            next_queue.store( 0 );
+            last_idle.store( 0 );
+            // a started worker looks into all deques, so they must exist before the first thread starts
+            workers.reserve( num_threads );
+            for( uint32_t i = 0; i < num_threads; i++ )
+               workers.emplace_back( new worker_impl( i, this ) );
             threads.reserve( num_threads );
             for( uint32_t i = 0; i < num_threads; i++ )
-            {
-               notifiers[i].id = i;
-               notifiers[i].my_pool = this;
-               threads.push_back( new thread( "pool worker " + fc::to_string(i), &notifiers[i] ) );
-            }
+               threads.push_back( new thread( "pool worker " + fc::to_string(i), workers[i].get() ) );
          }
          ~pool_impl()
          {
             for( thread* t : threads)
                delete t; // also calls quit()
-            waiting_tasks.consume_all( [] ( task_base* t ) {
-               t->cancel( "thread pool quitting" );
-            });
+            for( auto& w : workers )
+               while( task_base* t = w->steal() )
+                  t->cancel( "thread pool quitting" );
          }
 
-         thread* post( task_base* task )
+         /**
+          * Tasks posted by a pool worker go to its own deque. Other tasks go to the worker which
+          * became idle last, because its caches are the warmest, or else are spread over the
+          * workers. An idle worker is woken up to run or steal the new task.
+          */
+         void post( task_base* task )
          {
-            idle_notifier_impl* ini;
-            while( idle_threads.pop( ini ) )
-               if( ini->is_idle.exchange( false ) )
-               { // minor race condition here, a thread might receive a task while it's busy
-                  return threads[ini->id];
-               }
-            boost::unique_lock<fc::spin_yield_lock> lock(pool_lock);
-            while( idle_threads.pop( ini ) )
-               if( ini->is_idle.exchange( false ) )
-               { // minor race condition here, a thread might receive a task while it's busy
-                  return threads[ini->id];
-               }
-            while( !waiting_tasks.push( task ) )
-               elog( "Worker pool internal error" );
-            return 0;
+            worker_impl* target = own_worker();
+            if( !target )
+            {
+               target = workers[last_idle.load()].get();
+               if( target->state.load() != worker_impl::idle_state )
+                  target = workers[next_queue.fetch_add( 1 ) % workers.size()].get();
+            }
+            target->push( task );
+            wake( *target );
          }
 
-         task_base* enqueue_idle_thread( idle_notifier_impl* ini )
+         /// every worker receives a contiguous run of the tasks, so that neighbouring tasks stay together
+         void post( const std::vector<task_base*>& tasks )
          {
-            task_base* task;
-            if( waiting_tasks.pop( task ) )
-               return task;
-            fc::unique_lock<fc::spin_yield_lock> lock(pool_lock);
-            if( waiting_tasks.pop( task ) )
+            if( tasks.empty() )
+               return;
+            const size_t first = next_queue.fetch_add( 1 );
+            const size_t per_worker = ( tasks.size() + workers.size() - 1 ) / workers.size();
+            for( size_t i = 0; i < tasks.size(); ++i )
+            {
+               worker_impl& target = *workers[( first + i / per_worker ) % workers.size()];
+               target.push( tasks[i] );
+            }
+            for( size_t i = 0; i < tasks.size(); i += per_worker )
+               wake( *workers[( first + i / per_worker ) % workers.size()] );
+         }
+
+         /// @return a task from the back of the worker's own deque, or stolen from another deque
+         task_base* take( const worker_impl& worker )
+         {
+            if( task_base* task = workers[worker.id]->pop_back() )
                return task;
-            while( !idle_threads.push( ini ) )
-               elog( "Worker pool internal error" );
-            return 0;
+            for( size_t i = 1; i < workers.size(); ++i )
+            {
+               worker_impl& victim = *workers[( worker.id + i ) % workers.size()];
+               if( task_base* task = victim.steal( victim.state.load() != worker_impl::busy_state ) )
+                  return task;
+            }
+            return nullptr;
          }
+
+         void went_idle( const worker_impl& worker ) { last_idle.store( worker.id ); }
+
+         uint16_t size()const { return workers.size(); }
+
       private:
-         std::vector<idle_notifier_impl>                notifiers;
+         worker_impl* own_worker()const
+         {
+            return current_worker && current_worker->my_pool == this ? current_worker : nullptr;
+         }
+
+         /**
+          * A worker announces that it is idle before it looks for work, and tasks are queued before
+          * the owner of their deque is checked, so either the owner finds the task or it is woken
+          * up here. A busy owner gets help from another idle worker, which may steal the task.
+          */
+         void wake( worker_impl& owner )
+         {
+            if( try_wake( owner ) )
+               return;
+            const size_t first = next_queue.load();
+            for( size_t i = 0; i < workers.size(); ++i )
+               if( try_wake( *workers[( first + i ) % workers.size()] ) )
+                  return;
+         }
+
+         bool try_wake( worker_impl& w )
+         {
+            int expected = worker_impl::idle_state;
+            if( !w.state.compare_exchange_strong( expected, worker_impl::waking_state ) )
+               return false;
+            threads[w.id]->poke();
+            return true;
+         }
+
+         std::vector<std::unique_ptr<worker_impl>>      workers;
          std::vector<thread*>                           threads;
-         boost::lockfree::queue<idle_notifier_impl*>    idle_threads;
-         boost::lockfree::queue<task_base*>             waiting_tasks;
-         fc::spin_yield_lock                            pool_lock;
+         boost::atomic<size_t>                          next_queue;
+         boost::atomic<uint32_t>                        last_idle;
       };
 
-      task_base* idle_notifier_impl::idle()
+      task_base* worker_impl::idle()
       {
-         is_idle.store( true );
-         task_base* result = my_pool->enqueue_idle_thread( this );
-         if( result ) is_idle.store( false );
+         current_worker = this;
+         state.store( idle_state );
+         my_pool->went_idle( *this );
+         task_base* result = my_pool->take( *this );
+         if( result ) state.store( busy_state );
          return result;
       }
 
@@ -144,9 +228,17 @@ namespace fc {
 
       void worker_pool::post( task_base* task )
       {
-         thread* worker = my->post( task );
-         if( worker )
-             worker->async_task( task, priority() );
+         my->post( task );
+      }
+
+      void worker_pool::post( const std::vector<task_base*>& tasks )
+      {
+         my->post( tasks );
+      }
+
+      uint16_t worker_pool::size()const
+      {
+         return my->size();
       }
 
       worker_pool& get_worker_pool()
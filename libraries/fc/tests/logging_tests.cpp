@@ -13,6 +13,7 @@
 #include <fc/io/json.hpp>
 #include <fc/io/fstream.hpp>
 
+#include <algorithm>
 #include <thread>
 #include <iostream>
 #include <fstream>
@@ -69,4 +70,80 @@ BOOST_AUTO_TEST_CASE(log_reboot)
     BOOST_TEST_MESSAGE("Loop complete");
 }
 
+BOOST_AUTO_TEST_CASE(async_log_keeps_every_line)
+{
+    fc::file_appender::config conf;
+    conf.filename = "/tmp/my_async.log";
+    conf.async = true;
+    conf.queue_size = 64;
+    conf.drop_when_full = false;
+    fc::remove_all( conf.filename );
+
+    const int threads = 4;
+    const int lines_per_thread = 2000;
+    {
+        // not registered by name, so the appender is destroyed with the scope
+        auto fa = std::make_shared<fc::file_appender>( fc::variant(conf, 200) );
+        std::vector<std::thread> loggers;
+        for( int t = 0; t < threads; ++t )
+            loggers.emplace_back( [&fa,t,lines_per_thread]() {
+                for( int i = 0; i < lines_per_thread; ++i )
+                {
+                    fc::log_context ctx(fc::log_level::all, "my_file.cpp", t * lines_per_thread + i, "my_method()");
+                    fa->log( fc::log_message( ctx, "${message}", {"message","This is a test"} ) );
+                }
+            } );
+        for( auto& l : loggers )
+            l.join();
+
+        // the writer drains the queue before the appender goes away
+        BOOST_CHECK_EQUAL( fa->get_statistics().dropped, 0u );
+        fa.reset();
+    }
+
+    std::string rez;
+    fc::read_file_contents(conf.filename, rez);
+    BOOST_CHECK_EQUAL( std::count( rez.begin(), rez.end(), '\n' ), threads * lines_per_thread );
+    for( int i = 0; i < threads * lines_per_thread; i += 997 )
+        BOOST_CHECK( rez.find("my_file.cpp:" + std::to_string(i) + "\n") != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE(async_log_counts_dropped_lines)
+{
+    fc::file_appender::config conf;
+    conf.filename = "/tmp/my_async_drop.log";
+    conf.async = true;
+    conf.queue_size = 8;
+    conf.drop_when_full = true;
+    fc::remove_all( conf.filename );
+
+    const uint64_t total = 5000;
+    auto fa = std::make_shared<fc::file_appender>( fc::variant(conf, 200) );
+    for( uint64_t i = 0; i < total; ++i )
+    {
+        fc::log_context ctx(fc::log_level::all, "my_file.cpp", i, "my_method()");
+        fa->log( fc::log_message( ctx, "${message}", {"message","This is a test"} ) );
+    }
+
+    fc::time_point deadline = fc::time_point::now() + fc::seconds(10);
+    auto stats = fa->get_statistics();
+    while( stats.written + stats.dropped < total && fc::time_point::now() < deadline )
+    {
+        fc::usleep(fc::milliseconds(10));
+        stats = fa->get_statistics();
+    }
+    BOOST_CHECK_EQUAL( stats.written + stats.dropped, total );
+    BOOST_CHECK_GE( stats.batches, 1u );
+    fa.reset();
+
+    std::string rez;
+    fc::read_file_contents(conf.filename, rez);
+    uint64_t lines = 0;
+    for( size_t pos = rez.find("my_file.cpp:"); pos != std::string::npos; pos = rez.find("my_file.cpp:", pos + 1) )
+        ++lines;
+    BOOST_CHECK_EQUAL( lines, stats.written );
+    if( stats.dropped > 0 )
+        BOOST_CHECK( rez.find(" log lines were dropped by the full queue") != std::string::npos );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
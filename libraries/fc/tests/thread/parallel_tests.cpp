@@ -339,4 +339,44 @@ BOOST_AUTO_TEST_CASE( serial_valve )
    }
 }
 
+BOOST_AUTO_TEST_CASE( parallel_for_visits_every_index )
+{
+   std::vector<uint32_t> visits( 100000, 0 );
+   fc::parallel_for( 0, visits.size(), [&visits] ( size_t i ) { ++visits[i]; } );
+   for( const auto v : visits )
+      BOOST_CHECK_EQUAL( 1u, v );
+
+   // explicit grain, a range smaller than one chunk runs on the calling thread
+   fc::parallel_for( 10, 1000, [&visits] ( size_t i ) { ++visits[i]; }, 7 );
+   fc::parallel_for( 0, 5, [&visits] ( size_t i ) { ++visits[i]; }, 100 );
+   BOOST_CHECK_EQUAL( 2u, visits[0] );
+   BOOST_CHECK_EQUAL( 2u, visits[999] );
+   BOOST_CHECK_EQUAL( 1u, visits[1000] );
+}
+
+BOOST_AUTO_TEST_CASE( parallel_for_rethrows )
+{
+   boost::atomic<uint32_t> counter(0);
+   BOOST_CHECK_THROW( fc::parallel_for( 0, 1000, [&counter] ( size_t i ) {
+                         counter.fetch_add(1);
+                         FC_ASSERT( i != 500 );
+                      }, 10 ), fc::assert_exception );
+   // the other chunks still run to completion
+   BOOST_CHECK_EQUAL( 991u, counter.load() );
+}
+
+BOOST_AUTO_TEST_CASE( nested_parallel_for )
+{
+   // workers which wait for their own parallel_for steal its chunks
+   std::vector<fc::future<uint64_t>> results;
+   for( size_t i = 0; i < 20; i++ )
+      results.push_back( fc::do_parallel( [] () {
+         boost::atomic<uint64_t> sum(0);
+         fc::parallel_for( 0, 1000, [&sum] ( size_t i ) { sum.fetch_add( i ); }, 10 );
+         return sum.load();
+      } ) );
+   for( auto& result : results )
+      BOOST_CHECK_EQUAL( 999u * 1000 / 2, result.wait() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
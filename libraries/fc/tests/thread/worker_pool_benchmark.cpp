@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 The BitShares Blockchain, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/thread/parallel.hpp>
+#include <fc/time.hpp>
+
+#include <iostream>
+
+struct pool_config {
+  pool_config() {
+     for( int i = 0; i < boost::unit_test::framework::master_test_suite().argc - 1; ++i )
+        if( !strcmp( boost::unit_test::framework::master_test_suite().argv[i], "--pool-threads" ) )
+        {
+           uint16_t threads = atoi(boost::unit_test::framework::master_test_suite().argv[++i]);
+           std::cout << "Using " << threads << " pool threads\n";
+           fc::asio::default_io_service_scope::set_num_threads(threads);
+        }
+  }
+};
+
+BOOST_GLOBAL_FIXTURE( pool_config );
+
+namespace {
+
+const uint32_t tasks = 100000;
+
+/// a few hundred nanoseconds of work, so that the pool overhead is visible
+fc::sha256 work( size_t i )
+{
+   return fc::sha256::hash( (const char*)&i, sizeof(i) );
+}
+
+void report( const char* name, const fc::time_point& start, uint64_t count )
+{
+   const auto elapsed = fc::time_point::now() - start;
+   ilog( "${name}: ${n} tasks/s, ${ns} ns/task",
+         ("name", name)("n", count * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))
+         ("ns", elapsed.count() * 1000 / std::max<uint64_t>( count, 1 )) );
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(worker_pool_benchmark)
+
+BOOST_AUTO_TEST_CASE( post_from_one_thread )
+{
+   ilog( "${n} pool workers", ("n", fc::detail::get_worker_pool().size()) );
+
+   auto start = fc::time_point::now();
+   for( uint32_t i = 0; i < tasks; i++ )
+      work( i );
+   report( "serial", start, tasks );
+
+   std::vector<fc::future<fc::sha256>> results;
+   results.reserve( tasks );
+   start = fc::time_point::now();
+   for( uint32_t i = 0; i < tasks; i++ )
+      results.push_back( fc::do_parallel( [i] () { return work( i ); } ) );
+   for( auto& result : results )
+      result.wait();
+   report( "do_parallel from one thread", start, tasks );
+
+   start = fc::time_point::now();
+   fc::parallel_for( 0, tasks, [] ( size_t i ) { work( i ); }, 1 );
+   report( "parallel_for, one task per index", start, tasks );
+
+   start = fc::time_point::now();
+   fc::parallel_for( 0, tasks, [] ( size_t i ) { work( i ); } );
+   report( "parallel_for, default grain", start, tasks );
+}
+
+BOOST_AUTO_TEST_CASE( post_from_all_workers )
+{
+   // every worker posts into its own deque at the same time, the idle ones steal
+   const uint32_t posters = fc::detail::get_worker_pool().size();
+   const uint32_t per_poster = tasks / posters;
+   boost::atomic<uint64_t> done(0);
+
+   const auto start = fc::time_point::now();
+   std::vector<fc::future<void>> results;
+   for( uint32_t p = 0; p < posters; p++ )
+      results.push_back( fc::do_parallel( [per_poster,&done] () {
+         std::vector<fc::future<fc::sha256>> inner;
+         inner.reserve( per_poster );
+         for( uint32_t i = 0; i < per_poster; i++ )
+            inner.push_back( fc::do_parallel( [i] () { return work( i ); } ) );
+         for( auto& result : inner )
+            result.wait();
+         done.fetch_add( inner.size() );
+      } ) );
+   for( auto& result : results )
+      result.wait();
+   report( "do_parallel from all workers", start, done.load() );
+   BOOST_CHECK_EQUAL( uint64_t(posters) * per_poster, done.load() );
+}
+
+BOOST_AUTO_TEST_CASE( unbalanced_chunks )
+{
+   // the cost grows with the index, so that the workers with the last chunks have to be helped
+   const uint32_t count = 2000;
+   auto skewed = [] ( size_t i ) {
+      for( size_t j = 0; j < i / 10; j++ )
+         work( j );
+   };
+
+   auto start = fc::time_point::now();
+   for( uint32_t i = 0; i < count; i++ )
+      skewed( i );
+   report( "unbalanced serial", start, count );
+
+   start = fc::time_point::now();
+   fc::parallel_for( 0, count, skewed );
+   report( "unbalanced parallel_for", start, count );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -38,6 +38,17 @@ namespace fc { namespace test {
    inline bool operator < ( const item& a, const item& b )
    { return ( std::tie( a.level, a.w ) < std::tie( b.level, b.w ) ); }
 
+   struct throwing_copy
+   {
+      static int  alive;
+      static bool fail;
+
+      throwing_copy() { ++alive; }
+      throwing_copy( const throwing_copy& ) { if( fail ) FC_THROW( "copy failed" ); ++alive; }
+      ~throwing_copy() { --alive; }
+   };
+   int  throwing_copy::alive = 0;
+   bool throwing_copy::fail = false;
 
 } } // namespace fc::test
 
@@ -94,6 +105,30 @@ BOOST_AUTO_TEST_CASE( types_edge_cases_test )
    BOOST_CHECK_EQUAL( variant.get<sv_double>().get<double>(), 1.0 );
 }
 
+BOOST_AUTO_TEST_CASE( static_variant_throwing_assignment_test )
+{
+   using namespace fc::test;
+   using sv = fc::static_variant< throwing_copy, std::string >;
+
+   {
+      sv target( std::string( "old value" ) );
+      sv source = throwing_copy();
+      BOOST_CHECK_EQUAL( throwing_copy::alive, 1 );
+
+      throwing_copy::fail = true;
+      BOOST_CHECK_THROW( target = source, fc::exception );
+      throwing_copy::fail = false;
+
+      // the old value was destroyed once and the variant stays empty until it is assigned again
+      BOOST_CHECK_EQUAL( target.which(), -1 );
+      BOOST_CHECK_THROW( target.get<std::string>(), fc::assert_exception );
+
+      target = source;
+      BOOST_CHECK_EQUAL( target.which(), 0 );
+      BOOST_CHECK_EQUAL( throwing_copy::alive, 2 );
+   }
+   BOOST_CHECK_EQUAL( throwing_copy::alive, 0 );
+}
 
 BOOST_AUTO_TEST_CASE( nested_objects_test )
 { try {
@@ -57,6 +57,20 @@
 
 #define GRAPHENE_NET_MAXIMUM_QUEUED_MESSAGES_IN_BYTES        (1024 * 1024)
 
+/**
+ * Size of the buffers an stcp_socket encrypts into and decrypts from.  Each
+ * buffer-full costs one AES call and one socket operation, so a 2MiB block
+ * is sent in 32 pieces rather than 512.
+ */
+#define GRAPHENE_NET_DEFAULT_STCP_BUFFER_SIZE                (64 * 1024)
+
+/**
+ * Queued messages are sent to a peer in batches of up to this many bytes,
+ * encrypted together and written with as few socket operations as possible.
+ * A single message larger than this is still sent as one batch.
+ */
+#define GRAPHENE_NET_MAX_SEND_BATCH_SIZE_IN_BYTES            (256 * 1024)
+
 /**
  * When we receive a message from the network, we advertise it to
  * our peers and save a copy in a cache were we will find it if
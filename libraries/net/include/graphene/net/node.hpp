@@ -88,6 +88,21 @@ namespace graphene { namespace net {
           */
          virtual void handle_transaction( const graphene::net::trx_message& trx_msg ) = 0;
 
+         /**
+          *  @brief Called with every block and transaction received from the network before it is
+          *         passed to handle_block() or handle_transaction()
+          *
+          *  This is the place for the checks which need no chain state.  Their results may be
+          *  kept for the handle_*() call.  Must not throw, an invalid item is rejected when
+          *  handle_*() is called.
+          *
+          *  prevalidate_transaction() is called from a worker pool thread.  prevalidate_block() is
+          *  called from the p2p thread once the block is unpacked, it may run its checks on the
+          *  worker pool and wait for them.
+          */
+         virtual void prevalidate_block( const graphene::net::block_message& blk_msg ) {}
+         virtual void prevalidate_transaction( const graphene::net::trx_message& trx_msg ) {}
+
          /**
           *  @brief Called when a new message comes in from the network other than a
           *         block or a transaction.  Currently there are no other possible 
@@ -261,6 +276,11 @@ namespace graphene { namespace net {
         {
            broadcast( trx_message(trx) );
         }
+        /**
+         *  Add all transactions to the outgoing inventory list at once, so that
+         *  peers are notified of them together.
+         */
+        virtual void  broadcast_transactions( const std::vector<signed_transaction>& trxs );
 
         /**
          *  Node starts the process of fetching all items after item_id of the
@@ -309,6 +329,7 @@ namespace graphene { namespace net {
 
       void      sync_from(const item_id& current_head_block, const std::vector<uint32_t>& hard_fork_block_numbers) override {}
       void      broadcast(const message& item_to_broadcast) override;
+      void      broadcast_transactions(const std::vector<signed_transaction>& trxs) override;
       void      add_node_delegate(node_delegate* node_delegate_to_add);
 
       virtual uint32_t get_connection_count() const override { return 8; }
@@ -26,6 +26,10 @@
 #include <fc/crypto/aes.hpp>
 #include <fc/crypto/elliptic.hpp>
 
+#include <graphene/net/config.hpp>
+
+#include <vector>
+
 namespace graphene { namespace net {
 
 /**
@@ -35,7 +39,20 @@ namespace graphene { namespace net {
 class stcp_socket : public virtual fc::iostream
 {
   public:
-    stcp_socket();
+    /** A piece of plaintext passed to write_segments(), not owned by the socket */
+    struct segment
+    {
+      segment( const char* data, size_t size ) : data(data), size(size) {}
+      const char* data;
+      size_t      size;
+    };
+
+    /**
+     *  @param buffer_size the size of the read and write buffers, rounded down to a
+     *         multiple of 16.  Each writesome()/readsome() call moves at most this many
+     *         bytes through a single AES call and socket operation.
+     */
+    stcp_socket( size_t buffer_size = GRAPHENE_NET_DEFAULT_STCP_BUFFER_SIZE );
     ~stcp_socket();
     fc::tcp_socket&  get_socket() { return _sock; }
     void             accept();
@@ -50,6 +67,17 @@ class stcp_socket : public virtual fc::iostream
     virtual size_t   writesome( const char* buffer, size_t len );
     virtual size_t   writesome( const std::shared_ptr<const char>& buf, size_t len, size_t offset );
 
+    /**
+     *  Encrypts the segments as one contiguous stream, zero-padded to a multiple of
+     *  16 bytes, and writes it out.  The segments need not be aligned to 16 bytes; they
+     *  are encrypted straight from the caller's memory without being copied together.
+     *
+     *  @return the number of bytes written, including the padding
+     */
+    size_t           write_segments( const std::vector<segment>& segments );
+
+    size_t           get_buffer_size() const { return _buffer_size; }
+
     virtual void     flush();
     virtual void     close();
 
@@ -58,12 +86,14 @@ class stcp_socket : public virtual fc::iostream
     fc::sha512       get_shared_secret() const { return _shared_secret; }
   private:
     void do_key_exchange();
+    char* get_buffer( std::shared_ptr<char>& buffer );
 
     fc::sha512           _shared_secret;
     fc::ecc::private_key _priv_key;
     fc::tcp_socket       _sock;
     fc::aes_encoder      _send_aes;
     fc::aes_decoder      _recv_aes;
+    size_t               _buffer_size;
     std::shared_ptr<char> _read_buffer;
     std::shared_ptr<char> _write_buffer;
 #ifndef NDEBUG
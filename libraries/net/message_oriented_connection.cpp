@@ -68,6 +68,7 @@ namespace graphene { namespace net {
 
       void read_loop();
       void start_read_loop();
+      void write_messages(const message* messages_to_send, size_t count);
     public:
       fc::tcp_socket& get_socket();
       void accept();
@@ -79,6 +80,7 @@ namespace graphene { namespace net {
       ~message_oriented_connection_impl();
 
       void send_message(const message& message_to_send);
+      void send_messages(const std::vector<message>& messages_to_send);
       void close_connection();
       void destroy_connection();
 
@@ -241,6 +243,18 @@ namespace graphene { namespace net {
       } send_message_scope_logger(remote_endpoint);
 #endif
 #endif
+      write_messages(&message_to_send, 1);
+    }
+
+    void message_oriented_connection_impl::send_messages(const std::vector<message>& messages_to_send)
+    {
+      VERIFY_CORRECT_THREAD();
+      if (!messages_to_send.empty())
+        write_messages(messages_to_send.data(), messages_to_send.size());
+    }
+
+    void message_oriented_connection_impl::write_messages(const message* messages_to_send, size_t count)
+    {
       struct verify_no_send_in_progress {
         bool& var;
         verify_no_send_in_progress(bool& var) : var(var)
@@ -255,21 +269,27 @@ namespace graphene { namespace net {
 
       try
       {
-         size_t size_of_message_and_header = sizeof(message_header) + message_to_send.size.value();
-         if( message_to_send.size.value() > MAX_MESSAGE_SIZE ) {
-            elog("Trying to send a message larger than MAX_MESSAGE_SIZE. This probably won't work...");
+         // each message is padded to a multiple of 16 bytes, the padding is taken from here
+         static const char padding[16] = {};
+
+         // the header and body of each message are encrypted straight from the message,
+         // without copying them into one padded buffer first
+         std::vector<stcp_socket::segment> segments;
+         segments.reserve(3 * count);
+         for (size_t i = 0; i < count; ++i)
+         {
+            const message& message_to_send = messages_to_send[i];
+            size_t size_of_message_and_header = sizeof(message_header) + message_to_send.size.value();
+            if( message_to_send.size.value() > MAX_MESSAGE_SIZE ) {
+               elog("Trying to send a message larger than MAX_MESSAGE_SIZE. This probably won't work...");
+            }
+            size_t size_with_padding = 16 * ((size_of_message_and_header + 15) / 16);
+            segments.emplace_back((const char*)&message_to_send, sizeof(message_header));
+            segments.emplace_back(message_to_send.data.data(), message_to_send.size.value());
+            segments.emplace_back(padding, size_with_padding - size_of_message_and_header);
          }
-         //pad the message we send to a multiple of 16 bytes
-         size_t size_with_padding = 16 * ((size_of_message_and_header + 15) / 16);
-         std::unique_ptr<char[]> padded_message(new char[size_with_padding]);
-
-         memcpy(padded_message.get(), (char*)&message_to_send, sizeof(message_header));
-         memcpy(padded_message.get() + sizeof(message_header), message_to_send.data.data(), message_to_send.size.value() );
-         char* padding_space = padded_message.get() + sizeof(message_header) + message_to_send.size.value();
-         memset(padding_space, 0, size_with_padding - size_of_message_and_header);
-         _sock.write(padded_message.get(), size_with_padding);
+         _bytes_sent += _sock.write_segments(segments);
          _sock.flush();
-         _bytes_sent += size_with_padding;
          _last_message_sent_time = fc::time_point::now();
       } FC_RETHROW_EXCEPTIONS( warn, "unable to send message" );
     }
@@ -375,6 +395,11 @@ namespace graphene { namespace net {
     my->send_message(message_to_send);
   }
 
+  void message_oriented_connection::send_messages(const std::vector<message>& messages_to_send)
+  {
+    my->send_messages(messages_to_send);
+  }
+
   void message_oriented_connection::close_connection()
   {
     my->close_connection();
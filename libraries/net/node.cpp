@@ -42,6 +42,7 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/logic/tribool.hpp>
+#include <boost/scope_exit.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/numeric.hpp>
@@ -60,6 +61,7 @@
 
 #include <fc/thread/thread.hpp>
 #include <fc/thread/future.hpp>
+#include <fc/thread/parallel.hpp>
 #include <fc/thread/non_preemptable_scope_check.hpp>
 #include <fc/thread/mutex.hpp>
 #include <fc/thread/scoped_lock.hpp>
@@ -318,7 +320,9 @@ namespace graphene { namespace net { namespace detail {
       _node_is_shutting_down(false),
       _maximum_number_of_blocks_to_handle_at_one_time(MAXIMUM_NUMBER_OF_BLOCKS_TO_HANDLE_AT_ONE_TIME),
       _maximum_number_of_sync_blocks_to_prefetch(MAXIMUM_NUMBER_OF_BLOCKS_TO_PREFETCH),
-      _maximum_blocks_per_peer_during_syncing(GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING)
+      _maximum_blocks_per_peer_during_syncing(GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING),
+      _prevalidations_in_flight(0),
+      _maximum_number_of_prevalidations_in_flight(2 * fc::detail::get_worker_pool().size())
     {
       _rate_limiter.set_actual_rate_time_constant(fc::seconds(2));
       fc::rand_bytes((char*) _node_id.data(), (int)_node_id.size());
@@ -484,10 +488,8 @@ namespace graphene { namespace net { namespace detail {
     bool node_impl::have_already_received_sync_item( const item_hash_t& item_hash )
     {
       VERIFY_CORRECT_THREAD();
-      return std::find_if(_received_sync_items.begin(), _received_sync_items.end(),
-                          [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _received_sync_items.end() ||
-             std::find_if(_new_received_sync_items.begin(), _new_received_sync_items.end(),
-                          [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _new_received_sync_items.end();                          ;
+      const auto& received_blocks_by_id = _received_sync_items.get<sync_block_id_index>();
+      return received_blocks_by_id.find(item_hash) != received_blocks_by_id.end();
     }
 
     void node_impl::request_sync_item_from_peer( const peer_connection_ptr& peer, const item_hash_t& item_to_request )
@@ -2765,86 +2767,89 @@ namespace graphene { namespace net { namespace detail {
       std::set<peer_connection_ptr> peers_we_need_to_sync_to;
       std::map<peer_connection_ptr, fc::oexception> peers_with_rejected_block;
 
+      auto& received_blocks_by_id = _received_sync_items.get<sync_block_id_index>();
       do
       {
-        std::copy(std::make_move_iterator(_new_received_sync_items.begin()),
-                  std::make_move_iterator(_new_received_sync_items.end()),
-                  std::front_inserter(_received_sync_items));
-        _new_received_sync_items.clear();
         dlog("currently ${count} sync items to consider", ("count", _received_sync_items.size()));
 
+        // the next block on the active chain or one of the forks is the one at the front of a peer's
+        // list of items to get, if several peers are waiting for blocks we have, take the lowest one
         block_processed_this_iteration = false;
-        for (auto received_block_iter = _received_sync_items.begin();
-             received_block_iter != _received_sync_items.end();
-             ++received_block_iter)
+        auto received_block_iter = received_blocks_by_id.end();
+        for (const peer_connection_ptr& peer : _active_connections)
         {
+          ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+          if (peer->ids_of_items_to_get.empty())
+            continue;
+          auto peer_block_iter = received_blocks_by_id.find(peer->ids_of_items_to_get.front());
+          if (peer_block_iter != received_blocks_by_id.end() &&
+              (received_block_iter == received_blocks_by_id.end() ||
+               peer_block_iter->block.block_num() < received_block_iter->block.block_num()))
+            received_block_iter = peer_block_iter;
+        }
 
-          // find out if this block is the next block on the active chain or one of the forks
-          bool potential_first_block = false;
+        // if there is one, process it, remove it from all sync peers lists
+        if (received_block_iter != received_blocks_by_id.end())
+        {
+          const block_id_type received_block_id = received_block_iter->block_id;
           for (const peer_connection_ptr& peer : _active_connections)
           {
             ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
             if (!peer->ids_of_items_to_get.empty() &&
-                peer->ids_of_items_to_get.front() == received_block_iter->block_id)
+                peer->ids_of_items_to_get.front() == received_block_id)
             {
-              potential_first_block = true;
               peer->ids_of_items_to_get.pop_front();
-              peer->ids_of_items_being_processed.insert(received_block_iter->block_id);
+              peer->ids_of_items_being_processed.insert(received_block_id);
             }
           }
 
-          // if it is, process it, remove it from all sync peers lists
-          if (potential_first_block)
+          // we can get into an interesting situation near the end of synchronization.  We can be in
+          // sync with one peer who is sending us the last block on the chain via a regular inventory
+          // message, while at the same time still be synchronizing with a peer who is sending us the
+          // block through the sync mechanism.  Further, we must request both blocks because
+          // we don't know they're the same (for the peer in normal operation, it has only told us the
+          // message id, for the peer in the sync case we only known the block_id).
+          if (std::find(_most_recent_blocks_accepted.begin(), _most_recent_blocks_accepted.end(),
+                        received_block_id) == _most_recent_blocks_accepted.end())
           {
-            // we can get into an interesting situation near the end of synchronization.  We can be in
-            // sync with one peer who is sending us the last block on the chain via a regular inventory
-            // message, while at the same time still be synchronizing with a peer who is sending us the
-            // block through the sync mechanism.  Further, we must request both blocks because
-            // we don't know they're the same (for the peer in normal operation, it has only told us the
-            // message id, for the peer in the sync case we only known the block_id).
-            if (std::find(_most_recent_blocks_accepted.begin(), _most_recent_blocks_accepted.end(),
-                          received_block_iter->block_id) == _most_recent_blocks_accepted.end())
-            {
-              graphene::net::block_message block_message_to_process = *received_block_iter;
-              _received_sync_items.erase(received_block_iter);
-              _handle_message_calls_in_progress.emplace_back(fc::async([this, block_message_to_process](){
-                send_sync_block_to_node_delegate(block_message_to_process);
-              }, "send_sync_block_to_node_delegate"));
-              ++blocks_processed;
-              block_processed_this_iteration = true;
-            }
-            else
+            graphene::net::block_message block_message_to_process = *received_block_iter;
+            received_blocks_by_id.erase(received_block_iter);
+            _handle_message_calls_in_progress.emplace_back(fc::async([this, block_message_to_process](){
+              send_sync_block_to_node_delegate(block_message_to_process);
+            }, "send_sync_block_to_node_delegate"));
+            ++blocks_processed;
+            block_processed_this_iteration = true;
+          }
+          else
+          {
+            dlog("Already received and accepted this block (presumably through normal inventory mechanism), treating it as accepted");
+            received_blocks_by_id.erase(received_block_iter);
+            std::vector< peer_connection_ptr > peers_needing_next_batch;
+            for (const peer_connection_ptr& peer : _active_connections)
             {
-              dlog("Already received and accepted this block (presumably through normal inventory mechanism), treating it as accepted");
-              std::vector< peer_connection_ptr > peers_needing_next_batch;
-              for (const peer_connection_ptr& peer : _active_connections)
+              auto items_being_processed_iter = peer->ids_of_items_being_processed.find(received_block_id);
+              if (items_being_processed_iter != peer->ids_of_items_being_processed.end())
               {
-                auto items_being_processed_iter = peer->ids_of_items_being_processed.find(received_block_iter->block_id);
-                if (items_being_processed_iter != peer->ids_of_items_being_processed.end())
+                peer->ids_of_items_being_processed.erase(items_being_processed_iter);
+                dlog("Removed item from ${endpoint}'s list of items being processed, still processing ${len} blocks",
+                     ("endpoint", peer->get_remote_endpoint())("len", peer->ids_of_items_being_processed.size()));
+
+                // if we just processed the last item in our list from this peer, we will want to
+                // send another request to find out if we are now in sync (this is normally handled in
+                // send_sync_block_to_node_delegate)
+                if (peer->ids_of_items_to_get.empty() &&
+                    peer->number_of_unfetched_item_ids == 0 &&
+                    peer->ids_of_items_being_processed.empty())
                 {
-                  peer->ids_of_items_being_processed.erase(items_being_processed_iter);
-                  dlog("Removed item from ${endpoint}'s list of items being processed, still processing ${len} blocks",
-                       ("endpoint", peer->get_remote_endpoint())("len", peer->ids_of_items_being_processed.size()));
-
-                  // if we just processed the last item in our list from this peer, we will want to
-                  // send another request to find out if we are now in sync (this is normally handled in
-                  // send_sync_block_to_node_delegate)
-                  if (peer->ids_of_items_to_get.empty() &&
-                      peer->number_of_unfetched_item_ids == 0 &&
-                      peer->ids_of_items_being_processed.empty())
-                  {
-                    dlog("We received last item in our list for peer ${endpoint}, setup to do a sync check", ("endpoint", peer->get_remote_endpoint()));
-                    peers_needing_next_batch.push_back( peer );
-                  }
+                  dlog("We received last item in our list for peer ${endpoint}, setup to do a sync check", ("endpoint", peer->get_remote_endpoint()));
+                  peers_needing_next_batch.push_back( peer );
                 }
               }
-              for( const peer_connection_ptr& peer : peers_needing_next_batch )
-                fetch_next_batch_of_item_ids_from_peer(peer.get());
             }
-
-            break; // start iterating _received_sync_items from the beginning
-          } // end if potential_first_block
-        } // end for each block in _received_sync_items
+            for( const peer_connection_ptr& peer : peers_needing_next_batch )
+              fetch_next_batch_of_item_ids_from_peer(peer.get());
+          }
+        }
 
         if (_handle_message_calls_in_progress.size() >= _maximum_number_of_blocks_to_handle_at_one_time)
         {
@@ -2877,9 +2882,9 @@ namespace graphene { namespace net { namespace detail {
       VERIFY_CORRECT_THREAD();
       dlog( "received a sync block from peer ${endpoint}", ("endpoint", originating_peer->get_remote_endpoint() ) );
 
-      // add it to the front of _received_sync_items, then process _received_sync_items to try to
+      // add it to _received_sync_items, then process _received_sync_items to try to
       // pass as many messages as possible to the client.
-      _new_received_sync_items.push_front( block_message_to_process );
+      _received_sync_items.insert( block_message_to_process );
       trigger_process_backlog_of_sync_blocks();
     }
 
@@ -3048,7 +3053,7 @@ namespace graphene { namespace net { namespace detail {
       // (it's possible that we request an item during normal operation and then get kicked into sync
       // mode before we receive and process the item.  In that case, we should process the item as a normal
       // item to avoid confusing the sync code)
-      graphene::net::block_message block_message_to_process(message_to_process.as<graphene::net::block_message>());
+      graphene::net::block_message block_message_to_process(prevalidate_block_message(message_to_process));
       auto item_iter = originating_peer->items_requested_from_peer.find(item_id(graphene::net::block_message_type, message_hash));
       if (item_iter != originating_peer->items_requested_from_peer.end())
       {
@@ -3119,6 +3124,82 @@ namespace graphene { namespace net { namespace detail {
       disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
     }
 
+    void node_impl::acquire_prevalidation_slot(bool for_block)
+    {
+      VERIFY_CORRECT_THREAD();
+      if (_prevalidations_in_flight < _maximum_number_of_prevalidations_in_flight)
+      {
+        ++_prevalidations_in_flight;
+        return;
+      }
+      // wait until release_prevalidation_slot() hands its slot over to us
+      std::deque<fc::promise<void>::ptr>& waiting = for_block ? _blocks_waiting_for_prevalidation
+                                                              : _transactions_waiting_for_prevalidation;
+      fc::promise<void>::ptr slot_handed_over = fc::promise<void>::create("graphene::net::prevalidation_slot");
+      waiting.push_back(slot_handed_over);
+      try
+      {
+        slot_handed_over->wait();
+      }
+      catch (...)
+      {
+        if (slot_handed_over->ready())
+          release_prevalidation_slot();
+        else
+          waiting.erase(std::find(waiting.begin(), waiting.end(), slot_handed_over));
+        throw;
+      }
+    }
+
+    void node_impl::release_prevalidation_slot()
+    {
+      VERIFY_CORRECT_THREAD();
+      std::deque<fc::promise<void>::ptr>& waiting = !_blocks_waiting_for_prevalidation.empty() ? _blocks_waiting_for_prevalidation
+                                                                                               : _transactions_waiting_for_prevalidation;
+      if (waiting.empty())
+      {
+        --_prevalidations_in_flight;
+        return;
+      }
+      fc::promise<void>::ptr next = waiting.front();
+      waiting.pop_front();
+      next->set_value();
+    }
+
+    // deserializing a message and the stateless checks of its contents are done on the worker pool,
+    // so the p2p thread keeps serving the other peers meanwhile.  The message is copied into the task
+    // because the task may outlive this call if the peer's read loop is canceled
+    graphene::net::block_message node_impl::prevalidate_block_message(const message& message_to_process)
+    {
+      VERIFY_CORRECT_THREAD();
+      acquire_prevalidation_slot(true);
+      BOOST_SCOPE_EXIT(this_) {
+        this_->release_prevalidation_slot();
+      } BOOST_SCOPE_EXIT_END
+      graphene::net::block_message block_message_to_process = fc::do_parallel([message_to_process]() {
+        return message_to_process.as<graphene::net::block_message>();
+      }, "unpack block").wait();
+      // the checks of a block may be spread over the worker pool, so they are waited for here where only
+      // this peer's fiber waits, not on a worker thread
+      _delegate->prevalidate_block(block_message_to_process);
+      return block_message_to_process;
+    }
+
+    graphene::net::trx_message node_impl::prevalidate_transaction_message(const message& message_to_process)
+    {
+      VERIFY_CORRECT_THREAD();
+      acquire_prevalidation_slot(false);
+      BOOST_SCOPE_EXIT(this_) {
+        this_->release_prevalidation_slot();
+      } BOOST_SCOPE_EXIT_END
+      statistics_gathering_node_delegate_wrapper* delegate = _delegate.get();
+      return fc::do_parallel([delegate, message_to_process]() {
+        trx_message transaction_message_to_process(message_to_process.as<trx_message>());
+        delegate->prevalidate_transaction(transaction_message_to_process);
+        return transaction_message_to_process;
+      }, "prevalidate transaction").wait();
+    }
+
     void node_impl::on_current_time_request_message(peer_connection* originating_peer,
                                                     const current_time_request_message& current_time_request_message_received)
     {
@@ -3415,7 +3496,7 @@ namespace graphene { namespace net { namespace detail {
         {
           if (message_to_process.msg_type.value() == trx_message_type)
           {
-            trx_message transaction_message_to_process = message_to_process.as<trx_message>();
+            trx_message transaction_message_to_process = prevalidate_transaction_message(message_to_process);
             dlog( "passing message containing transaction ${trx} to client",
                   ("trx", transaction_message_to_process.trx.id()) );
             _delegate->handle_transaction(transaction_message_to_process);
@@ -4309,7 +4390,12 @@ namespace graphene { namespace net { namespace detail {
       ilog( "--------- MEMORY USAGE ------------" );
       ilog( "node._active_sync_requests size: ${size}", ("size", _active_sync_requests.size() ) );
       ilog( "node._received_sync_items size: ${size}", ("size", _received_sync_items.size() ) );
-      ilog( "node._new_received_sync_items size: ${size}", ("size", _new_received_sync_items.size() ) );
+      if( !_received_sync_items.empty() )
+      {
+        const auto& received_blocks_by_num = _received_sync_items.get<sync_block_num_index>();
+        ilog( "node._received_sync_items blocks: ${first} to ${last}",
+              ("first", received_blocks_by_num.begin()->block.block_num())("last", received_blocks_by_num.rbegin()->block.block_num()) );
+      }
       ilog( "node._items_to_fetch size: ${size}", ("size", _items_to_fetch.size() ) );
       ilog( "node._new_inventory size: ${size}", ("size", _new_inventory.size() ) );
       ilog( "node._message_cache size: ${size}", ("size", _message_cache.size() ) );
@@ -4484,6 +4570,13 @@ namespace graphene { namespace net { namespace detail {
     }
 
     void node_impl::broadcast( const message& item_to_broadcast, const message_propagation_data& propagation_data )
+    {
+      VERIFY_CORRECT_THREAD();
+      add_to_new_inventory( item_to_broadcast, propagation_data );
+      trigger_advertise_inventory_loop();
+    }
+
+    void node_impl::add_to_new_inventory( const message& item_to_broadcast, const message_propagation_data& propagation_data )
     {
       VERIFY_CORRECT_THREAD();
       fc::uint160_t hash_of_message_contents;
@@ -4503,7 +4596,6 @@ namespace graphene { namespace net { namespace detail {
 
       _message_cache.cache_message( item_to_broadcast, hash_of_item_to_broadcast, propagation_data, hash_of_message_contents );
       _new_inventory.insert( item_id(item_to_broadcast.msg_type.value(), hash_of_item_to_broadcast ) );
-      trigger_advertise_inventory_loop();
     }
 
     void node_impl::broadcast( const message& item_to_broadcast )
@@ -4514,6 +4606,17 @@ namespace graphene { namespace net { namespace detail {
       broadcast( item_to_broadcast, propagation_data );
     }
 
+    void node_impl::broadcast_transactions( const std::vector<signed_transaction>& trxs )
+    {
+      VERIFY_CORRECT_THREAD();
+      // the advertise loop only runs once all transactions are queued, so they share the inventory messages
+      message_propagation_data propagation_data{fc::time_point::now(), fc::time_point::now(), _node_id};
+      for( const auto& trx : trxs )
+        add_to_new_inventory( trx_message(trx), propagation_data );
+      if( !trxs.empty() )
+        trigger_advertise_inventory_loop();
+    }
+
     void node_impl::sync_from(const item_id& current_head_block, const std::vector<uint32_t>& hard_fork_block_numbers)
     {
       VERIFY_CORRECT_THREAD();
@@ -4554,6 +4657,8 @@ namespace graphene { namespace net { namespace detail {
         _maximum_number_of_sync_blocks_to_prefetch = params["maximum_number_of_sync_blocks_to_prefetch"].as<uint32_t>(1);
       if (params.contains("maximum_blocks_per_peer_during_syncing"))
         _maximum_blocks_per_peer_during_syncing = params["maximum_blocks_per_peer_during_syncing"].as<uint32_t>(1);
+      if (params.contains("maximum_number_of_prevalidations_in_flight"))
+        _maximum_number_of_prevalidations_in_flight = std::max(params["maximum_number_of_prevalidations_in_flight"].as<uint32_t>(1), 1u);
 
       _desired_number_of_connections = std::min(_desired_number_of_connections, _maximum_number_of_connections);
 
@@ -4573,6 +4678,7 @@ namespace graphene { namespace net { namespace detail {
       result["maximum_number_of_blocks_to_handle_at_one_time"] = _maximum_number_of_blocks_to_handle_at_one_time;
       result["maximum_number_of_sync_blocks_to_prefetch"] = _maximum_number_of_sync_blocks_to_prefetch;
       result["maximum_blocks_per_peer_during_syncing"] = _maximum_blocks_per_peer_during_syncing;
+      result["maximum_number_of_prevalidations_in_flight"] = _maximum_number_of_prevalidations_in_flight;
       return result;
     }
 
@@ -4775,6 +4881,11 @@ namespace graphene { namespace net { namespace detail {
     INVOKE_IN_IMPL(broadcast, msg);
   }
 
+  void node::broadcast_transactions( const std::vector<signed_transaction>& trxs )
+  {
+    INVOKE_IN_IMPL(broadcast_transactions, trxs);
+  }
+
   void node::sync_from(const item_id& current_head_block, const std::vector<uint32_t>& hard_fork_block_numbers)
   {
     INVOKE_IN_IMPL(sync_from, current_head_block, hard_fork_block_numbers);
@@ -4881,11 +4992,17 @@ namespace graphene { namespace net { namespace detail {
       {
         const message& message_to_deliver = destination_node->messages_to_deliver.front();
         if (message_to_deliver.msg_type.value() == trx_message_type)
-          destination_node->delegate->handle_transaction(message_to_deliver.as<trx_message>());
+        {
+          trx_message transaction_message_to_deliver(message_to_deliver.as<trx_message>());
+          destination_node->delegate->prevalidate_transaction(transaction_message_to_deliver);
+          destination_node->delegate->handle_transaction(transaction_message_to_deliver);
+        }
         else if (message_to_deliver.msg_type.value() == block_message_type)
         {
+          block_message block_message_to_deliver(message_to_deliver.as<block_message>());
           std::vector<fc::uint160_t> contained_transaction_message_ids;
-          destination_node->delegate->handle_block(message_to_deliver.as<block_message>(), false, contained_transaction_message_ids);
+          destination_node->delegate->prevalidate_block(block_message_to_deliver);
+          destination_node->delegate->handle_block(block_message_to_deliver, false, contained_transaction_message_ids);
         }
         else
           destination_node->delegate->handle_message(message_to_deliver);
@@ -4908,6 +5025,12 @@ namespace graphene { namespace net { namespace detail {
     }
   }
 
+  void simulated_network::broadcast_transactions( const std::vector<signed_transaction>& trxs )
+  {
+    for( const auto& trx : trxs )
+      broadcast( trx_message(trx) );
+  }
+
   void simulated_network::add_node_delegate( node_delegate* node_delegate_to_add )
   {
     network_nodes.push_back(new node_info(node_delegate_to_add));
@@ -34,6 +34,24 @@ struct prioritized_item_id
   }
 };
 
+// sync blocks are passed to the client in chain order, but arrive in whatever order the peers send them.
+// The blocks which can't be processed yet are buffered here, indexed by id to find the next block of any
+// peer's sync list and by number to know the range we're holding
+struct sync_block_num_extractor
+{
+  typedef uint32_t result_type;
+  uint32_t operator()(const graphene::net::block_message& message) const { return message.block.block_num(); }
+};
+struct sync_block_id_index{};
+struct sync_block_num_index{};
+typedef boost::multi_index_container<graphene::net::block_message,
+                                     boost::multi_index::indexed_by<boost::multi_index::hashed_unique<boost::multi_index::tag<sync_block_id_index>,
+                                                                                                      boost::multi_index::member<graphene::net::block_message, graphene::net::block_id_type, &graphene::net::block_message::block_id>,
+                                                                                                      std::hash<graphene::net::block_id_type> >,
+                                                                    boost::multi_index::ordered_non_unique<boost::multi_index::tag<sync_block_num_index>,
+                                                                                                           sync_block_num_extractor> >
+                                     > received_sync_items_type;
+
 class statistics_gathering_node_delegate_wrapper : public node_delegate
 {
 private:
@@ -146,6 +164,15 @@ private:
       void handle_message( const message& ) override;
       bool handle_block( const graphene::net::block_message& block_message, bool sync_mode, std::vector<fc::uint160_t>& contained_transaction_message_ids ) override;
       void handle_transaction( const graphene::net::trx_message& transaction_message ) override;
+      // called on worker threads or the p2p thread, so these are forwarded without a hop to the delegate thread
+      void prevalidate_block( const graphene::net::block_message& block_message ) override
+      {
+        _node_delegate->prevalidate_block(block_message);
+      }
+      void prevalidate_transaction( const graphene::net::trx_message& transaction_message ) override
+      {
+        _node_delegate->prevalidate_transaction(transaction_message);
+      }
       std::vector<item_hash_t> get_block_ids(const std::vector<item_hash_t>& blockchain_synopsis,
                                              uint32_t& remaining_item_count,
                                              uint32_t limit = 2000) override;
@@ -207,8 +234,7 @@ class node_impl : public peer_connection_delegate
       typedef std::unordered_map<graphene::net::block_id_type, fc::time_point> active_sync_requests_map;
 
       active_sync_requests_map              _active_sync_requests; /// list of sync blocks we've asked for from peers but have not yet received
-      std::list<graphene::net::block_message> _new_received_sync_items; /// list of sync blocks we've just received but haven't yet tried to process
-      std::list<graphene::net::block_message> _received_sync_items; /// list of sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
+      received_sync_items_type              _received_sync_items; /// sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
       // @}
 
       fc::future<void> _process_backlog_of_sync_blocks_done;
@@ -337,6 +363,16 @@ class node_impl : public peer_connection_delegate
 
       std::list<fc::future<void> > _handle_message_calls_in_progress;
 
+      /// blocks and transactions are deserialized and prevalidated on the worker pool.  At most
+      /// _maximum_number_of_prevalidations_in_flight run at once, when they are all taken the
+      /// waiting blocks are let in before the waiting transactions
+      // @{
+      unsigned _prevalidations_in_flight;
+      unsigned _maximum_number_of_prevalidations_in_flight;
+      std::deque<fc::promise<void>::ptr> _blocks_waiting_for_prevalidation;
+      std::deque<fc::promise<void>::ptr> _transactions_waiting_for_prevalidation;
+      // @}
+
       node_impl(const std::string& user_agent);
       virtual ~node_impl();
 
@@ -445,6 +481,11 @@ class node_impl : public peer_connection_delegate
       void process_block_during_normal_operation(peer_connection* originating_peer, const graphene::net::block_message& block_message, const message_hash_type& message_hash);
       void process_block_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
 
+      void acquire_prevalidation_slot(bool for_block);
+      void release_prevalidation_slot();
+      graphene::net::block_message prevalidate_block_message(const message& message_to_process);
+      graphene::net::trx_message prevalidate_transaction_message(const message& message_to_process);
+
       void process_ordinary_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
 
       void start_synchronizing();
@@ -494,6 +535,9 @@ class node_impl : public peer_connection_delegate
 
       void broadcast(const message& item_to_broadcast, const message_propagation_data& propagation_data);
       void broadcast(const message& item_to_broadcast);
+      void broadcast_transactions(const std::vector<signed_transaction>& trxs);
+      /// caches the item and queues it for the next inventory advertisement without waking up the loop
+      void add_to_new_inventory(const message& item_to_broadcast, const message_propagation_data& propagation_data);
       void sync_from(const item_id& current_head_block, const std::vector<uint32_t>& hard_fork_block_numbers);
       bool is_connected() const;
       std::vector<potential_peer_record> get_potential_peers() const;
@@ -294,20 +294,31 @@ namespace graphene { namespace net
 #endif
       while (!_queued_messages.empty())
       {
-        _queued_messages.front()->transmission_start_time = fc::time_point::now();
-        message message_to_send = _queued_messages.front()->get_message(_node);
+        // take messages off the queue until the batch is full, so they are
+        // encrypted together and go out in as few socket writes as possible
+        std::vector<std::unique_ptr<queued_message>> batch;
+        std::vector<message> messages_to_send;
+        size_t batch_size = 0;
+        do
+        {
+          batch.emplace_back(std::move(_queued_messages.front()));
+          _queued_messages.pop();
+          batch.back()->transmission_start_time = fc::time_point::now();
+          messages_to_send.emplace_back(batch.back()->get_message(_node));
+          batch_size += messages_to_send.back().size.value();
+        } while (!_queued_messages.empty() && batch_size < GRAPHENE_NET_MAX_SEND_BATCH_SIZE_IN_BYTES);
         try
         {
-          //dlog("peer_connection::send_queued_messages_task() calling message_oriented_connection::send_message() "
-          //     "to send message of type ${type} for peer ${endpoint}",
-          //     ("type", message_to_send.msg_type)("endpoint", get_remote_endpoint()));
-          _message_connection.send_message(message_to_send);
-          //dlog("peer_connection::send_queued_messages_task()'s call to message_oriented_connection::send_message() completed normally for peer ${endpoint}",
+          //dlog("peer_connection::send_queued_messages_task() calling message_oriented_connection::send_messages() "
+          //     "to send ${count} messages for peer ${endpoint}",
+          //     ("count", messages_to_send.size())("endpoint", get_remote_endpoint()));
+          _message_connection.send_messages(messages_to_send);
+          //dlog("peer_connection::send_queued_messages_task()'s call to message_oriented_connection::send_messages() completed normally for peer ${endpoint}",
           //     ("endpoint", get_remote_endpoint()));
         }
         catch (const fc::canceled_exception&)
         {
-          dlog("message_oriented_connection::send_message() was canceled, rethrowing canceled_exception");
+          dlog("message_oriented_connection::send_messages() was canceled, rethrowing canceled_exception");
           throw;
         }
         catch (const fc::exception& send_error)
@@ -325,15 +336,18 @@ namespace graphene { namespace net
         }
         catch (const std::exception& e)
         {
-          wlog("message_oriented_exception::send_message() threw a std::exception(): ${what}", ("what", e.what()));
+          wlog("message_oriented_exception::send_messages() threw a std::exception(): ${what}", ("what", e.what()));
         }
         catch (...)
         {
-          wlog("message_oriented_exception::send_message() threw an unhandled exception");
+          wlog("message_oriented_exception::send_messages() threw an unhandled exception");
+        }
+        fc::time_point transmission_finish_time = fc::time_point::now();
+        for (const std::unique_ptr<queued_message>& sent_message : batch)
+        {
+          sent_message->transmission_finish_time = transmission_finish_time;
+          _total_queued_messages_size -= sent_message->get_size_in_queue();
         }
-        _queued_messages.front()->transmission_finish_time = fc::time_point::now();
-        _total_queued_messages_size -= _queued_messages.front()->get_size_in_queue();
-        _queued_messages.pop();
       }
       //dlog("leaving peer_connection::send_queued_messages_task() due to queue exhaustion");
     }
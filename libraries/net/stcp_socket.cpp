@@ -36,10 +36,10 @@
 
 namespace graphene { namespace net {
 
-stcp_socket::stcp_socket()
-//:_buf_len(0)
+stcp_socket::stcp_socket( size_t buffer_size )
+   : _buffer_size( std::max<size_t>( buffer_size & ~size_t(15), 16 ) )
 #ifndef NDEBUG
-   : _read_buffer_in_use(false),
+   , _read_buffer_in_use(false),
      _write_buffer_in_use(false)
 #endif
 {
@@ -48,6 +48,13 @@ stcp_socket::~stcp_socket()
 {
 }
 
+char* stcp_socket::get_buffer( std::shared_ptr<char>& buffer )
+{
+  if( !buffer )
+    buffer.reset( new char[_buffer_size], [](char* p){ delete[] p; } );
+  return buffer.get();
+}
+
 void stcp_socket::do_key_exchange()
 {
   _priv_key = fc::ecc::private_key::generate();
@@ -100,11 +107,8 @@ size_t stcp_socket::readsome( char* buffer, size_t len )
     } buffer_in_use_checker(_read_buffer_in_use);
 #endif
 
-    const size_t read_buffer_length = 4096;
-    if (!_read_buffer)
-      _read_buffer.reset(new char[read_buffer_length], [](char* p){ delete[] p; });
-
-    len = std::min<size_t>(read_buffer_length, len);
+    get_buffer( _read_buffer );
+    len = std::min<size_t>(_buffer_size, len);
 
     size_t s = _sock.readsome( _read_buffer, len, 0 );
     if( s % 16 ) 
@@ -116,10 +120,24 @@ size_t stcp_socket::readsome( char* buffer, size_t len )
     return s;
 } FC_RETHROW_EXCEPTIONS( warn, "", ("len",len) ) }
 
+/**
+ *   The caller's buffer is kept alive by the shared_ptr for as long as the
+ *   socket may write into it, so the ciphertext is read straight into it
+ *   and decrypted in place.
+ */
 size_t stcp_socket::readsome( const std::shared_ptr<char>& buf, size_t len, size_t offset ) 
-{
-  return readsome(buf.get() + offset, len);
-}
+{ try {
+    assert( len > 0 && (len % 16) == 0 );
+
+    size_t s = _sock.readsome( buf, len, offset );
+    if( s % 16 )
+    {
+      _sock.read(buf, 16 - (s%16), offset + s);
+      s += 16-(s%16);
+    }
+    _recv_aes.decode( buf.get() + offset, s, buf.get() + offset );
+    return s;
+} FC_RETHROW_EXCEPTIONS( warn, "", ("len",len)("offset",offset) ) }
 
 bool stcp_socket::eof()const
 {
@@ -141,11 +159,8 @@ size_t stcp_socket::writesome( const char* buffer, size_t len )
     } buffer_in_use_checker(_write_buffer_in_use);
 #endif
 
-    const std::size_t write_buffer_length = 4096;
-    if (!_write_buffer)
-      _write_buffer.reset(new char[write_buffer_length], [](char* p){ delete[] p; });
-    len = std::min<size_t>(write_buffer_length, len);
-    memset(_write_buffer.get(), 0, len); // just in case aes.encode screws up
+    get_buffer( _write_buffer );
+    len = std::min<size_t>(_buffer_size, len);
     /**
      * every sizeof(crypt_buf) bytes the aes channel
      * has an error and doesn't decrypt properly...  disable
@@ -163,6 +178,77 @@ size_t stcp_socket::writesome( const std::shared_ptr<const char>& buf, size_t le
   return writesome(buf.get() + offset, len);
 }
 
+size_t stcp_socket::write_segments( const std::vector<segment>& segments )
+{ try {
+#ifndef NDEBUG
+    struct check_buffer_in_use {
+      bool& _buffer_in_use;
+      check_buffer_in_use(bool& buffer_in_use) : _buffer_in_use(buffer_in_use) { assert(!_buffer_in_use); _buffer_in_use = true; }
+      ~check_buffer_in_use() { assert(_buffer_in_use); _buffer_in_use = false; }
+    } buffer_in_use_checker(_write_buffer_in_use);
+#endif
+
+    char* const ciphertext = get_buffer( _write_buffer );
+    size_t ciphertext_len = 0; // encrypted bytes waiting in _write_buffer
+    size_t bytes_written = 0;
+
+    // plaintext that straddles segments is gathered here until it fills an aes block
+    char block[16];
+    size_t block_len = 0;
+
+    auto reserve = [&]() {
+      if( ciphertext_len + sizeof(block) > _buffer_size )
+      {
+        _sock.write( _write_buffer, ciphertext_len );
+        bytes_written += ciphertext_len;
+        ciphertext_len = 0;
+      }
+    };
+
+    for( const segment& seg : segments )
+    {
+      if( !seg.size )
+        continue;
+      const char* data = seg.data;
+      size_t remaining = seg.size;
+      if( block_len )
+      {
+        size_t n = std::min( sizeof(block) - block_len, remaining );
+        memcpy( block + block_len, data, n );
+        block_len += n;
+        data += n;
+        remaining -= n;
+        if( block_len < sizeof(block) )
+          continue;
+        reserve();
+        ciphertext_len += _send_aes.encode( block, sizeof(block), ciphertext + ciphertext_len );
+        block_len = 0;
+      }
+      while( remaining >= sizeof(block) )
+      {
+        reserve();
+        size_t n = std::min( remaining, _buffer_size - ciphertext_len ) & ~size_t(15);
+        ciphertext_len += _send_aes.encode( data, n, ciphertext + ciphertext_len );
+        data += n;
+        remaining -= n;
+      }
+      memcpy( block, data, remaining );
+      block_len = remaining;
+    }
+    if( block_len )
+    {
+      memset( block + block_len, 0, sizeof(block) - block_len );
+      reserve();
+      ciphertext_len += _send_aes.encode( block, sizeof(block), ciphertext + ciphertext_len );
+    }
+    if( ciphertext_len )
+    {
+      _sock.write( _write_buffer, ciphertext_len );
+      bytes_written += ciphertext_len;
+    }
+    return bytes_written;
+} FC_RETHROW_EXCEPTIONS( warn, "", ("segments",segments.size()) ) }
+
 void stcp_socket::flush()
 {
   _sock.flush();
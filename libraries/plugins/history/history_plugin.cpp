@@ -23,6 +23,7 @@
  */
 
 #include <graphene/history/history_plugin.hpp>
+#include <graphene/history/operation_history_store.hpp>
 
 #include <graphene/app/impacted.hpp>
 
@@ -39,6 +40,8 @@
 
 #include <fc/thread/thread.hpp>
 
+#include <boost/filesystem/path.hpp>
+
 namespace graphene { namespace history {
 
 namespace detail
@@ -57,12 +60,27 @@ class history_plugin_impl
        */
       void update_histories(const signed_block& b);
 
+      /**
+       * Moves operations of irreversible blocks and their account history links
+       * from the object database to the history store.
+       */
+      void archive_irreversible_history();
+
+      /** Drops the links of the newer entry and the statistics of the account to an archived entry. */
+      void unlink_account_history(const account_transaction_history_object& ath);
+
       graphene::chain::database& database() {
          return _self.database();
       }
 
       history_plugin& _self;
       flat_set<account_id_type> _tracked_accounts;
+
+      operation_history_store _store;
+      fc::path _store_dir;
+      uint64_t _store_segment_size = 256;
+      /** limits the work done in one block when a node with existing history enables the store */
+      uint32_t _max_archived_per_block = 10000;
 };
 
 history_plugin_impl::~history_plugin_impl() {
@@ -74,6 +92,11 @@ void history_plugin_impl::update_histories(const signed_block& b)
    graphene::chain::database& db = database();
    const vector<optional<operation_history_object>>& hist = db.get_applied_operations();
 
+   // cleared for every operation, so that their memory is only allocated once per block
+   flat_set<account_id_type> impacted_acc;
+   flat_set<fund_id_type> impacted_funds;
+   vector<authority> other;
+
    for (const optional<operation_history_object>& o_op: hist)
    {
       // add to the operation history index
@@ -101,10 +124,9 @@ void history_plugin_impl::update_histories(const signed_block& b)
       const operation_history_object& op = *o_op;
 
       // get the set of accounts this operation applies to
-      flat_set<account_id_type> impacted_acc;
-      flat_set<fund_id_type> impacted_funds;
-
-      vector<authority> other;
+      impacted_acc.clear();
+      impacted_funds.clear();
+      other.clear();
       operation_get_required_authorities(op.op, impacted_acc, impacted_acc, other);
 
 //      //////// hidden operations
@@ -277,6 +299,71 @@ void history_plugin_impl::update_histories(const signed_block& b)
       }
    }
 }
+
+void history_plugin_impl::archive_irreversible_history()
+{
+   graphene::chain::database& db = database();
+   // issue_bonuses_old() walks the account histories of the last day until HARDFORK_617_TIME
+   if (db.head_block_time() <= HARDFORK_617_TIME) {
+      return;
+   }
+   const uint32_t last_irreversible_block = db.get_dynamic_global_properties().last_irreversible_block_num;
+
+   const auto& op_idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
+   const auto& ath_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>();
+
+   uint32_t archived = 0;
+   vector<std::pair<account_id_type, uint32_t>> accounts;
+   // account history links are created right after their operation, so they are ordered by operation id too;
+   // links to operations which were already removed from the database are dropped with them
+   auto ath_itr = ath_idx.begin();
+   auto op_itr = op_idx.begin();
+   while ( (op_itr != op_idx.end()) && (op_itr->block_num <= last_irreversible_block) && (archived < _max_archived_per_block) )
+   {
+      const operation_history_object& op = *op_itr++;
+
+      accounts.clear();
+      while ( (ath_itr != ath_idx.end()) && (ath_itr->operation_id.instance.value <= op.id.instance()) )
+      {
+         const account_transaction_history_object& ath = *ath_itr++;
+         if (ath.operation_id == op.id) {
+            accounts.emplace_back(ath.account, ath.sequence);
+         }
+         unlink_account_history(ath);
+         db.prune(ath);
+      }
+
+      _store.append(op, accounts);
+      db.prune(op);
+      ++archived;
+   }
+
+   if (archived > 0) {
+      _store.flush();
+   }
+}
+
+void history_plugin_impl::unlink_account_history(const account_transaction_history_object& ath)
+{
+   graphene::chain::database& db = database();
+
+   // archived entries are the oldest of their account, so only the entry with the next sequence links to them;
+   // the links are dropped without undo like the entry itself, readers continue in the history store
+   const auto& seq_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_seq>();
+   auto newer = seq_idx.find(boost::make_tuple(ath.account, ath.sequence + 1));
+   if ( (newer != seq_idx.end()) && (newer->next == ath.id) ) {
+      db.modify_without_undo(*newer, [](account_transaction_history_object& obj) {
+         obj.next = account_transaction_history_id_type();
+      });
+   }
+
+   const auto& stats_obj = ath.account(db).statistics(db);
+   if (stats_obj.most_recent_op == ath.id) {
+      db.modify_without_undo(stats_obj, [](account_statistics_object& obj) {
+         obj.most_recent_op = account_transaction_history_id_type();
+      });
+   }
+}
 } // end namespace detail
 
 history_plugin::history_plugin() :
@@ -294,25 +381,60 @@ void history_plugin::plugin_set_program_options(
 {
    cli.add_options()
          ("track-account", boost::program_options::value<std::vector<std::string>>()->composing()->multitoken(), "Account ID to track history for (may specify multiple times)")
+         ("history-store-dir", boost::program_options::value<boost::filesystem::path>(), "Keep irreversible operation history on disk in this directory instead of RAM (relative to data-dir)")
+         ("history-store-segment-size", boost::program_options::value<uint64_t>()->default_value(256), "Size of one history store segment file in MB")
          ;
    cfg.add(cli);
 }
 
 void history_plugin::plugin_initialize(const boost::program_options::variables_map& options)
 {
-   database().applied_block.connect( [&]( const signed_block& b){ my->update_histories(b); } );
+   database().applied_block.connect( [&]( const signed_block& b){
+      GRAPHENE_BLOCK_OBSERVER_TIMER( database().get_block_timing(), "history" );
+      my->update_histories(b);
+   } );
+   // irreversible operations are only moved to the history store between blocks, so that they are not
+   // restored by an undo session which does not know about the store
+   database().committed_block.connect( [&]( const signed_block& b){
+      if (my->_store.is_open()) {
+         my->archive_irreversible_history();
+      }
+   } );
 
    database().add_index<primary_index<operation_history_index>>();
    database().add_index<primary_index<account_transaction_history_index>>();
    database().add_index<primary_index<fund_transaction_history_index>>();
 
    LOAD_VALUE_SET(options, "track-account", my->_tracked_accounts, graphene::chain::account_id_type);
+
+   if (options.count("history-store-dir"))
+   {
+      my->_store_dir = options.at("history-store-dir").as<boost::filesystem::path>();
+      if (my->_store_dir.is_relative() && options.count("data-dir")) {
+         my->_store_dir = fc::path(options.at("data-dir").as<boost::filesystem::path>()) / my->_store_dir;
+      }
+      my->_store_segment_size = options.at("history-store-segment-size").as<uint64_t>();
+   }
 }
 
-void history_plugin::plugin_startup() { }
+void history_plugin::plugin_startup()
+{
+   if (my->_store_dir != fc::path()) {
+      my->_store.open(my->_store_dir, my->_store_segment_size * 1024 * 1024);
+   }
+}
+
+void history_plugin::plugin_shutdown()
+{
+   my->_store.close();
+}
 
 flat_set<account_id_type> history_plugin::tracked_accounts() const {
    return my->_tracked_accounts;
 }
 
+operation_history_store* history_plugin::history_store() const {
+   return my->_store.is_open() ? &my->_store : nullptr;
+}
+
 } }
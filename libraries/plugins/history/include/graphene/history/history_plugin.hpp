@@ -61,6 +61,8 @@ namespace detail
    class history_plugin_impl;
 }
 
+class operation_history_store;
+
 class history_plugin : public graphene::app::plugin
 {
    public:
@@ -73,9 +75,13 @@ class history_plugin : public graphene::app::plugin
          boost::program_options::options_description& cfg) override;
       virtual void plugin_initialize(const boost::program_options::variables_map& options) override;
       virtual void plugin_startup() override;
+      virtual void plugin_shutdown() override;
 
       flat_set<account_id_type> tracked_accounts()const;
 
+      /** @return the on-disk store of irreversible history, or nullptr if history is kept in RAM only */
+      operation_history_store* history_store()const;
+
       friend class detail::history_plugin_impl;
       std::unique_ptr<detail::history_plugin_impl> my;
 };
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/db/generic_index.hpp>
+#include <graphene/chain/operation_history_object.hpp>
+
+#include <fc/interprocess/file_mapping.hpp>
+
+#include <fstream>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
+namespace graphene { namespace chain { class database; } }
+
+namespace graphene { namespace history {
+   using namespace chain;
+
+   /**
+    * @brief Append-only on-disk storage of irreversible operation history
+    *
+    * Operations are appended to segment files of limited size, which are read back through
+    * memory mapped regions. An index file keeps the location of each operation and a postings
+    * file keeps the (account, operation, sequence) links which replace
+    * account_transaction_history_object for archived operations. Only the compact index
+    * and the per-account posting lists are kept in memory.
+    *
+    * Operations must be appended in increasing id order, appending an id which is not greater
+    * than @ref last_id is ignored, so replaying already archived blocks is harmless.
+    */
+   class operation_history_store
+   {
+      public:
+         struct account_entry
+         {
+            uint64_t operation = 0;
+            uint32_t sequence  = 0;
+         };
+
+         operation_history_store();
+         ~operation_history_store();
+
+         void open( const fc::path& dir, uint64_t segment_size );
+         bool is_open()const;
+         void flush();
+         void close();
+
+         /**
+          * @param op the irreversible operation
+          * @param accounts impacted accounts with the sequence of the operation in their history
+          */
+         void append( const operation_history_object& op, const vector<std::pair<account_id_type, uint32_t>>& accounts );
+
+         /** @return id of the most recent archived operation, or default id if the store is empty */
+         operation_history_id_type last_id()const;
+         /** @return number of archived operations */
+         size_t size()const { return _index.size(); }
+
+         bool contains( operation_history_id_type id )const;
+         /** reads map segment files on demand, so they are not const */
+         optional<operation_history_object> fetch( operation_history_id_type id );
+         /** @return the archived operation at @p pos, positions are in id order */
+         operation_history_object fetch_by_position( size_t pos );
+         /** @return position of the first archived operation with id not less than @p id */
+         size_t lower_bound( operation_history_id_type id )const;
+
+         /** @return archived history of the account, oldest first */
+         const vector<account_entry>& account_history( account_id_type account )const;
+
+      private:
+         struct index_entry
+         {
+            uint64_t operation = 0;
+            uint64_t position  = 0;
+            uint32_t segment   = 0;
+            uint32_t size      = 0;
+         };
+
+         struct posting_entry
+         {
+            uint64_t account   = 0;
+            uint64_t operation = 0;
+            uint32_t sequence  = 0;
+            uint32_t reserved  = 0;
+         };
+
+         struct mapped_segment
+         {
+            mapped_segment( const fc::path& p, uint64_t size );
+
+            fc::file_mapping  mapping;
+            fc::mapped_region region;
+         };
+
+         fc::path segment_path( uint32_t segment )const;
+         void     open_segment( uint32_t segment );
+         operation_history_object read( const index_entry& entry );
+
+         fc::path                                                 _dir;
+         uint64_t                                                 _segment_size = 0;
+         uint32_t                                                 _segment = 0;
+         std::fstream                                             _ops;
+         std::fstream                                             _index_file;
+         std::fstream                                             _postings;
+
+         vector<index_entry>                                      _index;
+         std::unordered_map<uint64_t, vector<account_entry>>      _accounts;
+         std::map<uint32_t, std::unique_ptr<mapped_segment>>      _mapped;
+   };
+
+   /**
+    * Visits operations of the account from the most recent to the oldest, reversible ones from the
+    * object database and then the irreversible ones from @p store, which may be null. The walk stops
+    * when @p visit returns false.
+    */
+   void visit_account_history( const database& db, operation_history_store* store, account_id_type account,
+                               const std::function<bool(const operation_history_object&)>& visit );
+
+} } // graphene::history
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/history/operation_history_store.hpp>
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace graphene { namespace history {
+
+operation_history_store::mapped_segment::mapped_segment( const fc::path& p, uint64_t size )
+   : mapping( p.generic_string().c_str(), fc::read_only ),
+     region( mapping, fc::read_only, 0, size ) { }
+
+operation_history_store::operation_history_store() { }
+
+operation_history_store::~operation_history_store()
+{
+   close();
+}
+
+void operation_history_store::open( const fc::path& dir, uint64_t segment_size )
+{ try {
+   FC_ASSERT( segment_size > 0 );
+   fc::create_directories( dir );
+   _dir = dir;
+   _segment_size = segment_size;
+
+   auto open_file = [&]( std::fstream& f, const fc::path& p )
+   {
+      f.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+      if( !fc::exists( p ) )
+         f.open( p.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc );
+      else
+         f.open( p.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out );
+   };
+
+   // the index is written last for every operation, so it decides which operations were stored completely
+   open_file( _index_file, dir / "index" );
+   _index_file.seekg( 0, _index_file.end );
+   uint64_t index_count = uint64_t( _index_file.tellg() ) / sizeof( index_entry );
+   _index.resize( index_count );
+   if( index_count > 0 )
+   {
+      _index_file.seekg( 0 );
+      _index_file.read( (char*)_index.data(), index_count * sizeof( index_entry ) );
+   }
+   _index_file.seekp( index_count * sizeof( index_entry ) );
+
+   open_file( _postings, dir / "postings" );
+   _postings.seekg( 0, _postings.end );
+   uint64_t postings_count = uint64_t( _postings.tellg() ) / sizeof( posting_entry );
+   const uint64_t last = last_id().instance.value;
+   uint64_t valid_postings = 0;
+   _postings.seekg( 0 );
+   for( uint64_t i = 0; i < postings_count; ++i )
+   {
+      posting_entry e;
+      _postings.read( (char*)&e, sizeof( e ) );
+      if( index_count == 0 || e.operation > last )
+         break;
+      account_entry a;
+      a.operation = e.operation;
+      a.sequence  = e.sequence;
+      _accounts[e.account].push_back( a );
+      ++valid_postings;
+   }
+   _postings.seekp( valid_postings * sizeof( posting_entry ) );
+
+   open_segment( _index.empty() ? 0 : _index.back().segment );
+
+   ilog( "Opened operation history store at ${d} with ${n} operations of ${a} accounts",
+         ("d", dir.generic_string())("n", _index.size())("a", _accounts.size()) );
+} FC_CAPTURE_AND_RETHROW( (dir) ) }
+
+bool operation_history_store::is_open()const
+{
+   return _ops.is_open();
+}
+
+void operation_history_store::flush()
+{
+   if( !is_open() )
+      return;
+   _ops.flush();
+   _postings.flush();
+   _index_file.flush();
+}
+
+void operation_history_store::close()
+{
+   if( !is_open() )
+      return;
+   flush();
+   _mapped.clear();
+   _ops.close();
+   _postings.close();
+   _index_file.close();
+   _index.clear();
+   _accounts.clear();
+}
+
+fc::path operation_history_store::segment_path( uint32_t segment )const
+{
+   std::ostringstream name;
+   name << "operations." << std::setw( 6 ) << std::setfill( '0' ) << segment;
+   return _dir / name.str();
+}
+
+void operation_history_store::open_segment( uint32_t segment )
+{
+   if( _ops.is_open() )
+   {
+      _ops.flush();
+      _ops.close();
+   }
+   _segment = segment;
+   const fc::path p = segment_path( segment );
+   _ops.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+   if( !fc::exists( p ) )
+      _ops.open( p.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc );
+   else
+      _ops.open( p.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out );
+   _ops.seekp( 0, _ops.end );
+}
+
+void operation_history_store::append( const operation_history_object& op,
+                                      const vector<std::pair<account_id_type, uint32_t>>& accounts )
+{ try {
+   FC_ASSERT( is_open() );
+   if( !_index.empty() && op.id.instance() <= _index.back().operation )
+      return;
+
+   if( uint64_t( _ops.tellp() ) >= _segment_size )
+      open_segment( _segment + 1 );
+
+   const auto vec = fc::raw::pack( op );
+   index_entry e;
+   e.operation = op.id.instance();
+   e.position  = _ops.tellp();
+   e.segment   = _segment;
+   e.size      = vec.size();
+   _ops.write( vec.data(), vec.size() );
+
+   for( const auto& item: accounts )
+   {
+      posting_entry p;
+      p.account   = item.first.instance.value;
+      p.operation = e.operation;
+      p.sequence  = item.second;
+      _postings.write( (const char*)&p, sizeof( p ) );
+
+      account_entry a;
+      a.operation = p.operation;
+      a.sequence  = p.sequence;
+      _accounts[p.account].push_back( a );
+   }
+
+   _index_file.write( (const char*)&e, sizeof( e ) );
+   _index.push_back( e );
+} FC_CAPTURE_AND_RETHROW( (op.id) ) }
+
+operation_history_id_type operation_history_store::last_id()const
+{
+   if( _index.empty() )
+      return operation_history_id_type();
+   return operation_history_id_type( _index.back().operation );
+}
+
+size_t operation_history_store::lower_bound( operation_history_id_type id )const
+{
+   const uint64_t instance = id.instance.value;
+   auto itr = std::lower_bound( _index.begin(), _index.end(), instance,
+                                []( const index_entry& e, uint64_t v ) { return e.operation < v; } );
+   return itr - _index.begin();
+}
+
+bool operation_history_store::contains( operation_history_id_type id )const
+{
+   size_t pos = lower_bound( id );
+   return pos < _index.size() && _index[pos].operation == id.instance.value;
+}
+
+optional<operation_history_object> operation_history_store::fetch( operation_history_id_type id )
+{
+   size_t pos = lower_bound( id );
+   if( pos >= _index.size() || _index[pos].operation != id.instance.value )
+      return optional<operation_history_object>();
+   return read( _index[pos] );
+}
+
+operation_history_object operation_history_store::fetch_by_position( size_t pos )
+{
+   FC_ASSERT( pos < _index.size() );
+   return read( _index[pos] );
+}
+
+const vector<operation_history_store::account_entry>& operation_history_store::account_history( account_id_type account )const
+{
+   static const vector<account_entry> empty;
+   auto itr = _accounts.find( account.instance.value );
+   if( itr == _accounts.end() )
+      return empty;
+   return itr->second;
+}
+
+operation_history_object operation_history_store::read( const index_entry& entry )
+{ try {
+   auto& seg = _mapped[entry.segment];
+   // the active segment grows, it is mapped again once a read goes past the mapped size
+   if( !seg || seg->region.get_size() < entry.position + entry.size )
+   {
+      seg.reset();
+      seg.reset( new mapped_segment( segment_path( entry.segment ), fc::file_size( segment_path( entry.segment ) ) ) );
+      FC_ASSERT( seg->region.get_size() >= entry.position + entry.size, "Operation history segment is truncated" );
+   }
+
+   fc::datastream<const char*> ds( (const char*)seg->region.get_address() + entry.position, entry.size );
+   operation_history_object result;
+   fc::raw::unpack( ds, result );
+   return result;
+} FC_CAPTURE_AND_RETHROW( (entry.operation)(entry.segment)(entry.position) ) }
+
+void visit_account_history( const database& db, operation_history_store* store, account_id_type account,
+                            const std::function<bool(const operation_history_object&)>& visit )
+{
+   const auto& stats = account(db).statistics(db);
+
+   // operations of reversible blocks are linked in the object database, links to archived or pruned
+   // objects end the walk there
+   uint64_t oldest_visited = std::numeric_limits<uint64_t>::max();
+   const account_transaction_history_object* node = nullptr;
+   if( stats.most_recent_op != account_transaction_history_id_type() )
+      node = db.find( stats.most_recent_op );
+   while( node )
+   {
+      const operation_history_object* hist = db.find( node->operation_id );
+      if( !hist )
+         break;
+      oldest_visited = node->operation_id.instance.value;
+      if( !visit( *hist ) )
+         return;
+
+      if( node->next == account_transaction_history_id_type() )
+         node = nullptr;
+      else
+         node = db.find( node->next );
+   }
+
+   // the irreversible rest is archived in the history store
+   if( !store )
+      return;
+   const auto& entries = store->account_history( account );
+   for( auto rit = entries.rbegin(); rit != entries.rend(); ++rit )
+   {
+      if( rit->operation >= oldest_visited )
+         continue;
+      optional<operation_history_object> hist = store->fetch( operation_history_id_type( rit->operation ) );
+      if( !hist.valid() || !visit( *hist ) )
+         return;
+   }
+}
+
+} } // graphene::history
@@ -135,8 +135,8 @@ namespace detail
 
 /**
  *  The market history plugin can be configured to track any number of intervals via its configuration.  Once per block it
- *  will scan the virtual operations and look for fill_order_operations and then adjust the appropriate bucket objects for
- *  each fill order.
+ *  will scan the virtual operations and look for fill_order_operations, aggregate the fills of each market in memory and
+ *  then adjust the appropriate bucket objects once for each market.
  */
 class market_history_plugin : public graphene::app::plugin
 {
@@ -63,13 +63,37 @@ class market_history_plugin_impl
 };
 
 
+/** the fills of one market in a block, aggregated the way a bucket aggregates them */
+struct market_fills
+{
+   price      open;
+   price      close;
+   price      high;
+   price      low;
+   share_type base_volume;
+   share_type quote_volume;
+};
+
+typedef std::pair<asset_id_type,asset_id_type> market_type;
+
+/**
+ * Collects the fills of a block, so that the order history of a market is pruned and each of its buckets
+ * is written once per block instead of once per fill.
+ */
+struct market_history_updates
+{
+   /// the sequence of the newest order history object of every market filled in the block
+   flat_map<market_type,int64_t>      newest_sequences;
+   flat_map<market_type,market_fills> fills;
+};
+
 struct operation_process_fill_order
 {
-   market_history_plugin&    _plugin;
-   fc::time_point_sec        _now;
+   graphene::chain::database& _db;
+   market_history_updates&    _updates;
 
-   operation_process_fill_order( market_history_plugin& mhp, fc::time_point_sec n )
-   :_plugin(mhp),_now(n) {}
+   operation_process_fill_order( graphene::chain::database& db, market_history_updates& updates )
+   :_db(db),_updates(updates) {}
 
    typedef void result_type;
 
@@ -80,150 +104,166 @@ struct operation_process_fill_order
    void operator()( const fill_order_operation& o )const 
    {
       //ilog( "processing ${o}", ("o",o) );
-      const auto& buckets = _plugin.tracked_buckets();
-      auto& db         = _plugin.database();
-      const auto& bucket_idx = db.get_index_type<bucket_index>();
-      const auto& history_idx = db.get_index_type<history_index>().indices().get<by_key>();
-
-      auto time = db.head_block_time();
-
       history_key hkey;
       hkey.base = o.pays.asset_id;
       hkey.quote = o.receives.asset_id;
       if( hkey.base > hkey.quote ) 
          std::swap( hkey.base, hkey.quote );
-      hkey.sequence = std::numeric_limits<int64_t>::min();
-
-      auto itr = history_idx.lower_bound( hkey );
 
-      if( itr->key.base == hkey.base && itr->key.quote == hkey.quote )
-         hkey.sequence = itr->key.sequence - 1;
+      auto newest = _updates.newest_sequences.find( market_type( hkey.base, hkey.quote ) );
+      if( newest == _updates.newest_sequences.end() )
+      {
+         const auto& history_idx = _db.get_index_type<history_index>().indices().get<by_key>();
+         hkey.sequence = std::numeric_limits<int64_t>::min();
+         auto itr = history_idx.lower_bound( hkey );
+         if( itr != history_idx.end() && itr->key.base == hkey.base && itr->key.quote == hkey.quote )
+            hkey.sequence = itr->key.sequence - 1;
+         else
+            hkey.sequence = 0;
+         _updates.newest_sequences[ market_type( hkey.base, hkey.quote ) ] = hkey.sequence;
+      }
       else
-         hkey.sequence = 0;
+         hkey.sequence = --newest->second;
 
-      db.create<order_history_object>( [&]( order_history_object& ho ) {
+      _db.create<order_history_object>( [&]( order_history_object& ho ) {
          ho.key = hkey;
-         ho.time = time;
+         ho.time = _db.head_block_time();
          ho.op = o;
       });
 
-      hkey.sequence += 200;
-      itr = history_idx.lower_bound( hkey );
-
-      while( itr != history_idx.end() )
+      /** for every matched order there are two fill order operations created, one for
+       * each side.  We can filter the duplicates by only considering the fill operations where
+       * the base > quote
+       */
+      if( o.pays.asset_id > o.receives.asset_id )
       {
-         if( itr->key.base == hkey.base && itr->key.quote == hkey.quote )
-         {
-            db.remove( *itr );
-            itr = history_idx.lower_bound( hkey );
-         }
-         else break;
+         //ilog( "     skipping because base > quote" );
+         return;
       }
 
+      price trade_price = o.pays / o.receives;
 
-      auto max_history = _plugin.max_history();
-      for( auto bucket : buckets )
+      auto fills = _updates.fills.find( market_type( o.pays.asset_id, o.receives.asset_id ) );
+      if( fills == _updates.fills.end() )
       {
-          auto cutoff      = (fc::time_point() + fc::seconds( bucket * max_history));
+         market_fills& f = _updates.fills[ market_type( o.pays.asset_id, o.receives.asset_id ) ];
+         f.open = f.close = f.high = f.low = trade_price;
+         f.base_volume = trade_price.base.amount;
+         f.quote_volume = trade_price.quote.amount;
+         return;
+      }
 
-          bucket_key key;
-          key.base    = o.pays.asset_id;
-          key.quote   = o.receives.asset_id;
+      market_fills& f = fills->second;
+      f.base_volume += trade_price.base.amount;
+      f.quote_volume += trade_price.quote.amount;
+      f.close = trade_price;
+      if( f.high < trade_price )
+         f.high = trade_price;
+      if( f.low > trade_price )
+         f.low = trade_price;
+   }
+};
 
+market_history_plugin_impl::~market_history_plugin_impl()
+{}
 
-          /** for every matched order there are two fill order operations created, one for
-           * each side.  We can filter the duplicates by only considering the fill operations where
-           * the base > quote
-           */
-          if( key.base > key.quote ) 
-          {
-             //ilog( "     skipping because base > quote" );
-             continue;
-          }
+void market_history_plugin_impl::update_market_histories( const signed_block& b )
+{
+   if( _maximum_history_per_bucket_size == 0 ) return;
+   if( _tracked_buckets.size() == 0 ) return;
 
-          price trade_price = o.pays / o.receives;
+   graphene::chain::database& db = database();
+   market_history_updates updates;
+   const vector<optional< operation_history_object > >& hist = db.get_applied_operations();
+   for( const optional< operation_history_object >& o_op : hist )
+   {
+      if( o_op.valid() )
+         o_op->op.visit( operation_process_fill_order( db, updates ) );
+   }
 
+   // keep the 200 newest fills of every market
+   const auto& history_idx = db.get_index_type<history_index>().indices().get<by_key>();
+   for( const auto& newest : updates.newest_sequences )
+   {
+      history_key hkey;
+      hkey.base = newest.first.first;
+      hkey.quote = newest.first.second;
+      hkey.sequence = newest.second + 200;
+      auto itr = history_idx.lower_bound( hkey );
+      while( itr != history_idx.end() && itr->key.base == hkey.base && itr->key.quote == hkey.quote )
+      {
+         auto old_itr = itr;
+         ++itr;
+         db.remove( *old_itr );
+      }
+   }
+
+   const auto& by_key_idx = db.get_index_type<bucket_index>().indices().get<by_key>();
+   for( const auto& market : updates.fills )
+   {
+      const market_fills& f = market.second;
+      for( auto bucket : _tracked_buckets )
+      {
+          auto cutoff      = (fc::time_point() + fc::seconds( bucket * _maximum_history_per_bucket_size));
+
+          bucket_key key;
+          key.base    = market.first.first;
+          key.quote   = market.first.second;
           key.seconds = bucket;
-          key.open    = fc::time_point() + fc::seconds((_now.sec_since_epoch() / key.seconds) * key.seconds);
+          key.open    = fc::time_point() + fc::seconds((b.timestamp.sec_since_epoch() / key.seconds) * key.seconds);
 
-          const auto& by_key_idx = bucket_idx.indices().get<by_key>();
           auto itr = by_key_idx.find( key );
           if( itr == by_key_idx.end() )
           { // create new bucket
-            /* const auto& obj = */
             db.create<bucket_object>( [&]( bucket_object& b ){
                  b.key = key;
-                 b.quote_volume += trade_price.quote.amount;
-                 b.base_volume += trade_price.base.amount;
-                 b.open_base = trade_price.base.amount;
-                 b.open_quote = trade_price.quote.amount;
-                 b.close_base = trade_price.base.amount;
-                 b.close_quote = trade_price.quote.amount;
-                 b.high_base = b.close_base;
-                 b.high_quote = b.close_quote;
-                 b.low_base = b.close_base;
-                 b.low_quote = b.close_quote;
+                 b.base_volume = f.base_volume;
+                 b.quote_volume = f.quote_volume;
+                 b.open_base = f.open.base.amount;
+                 b.open_quote = f.open.quote.amount;
+                 b.close_base = f.close.base.amount;
+                 b.close_quote = f.close.quote.amount;
+                 b.high_base = f.high.base.amount;
+                 b.high_quote = f.high.quote.amount;
+                 b.low_base = f.low.base.amount;
+                 b.low_quote = f.low.quote.amount;
             });
-            //wlog( "    creating bucket ${b}", ("b",obj) );
           }
           else
           { // update existing bucket
-             //wlog( "    before updating bucket ${b}", ("b",*itr) );
              db.modify( *itr, [&]( bucket_object& b ){
-                  b.base_volume += trade_price.base.amount;
-                  b.quote_volume += trade_price.quote.amount;
-                  b.close_base = trade_price.base.amount;
-                  b.close_quote = trade_price.quote.amount;
-                  if( b.high() < trade_price ) 
+                  b.base_volume += f.base_volume;
+                  b.quote_volume += f.quote_volume;
+                  b.close_base = f.close.base.amount;
+                  b.close_quote = f.close.quote.amount;
+                  if( b.high() < f.high ) 
                   {
-                      b.high_base = b.close_base;
-                      b.high_quote = b.close_quote;
+                      b.high_base = f.high.base.amount;
+                      b.high_quote = f.high.quote.amount;
                   }
-                  if( b.low() > trade_price ) 
+                  if( b.low() > f.low ) 
                   {
-                      b.low_base = b.close_base;
-                      b.low_quote = b.close_quote;
+                      b.low_base = f.low.base.amount;
+                      b.low_quote = f.low.quote.amount;
                   }
              });
-             //wlog( "    after bucket bucket ${b}", ("b",*itr) );
           }
 
-          if( max_history != 0  )
+          key.open = fc::time_point_sec();
+          itr = by_key_idx.lower_bound( key );
+          while( itr != by_key_idx.end() && 
+                 itr->key.base == key.base && 
+                 itr->key.quote == key.quote && 
+                 itr->key.seconds == bucket && 
+                 itr->key.open < cutoff )
           {
-             key.open = fc::time_point_sec();
-             auto itr = by_key_idx.lower_bound( key );
-
-             while( itr != by_key_idx.end() && 
-                    itr->key.base == key.base && 
-                    itr->key.quote == key.quote && 
-                    itr->key.seconds == bucket && 
-                    itr->key.open < cutoff )
-             {
-              //  elog( "    removing old bucket ${b}", ("b", *itr) );
-                auto old_itr = itr;
-                ++itr;
-                db.remove( *old_itr );
-             }
+           //  elog( "    removing old bucket ${b}", ("b", *itr) );
+             auto old_itr = itr;
+             ++itr;
+             db.remove( *old_itr );
           }
       }
    }
-};
-
-market_history_plugin_impl::~market_history_plugin_impl()
-{}
-
-void market_history_plugin_impl::update_market_histories( const signed_block& b )
-{
-   if( _maximum_history_per_bucket_size == 0 ) return;
-   if( _tracked_buckets.size() == 0 ) return;
-
-   graphene::chain::database& db = database();
-   const vector<optional< operation_history_object > >& hist = db.get_applied_operations();
-   for( const optional< operation_history_object >& o_op : hist )
-   {
-      if( o_op.valid() )
-         o_op->op.visit( operation_process_fill_order( _self, b.timestamp ) );
-   }
 }
 
 } // end namespace detail
@@ -263,7 +303,10 @@ void market_history_plugin::plugin_set_program_options(
 
 void market_history_plugin::plugin_initialize(const boost::program_options::variables_map& options)
 { try {
-   database().applied_block.connect( [this]( const signed_block& b){ my->update_market_histories(b); } );
+   database().applied_block.connect( [this]( const signed_block& b){
+      GRAPHENE_BLOCK_OBSERVER_TIMER( database().get_block_timing(), "market_history" );
+      my->update_market_histories(b);
+   } );
    database().add_index< primary_index< bucket_index  > >();
    database().add_index< primary_index< history_index  > >();
 
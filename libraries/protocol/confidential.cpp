@@ -28,6 +28,24 @@
 
 namespace graphene { namespace protocol {
 
+namespace {
+
+/**
+ * asserts that no output's range proof admits a value above the maximum supply.  validate() runs on
+ * the chain thread, so the proofs are checked serially; blocks and transactions from the network are
+ * validated on the worker pool before, see transaction::validate()
+ */
+void validate_range_proofs( const vector<blind_output>& outputs )
+{
+   for( const auto& out : outputs )
+   {
+      auto info = fc::ecc::range_get_info( out.range_proof );
+      FC_ASSERT( info.max_value <= GRAPHENE_MAX_SHARE_SUPPLY );
+   }
+}
+
+} // anonymous namespace
+
 void transfer_to_blind_operation::validate()const
 {
    FC_ASSERT( fee.amount >= 0 );
@@ -51,13 +69,7 @@ void transfer_to_blind_operation::validate()const
    FC_ASSERT( fc::ecc::verify_sum( {public_c}, out, 0 ), "", ("net_public",net_public) );
 
    if( outputs.size() > 1 )
-   {
-      for( auto out : outputs )
-      {
-         auto info = fc::ecc::range_get_info( out.range_proof );
-         FC_ASSERT( info.max_value <= GRAPHENE_MAX_SHARE_SUPPLY );
-      }
-   }
+      validate_range_proofs( outputs );
 }
 
 share_type transfer_to_blind_operation::calculate_fee( const fee_parameters_type& k )const
@@ -120,13 +132,7 @@ void blind_transfer_operation::validate()const
    FC_ASSERT( fc::ecc::verify_sum( in, out, net_public ), "", ("net_public", net_public) );
 
    if( outputs.size() > 1 )
-   {
-      for( auto out : outputs )
-      {
-         auto info = fc::ecc::range_get_info( out.range_proof );
-         FC_ASSERT( info.max_value <= GRAPHENE_MAX_SHARE_SUPPLY );
-      }
-   }
+      validate_range_proofs( outputs );
 } FC_CAPTURE_AND_RETHROW( (*this) ) }
 
 share_type blind_transfer_operation::calculate_fee( const fee_parameters_type& k )const
@@ -87,7 +87,13 @@ namespace graphene { namespace protocol {
       /// Calculate the digest for a transaction
       digest_type         digest()const;
       transaction_id_type id()const;
+      /**
+       * Transactions with confidential operations are remembered by id once they pass, so that
+       * their range proofs and commitment sums are checked only once per process.
+       */
       void                validate() const;
+      /// @return true if validate() checks range proofs or commitment sums
+      bool                has_confidential_operations() const;
       /// Calculate the digest used for signature validation
       digest_type         sig_digest( const chain_id_type& chain_id )const;
 
@@ -26,6 +26,9 @@
 #include <graphene/protocol/fee_schedule.hpp>
 #include <graphene/protocol/pts_address.hpp>
 #include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
 
 #include <fc/io/raw.hpp>
 
@@ -53,11 +56,75 @@ digest_type transaction::sig_digest( const chain_id_type& chain_id )const
    return enc.result();
 }
 
+namespace {
+
+/**
+ * Ids of the transactions with confidential operations which passed validate(). validate() only
+ * looks at what the id covers, and a transaction is validated when it is pushed and again when the
+ * block containing it is applied. The oldest ids are forgotten first.
+ */
+class validated_transaction_cache
+{
+public:
+   bool contains( const transaction_id_type& id )
+   {
+      std::lock_guard<std::mutex> lock( _mutex );
+      return _ids.find( id ) != _ids.end();
+   }
+
+   void insert( const transaction_id_type& id )
+   {
+      std::lock_guard<std::mutex> lock( _mutex );
+      if( !_ids.insert( id ).second )
+         return;
+      _order.push_back( id );
+      if( _order.size() > max_size )
+      {
+         _ids.erase( _order.front() );
+         _order.pop_front();
+      }
+   }
+
+private:
+   static const size_t max_size = 100000;
+
+   std::mutex                              _mutex;
+   std::unordered_set<transaction_id_type> _ids;
+   std::deque<transaction_id_type>         _order;
+};
+
+validated_transaction_cache& validated_confidential_transactions()
+{
+   static validated_transaction_cache cache;
+   return cache;
+}
+
+} // anonymous namespace
+
+bool transaction::has_confidential_operations() const
+{
+   return std::any_of( operations.begin(), operations.end(), []( const operation& op ) {
+      return op.is_type<transfer_to_blind_operation>() || op.is_type<blind_transfer_operation>()
+          || op.is_type<transfer_from_blind_operation>();
+   } );
+}
+
 void transaction::validate() const
 {
    FC_ASSERT( operations.size() > 0, "A transaction must have at least one operation", ("trx",*this) );
+   if( !has_confidential_operations() )
+   {
+      for( const auto& op : operations )
+         operation_validate(op);
+      return;
+   }
+
+   const transaction_id_type trx_id = id();
+   if( validated_confidential_transactions().contains( trx_id ) )
+      return;
    for( const auto& op : operations )
-      operation_validate(op); 
+      operation_validate(op);
+   validated_confidential_transactions().insert( trx_id );
 }
 
 graphene::protocol::transaction_id_type graphene::protocol::transaction::id() const
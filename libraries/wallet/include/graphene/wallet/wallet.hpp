@@ -254,6 +254,23 @@ struct vesting_balance_object_with_info : public vesting_balance_object
    fc::time_point_sec allowed_withdraw_time;
 };
 
+/**
+ * One payout of @ref wallet_api::transfer_batch
+ */
+struct transfer_batch_entry
+{
+   string to;
+   string amount;
+   string memo;
+};
+
+struct transfer_batch_result
+{
+   vector<signed_transaction>                      transactions;
+   /// one result per transaction, in the same order, empty unless the batch was broadcast
+   vector<network_broadcast_api::broadcast_result> results;
+};
+
 namespace detail {
 class wallet_api_impl;
 }
@@ -447,6 +464,9 @@ class wallet_api
       std::pair<uint32_t, std::vector<account_id_type>>
       get_users_with_asset(const asset_id_type& asst, uint32_t start, uint32_t limit) const;
 
+      vector<account_id_type>
+      get_asset_holders(asset_id_type asset_id, account_id_type start, uint32_t limit) const;
+
       /** Returns information about the given asset.
        * @param asset_name_or_id the symbol or id of the asset in question
        * @returns the information about the asset stored in the block chain
@@ -798,6 +818,29 @@ class wallet_api
       std::pair<transaction_id_type, std::string>
       transfer2(string from, string to, string amount, string asset_symbol, string memo);
 
+      /** Transfer an asset from one account to many accounts.
+       *
+       * The fee schedule, the accounts and the head block are looked up once and kept until the next block, and the
+       * transactions are signed in parallel.  When broadcasting, the transactions are sent in batches as soon as
+       * they are signed, without waiting for the previous batch to be answered.
+       *
+       * @param from the name or id of the account sending the funds
+       * @param asset_symbol the symbol or id of the asset to send
+       * @param transfers the payouts, either a JSON array of objects with the fields "to", "amount" and
+       *                  optionally "memo", or the name of a file containing such an array or lines
+       *                  "to,amount[,memo]"
+       * @param operations_per_transaction how many transfers are put into each transaction at most, a transaction
+       *                                   also ends before it would exceed the maximum transaction size
+       * @param broadcast true to broadcast the transactions on the network
+       * @returns the signed transactions and, when broadcast, whether the node accepted each of them.  The
+       *          transactions of a batch which could not be sent are reported as rejected.
+       */
+      transfer_batch_result transfer_batch(string from,
+                                           string asset_symbol,
+                                           string transfers,
+                                           uint32_t operations_per_transaction,
+                                           bool broadcast = false);
+
       signed_transaction set_online_time( map<account_id_type, uint16_t> online_info);
       signed_transaction set_verification_is_required( account_id_type target, bool verification_is_required);
 
@@ -1728,6 +1771,9 @@ FC_REFLECT_DERIVED( graphene::wallet::vesting_balance_object_with_info, (graphen
 FC_REFLECT( graphene::wallet::operation_detail,
             (memo)(description)(op) )
 
+FC_REFLECT( graphene::wallet::transfer_batch_entry, (to)(amount)(memo) )
+FC_REFLECT( graphene::wallet::transfer_batch_result, (transactions)(results) )
+
 FC_API( graphene::wallet::wallet_api,
         (help)
         (gethelp)
@@ -1771,6 +1817,7 @@ FC_API( graphene::wallet::wallet_api,
         (cancel_order)
         (transfer)
         (transfer2)
+        (transfer_batch)
         (set_online_time)
         (set_verification_is_required)
         (set_account_limit_daily_volume)
@@ -1824,6 +1871,7 @@ FC_API( graphene::wallet::wallet_api,
         (get_user_count_by_ranks)
         (get_user_count_with_balances)
         (get_users_with_asset)
+        (get_asset_holders)
         (get_account_id)
         (get_block)
         (get_account_count)
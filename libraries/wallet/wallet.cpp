@@ -56,6 +56,7 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/thread/mutex.hpp>
 #include <fc/thread/scoped_lock.hpp>
+#include <fc/thread/parallel.hpp>
 #include <fc/rpc/api_connection.hpp>
 #include <fc/crypto/base58.hpp>
 #include <fc/popcount.hpp>
@@ -465,9 +466,29 @@ public:
    }
 
    void on_block_applied(const variant& block_id) {
+      // a running batch command keeps the chain data it started with, the cache is dropped when it finishes
+      if( _chain_cache_users > 0 )
+         _chain_cache_stale = true;
+      else
+         _chain_cache = chain_cache();
       fc::async([this]{resync();}, "Resync after block");
    }
 
+   /// keeps _chain_cache from being dropped by on_block_applied() while a batch command uses it
+   struct chain_cache_user
+   {
+      explicit chain_cache_user( wallet_api_impl& w ) : _w( w ) { ++_w._chain_cache_users; }
+      ~chain_cache_user()
+      {
+         if( --_w._chain_cache_users == 0 && _w._chain_cache_stale )
+         {
+            _w._chain_cache = chain_cache();
+            _w._chain_cache_stale = false;
+         }
+      }
+      wallet_api_impl& _w;
+   };
+
    bool copy_wallet_file(string destination_filename)
    {
       fc::path src_path = get_wallet_filename();
@@ -2550,6 +2571,272 @@ public:
 
    } FC_CAPTURE_AND_RETHROW( (from)(to)(amount)(asset_symbol)(memo)(broadcast) ) }
 
+   global_property_object get_cached_global_properties()
+   {
+      if( !_chain_cache.global_properties )
+         _chain_cache.global_properties = get_global_properties();
+      return *_chain_cache.global_properties;
+   }
+
+   dynamic_global_property_object get_cached_dynamic_global_properties()
+   {
+      if( !_chain_cache.dynamic_global_properties )
+         _chain_cache.dynamic_global_properties = get_dynamic_global_properties();
+      return *_chain_cache.dynamic_global_properties;
+   }
+
+   settings_object get_cached_settings()
+   {
+      if( !_chain_cache.settings )
+         _chain_cache.settings = get_object( settings_id_type(0) );
+      return *_chain_cache.settings;
+   }
+
+   /// looks up all accounts missing from the cache with at most two calls to the node
+   vector<account_object> get_cached_accounts( const vector<string>& names_or_ids )
+   {
+      // the result is taken from the answers of the node, the cache only fills in what it already knows
+      map<string, account_object> found;
+      vector<account_id_type>     missing_ids;
+      vector<string>              missing_names;
+      for( const string& name_or_id : names_or_ids )
+      {
+         FC_ASSERT( name_or_id.size() > 0 );
+         if( found.count( name_or_id ) )
+            continue;
+         auto cached = _chain_cache.accounts.find( name_or_id );
+         if( cached != _chain_cache.accounts.end() )
+            found.insert( *cached );
+         else if( auto id = maybe_id<account_id_type>( name_or_id ) )
+            missing_ids.push_back( *id );
+         else
+            missing_names.push_back( name_or_id );
+      }
+
+      if( !missing_ids.empty() )
+         for( const fc::optional<account_object>& rec : _remote_db->get_accounts( missing_ids ) )
+            if( rec )
+               found[ string( object_id_type( rec->id ) ) ] = *rec;
+      if( !missing_names.empty() )
+         for( const fc::optional<account_object>& rec : _remote_db->lookup_account_names( missing_names ) )
+            if( rec )
+               found[ rec->name ] = *rec;
+
+      vector<account_object> result;
+      result.reserve( names_or_ids.size() );
+      for( const string& name_or_id : names_or_ids )
+      {
+         auto itr = found.find( name_or_id );
+         FC_ASSERT( itr != found.end(), "Account ${a} does not exist", ("a", name_or_id) );
+         result.push_back( itr->second );
+      }
+      _chain_cache.accounts.insert( found.begin(), found.end() );
+      return result;
+   }
+
+   vector<transfer_batch_entry> parse_transfer_batch( const string& transfers ) const
+   {
+      string text = fc::trim( transfers );
+      if( text.empty() || text.front() != '[' )
+      {
+         FC_ASSERT( fc::exists( text ), "${f} is neither a JSON array nor an existing file", ("f", text) );
+         fc::read_file_contents( text, text );
+         text = fc::trim( text );
+      }
+      if( !text.empty() && text.front() == '[' )
+         return fc::json::from_string( text ).as<vector<transfer_batch_entry>>( 3 );
+
+      // one "to,amount[,memo]" per line, the memo may contain commas
+      vector<transfer_batch_entry> result;
+      std::istringstream lines( text );
+      string line;
+      while( std::getline( lines, line ) )
+      {
+         line = fc::trim( line );
+         if( line.empty() || line.front() == '#' )
+            continue;
+         const auto first = line.find( ',' );
+         FC_ASSERT( first != string::npos, "Expected to,amount[,memo] but got ${l}", ("l", line) );
+         const auto second = line.find( ',', first + 1 );
+         transfer_batch_entry entry;
+         entry.to = fc::trim( line.substr( 0, first ) );
+         entry.amount = fc::trim( line.substr( first + 1, second == string::npos ? string::npos : second - first - 1 ) );
+         if( second != string::npos )
+            entry.memo = line.substr( second + 1 );
+         result.push_back( entry );
+      }
+      return result;
+   }
+
+   transfer_batch_result transfer_batch(string from, string asset_symbol, string transfers,
+                                        uint32_t operations_per_transaction, bool broadcast)
+   { try {
+      FC_ASSERT( !self.is_locked() );
+      FC_ASSERT( operations_per_transaction > 0 );
+      const vector<transfer_batch_entry> entries = parse_transfer_batch( transfers );
+      chain_cache_user cache_user( *this );
+      FC_ASSERT( !entries.empty(), "No transfers given" );
+
+      const asset_object asset_obj = get_asset( asset_symbol );
+      const asset_object fee_asset_obj = get_asset( asset_obj.params.fee_paying_asset );
+      const global_property_object gprops = get_cached_global_properties();
+      const dynamic_global_property_object dyn_props = get_cached_dynamic_global_properties();
+      const settings_object settings = get_cached_settings();
+      const fee_schedule& fees = gprops.parameters.get_current_fees();
+      price ex_rate = fee_asset_obj.options.core_exchange_rate;
+      auto custom_fee = std::find_if( settings.transfer_fees.begin(), settings.transfer_fees.end(),
+                                      [&]( const chain::settings_fee& f ) {
+         return f.asset_id == asset_obj.params.fee_paying_asset;
+      });
+
+      vector<string> names_or_ids{ from };
+      for( const transfer_batch_entry& entry : entries )
+         names_or_ids.push_back( entry.to );
+      const vector<account_object> accounts = get_cached_accounts( names_or_ids );
+      const account_object& from_account = accounts.front();
+
+      // all transfers only need the active authority of the sender
+      vector<fc::ecc::private_key> signing_keys;
+      for( const public_key_type& key : from_account.active.get_keys() )
+      {
+         auto it = _keys.find( key );
+         if( it == _keys.end() )
+            continue;
+         fc::optional<fc::ecc::private_key> privkey = wif_to_key( it->second );
+         FC_ASSERT( privkey.valid(), "Malformed private key in _keys" );
+         signing_keys.push_back( *privkey );
+      }
+      FC_ASSERT( !signing_keys.empty(), "No active key of ${a} in the wallet", ("a", from_account.name) );
+      fc::optional<fc::ecc::private_key> memo_key;
+
+      // a transaction also ends before it would exceed the maximum transaction size, the packed size is
+      // counted with one signature per key and the operation count
+      signed_transaction prototype;
+      prototype.set_reference_block( dyn_props.head_block_id );
+      prototype.set_expiration( dyn_props.time );
+      prototype.signatures.resize( signing_keys.size() );
+      const size_t prototype_size = fc::raw::pack_size( prototype ) - fc::raw::pack_size( fc::unsigned_int( 0 ) );
+      const size_t max_transaction_size = gprops.parameters.maximum_transaction_size;
+      size_t operations_size = 0;
+
+      transfer_batch_result result;
+      for( size_t i = 0; i < entries.size(); ++i )
+      {
+         const account_object& to_account = accounts[i + 1];
+
+         transfer_operation xfer_op;
+         xfer_op.from = from_account.id;
+         xfer_op.to = to_account.id;
+         xfer_op.amount = asset_obj.amount_from_string( entries[i].amount );
+
+         if( entries[i].memo.size() )
+         {
+            if( !memo_key )
+               memo_key = get_private_key( from_account.options.memo_key );
+            xfer_op.memo = memo_data();
+            xfer_op.memo->from = from_account.options.memo_key;
+            xfer_op.memo->to = to_account.options.memo_key;
+            xfer_op.memo->set_message( *memo_key, to_account.options.memo_key, entries[i].memo );
+         }
+
+         operation op = xfer_op;
+         if( custom_fee != settings.transfer_fees.end() )
+         {
+            share_type amount = std::round( xfer_op.amount.amount.value * (custom_fee->percent / 100000.0) );
+            const asset calc_fee = fees.calculate_fee( xfer_op, ex_rate );
+            amount = (amount < calc_fee.amount) ? calc_fee.amount : amount;
+            op.get<transfer_operation>().fee = asset( amount, asset_obj.params.fee_paying_asset );
+         }
+         else
+            fees.set_fee( op, ex_rate );
+
+         const size_t op_size = fc::raw::pack_size( op );
+         FC_ASSERT( prototype_size + fc::raw::pack_size( fc::unsigned_int( 1 ) ) + op_size <= max_transaction_size,
+                    "The transfer to ${to} does not fit into a transaction", ("to", entries[i].to) );
+         if( result.transactions.empty()
+             || result.transactions.back().operations.size() >= operations_per_transaction
+             || prototype_size + fc::raw::pack_size( fc::unsigned_int( result.transactions.back().operations.size() + 1 ) )
+                + operations_size + op_size > max_transaction_size )
+         {
+            result.transactions.emplace_back();
+            operations_size = 0;
+         }
+         result.transactions.back().operations.push_back( std::move( op ) );
+         operations_size += op_size;
+      }
+
+      // the ids must be unique before signing, see sign_transaction()
+      fc::time_point_sec oldest_transaction_ids_to_track( dyn_props.time - fc::minutes(2) );
+      auto& by_time = _recently_generated_transactions.get<timestamp_index>();
+      by_time.erase( by_time.begin(), by_time.lower_bound( oldest_transaction_ids_to_track ) );
+      for( signed_transaction& tx : result.transactions )
+      {
+         tx.set_reference_block( dyn_props.head_block_id );
+         uint32_t expiration_time_offset = 0;
+         for( ;; )
+         {
+            tx.set_expiration( dyn_props.time + fc::seconds(30 + expiration_time_offset) );
+            graphene::chain::transaction_id_type this_transaction_id = tx.id();
+            if( _recently_generated_transactions.find( this_transaction_id ) == _recently_generated_transactions.end() )
+            {
+               _recently_generated_transactions.insert( recently_generated_transaction_record{ dyn_props.time,
+                                                                                               this_transaction_id } );
+               break;
+            }
+            ++expiration_time_offset;
+         }
+         tx.validate();
+      }
+
+      // each batch is sent as soon as it is signed, the next one is signed while the node applies it
+      const size_t batch_size = broadcast ? network_broadcast_api::max_broadcast_batch_size
+                                          : result.transactions.size();
+      vector<std::pair<size_t, fc::future<vector<network_broadcast_api::broadcast_result>>>> pending;
+      for( size_t begin = 0; begin < result.transactions.size(); begin += batch_size )
+      {
+         const size_t end = std::min( begin + batch_size, result.transactions.size() );
+         fc::parallel_for( begin, end, [&result,&signing_keys,this]( size_t i ) {
+            for( const fc::ecc::private_key& key : signing_keys )
+               result.transactions[i].sign( key, _chain_id );
+         } );
+         if( broadcast )
+         {
+            vector<signed_transaction> batch( result.transactions.begin() + begin, result.transactions.begin() + end );
+            pending.emplace_back( begin, fc::async( [this,batch]() {
+               return _remote_net_broadcast->broadcast_transactions( batch );
+            }, "transfer_batch broadcast" ) );
+         }
+      }
+      // a batch which could not be sent fails all of its transactions, the results of the others are kept
+      for( auto& p : pending )
+      {
+         const size_t begin = p.first;
+         const size_t end = std::min( begin + batch_size, result.transactions.size() );
+         try
+         {
+            const auto results = p.second.wait();
+            FC_ASSERT( results.size() == end - begin, "The node answered ${n} of ${m} transactions",
+                       ("n", results.size())("m", end - begin) );
+            result.results.insert( result.results.end(), results.begin(), results.end() );
+         }
+         catch( const fc::exception& e )
+         {
+            for( size_t i = begin; i < end; ++i )
+            {
+               network_broadcast_api::broadcast_result failed;
+               failed.id = result.transactions[i].id();
+               failed.error = e.to_string();
+               result.results.push_back( failed );
+            }
+         }
+      }
+      for( const auto& r : result.results )
+         if( r.error )
+            elog( "Transaction ${id} was rejected: ${e}", ("id", r.id.str())("e", *r.error) );
+
+      return result;
+   } FC_CAPTURE_AND_RETHROW( (from)(asset_symbol)(transfers)(operations_per_transaction)(broadcast) ) }
+
    std::pair<unsigned, vector<address>>
    get_account_addresses(const string& name_or_id, unsigned from, unsigned limit) {
       return _remote_db->get_account_addresses(name_or_id, from, limit);
@@ -3275,6 +3562,19 @@ public:
 
    mutable map<asset_id_type, asset_object> _asset_cache;
 
+   // chain data used by the batch commands, dropped whenever a block is applied
+   struct chain_cache
+   {
+      fc::optional<global_property_object>         global_properties;
+      fc::optional<dynamic_global_property_object> dynamic_global_properties;
+      fc::optional<settings_object>                settings;
+      map<string, account_object>                  accounts;
+   } _chain_cache;
+   /// number of running batch commands, see chain_cache_user
+   uint32_t _chain_cache_users = 0;
+   /// a block was applied while _chain_cache was in use
+   bool _chain_cache_stale = false;
+
 }; // wallet_api_impl
 
 std::string operation_printer::fee(const asset& a)const {
@@ -3872,6 +4172,11 @@ wallet_api::get_users_with_asset(const asset_id_type& asst, uint32_t start, uint
    return my->_remote_db->get_users_with_asset(asst, start, limit);
 }
 
+vector<account_id_type>
+wallet_api::get_asset_holders(asset_id_type asset_id, account_id_type start, uint32_t limit) const {
+   return my->_remote_db->get_asset_holders(asset_id, start, limit);
+}
+
 asset_object wallet_api::get_asset(string asset_name_or_id) const
 {
    auto a = my->find_asset(asset_name_or_id);
@@ -4094,6 +4399,12 @@ wallet_api::transfer2(string from, string to, string amount, string asset_symbol
    return std::make_pair(trx.id(), op_id);
 }
 
+transfer_batch_result wallet_api::transfer_batch(string from, string asset_symbol, string transfers,
+                                                 uint32_t operations_per_transaction, bool broadcast /* = false */)
+{
+   return my->transfer_batch(from, asset_symbol, transfers, operations_per_transaction, broadcast);
+}
+
 signed_transaction wallet_api::set_online_time( map<account_id_type, uint16_t> online_info ) {
    return my->set_online_time(online_info);
 }
@@ -69,6 +69,7 @@ int main(int argc, char** argv) {
             ("help,h", "Print this help message and exit.")
             ("data-dir,d", bpo::value<boost::filesystem::path>()->default_value("delayed_node_data_dir"), "Directory containing databases, configuration file, etc.")
             ("fast",  bpo::value<int>(), "Size of history in days")
+            ("fast-pruning-chunk", bpo::value<uint32_t>(), "Maximum number of old history objects pruned after each block (1000 by default)")
             ("trusted-node", bpo::value<std::string>(), "RPC endpoint of a trusted validating node")
             ;
 
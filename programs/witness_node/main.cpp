@@ -69,6 +69,7 @@ int main(int argc, char** argv) {
             ("data-dir,d", bpo::value<boost::filesystem::path>()->default_value("witness_node_data_dir"), "Directory containing databases, configuration file, etc.")
             ("key-path,K", bpo::value<boost::filesystem::path>()->default_value(""), "Path to file with EDC owner key")
             ("fast",  bpo::value<int>(0), "Size of history in days")
+            ("fast-pruning-chunk", bpo::value<uint32_t>(), "Maximum number of old history objects pruned after each block (1000 by default)")
             ;
 
       bpo::variables_map options;
@@ -226,7 +227,9 @@ void write_default_logging_config_to_stream(std::ostream& out)
           "# declare an appender named \"p2p\" that writes messages to p2p.log\n"
           "[log.file_appender.p2p]\n"
           "filename=logs/p2p/p2p.log\n"
-          "# filename can be absolute or relative to this config file\n\n"
+          "# filename can be absolute or relative to this config file\n"
+          "# async=true writes the file from a background thread, lines which do not\n"
+          "# fit into its queue are dropped and counted\n\n"
           "# route any messages logged to the default logger to the \"stderr\" logger we\n"
           "# declared above, if they are info level are higher\n"
           "[logger.default]\n"
@@ -286,10 +289,11 @@ fc::optional<fc::logging_config> load_logging_config_from_ini_file(const fc::pat
             
 
             // construct a default file appender config here
-            // filename will be taken from ini file, everything else hard-coded here
+            // filename and async will be taken from ini file, everything else hard-coded here
             fc::file_appender::config file_appender_config;
             file_appender_config.filename = file_name;
             file_appender_config.flush = true;
+            file_appender_config.async = section_tree.get<bool>("async", false);
             file_appender_config.rotate = true;
             file_appender_config.rotation_interval = fc::hours(1);
             file_appender_config.rotation_limit = fc::days(1);
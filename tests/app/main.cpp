@@ -23,6 +23,7 @@
  */
 
 
+#include <graphene/app/api.hpp>
 #include <graphene/app/application.hpp>
 #include <graphene/app/plugin.hpp>
 #include <graphene/chain/balance_object.hpp>
@@ -180,3 +181,254 @@ BOOST_AUTO_TEST_CASE( two_node_network )
    }
 
 }
+
+BOOST_AUTO_TEST_CASE( sync_throughput )
+{
+   using namespace graphene::chain;
+   using namespace graphene::app;
+   try {
+      BOOST_TEST_MESSAGE( "=== sync_throughput ===" );
+      const uint32_t block_count = 1000;
+
+      fc::temp_directory app_dir( graphene::utilities::temp_directory_path() );
+      fc::temp_directory app2_dir( graphene::utilities::temp_directory_path() );
+
+      // the chain starts far enough in the past for all of its blocks to be in the past as well
+      genesis_state_type genesis_state = graphene::app::detail::create_example_genesis();
+      genesis_state.initial_timestamp -= ( block_count + 10 ) * genesis_state.initial_parameters.block_interval;
+      boost::filesystem::path genesis_path = boost::filesystem::path{ app_dir.path().generic_string() } / "genesis.json";
+      fc::json::save_to_file( genesis_state, fc::path( genesis_path ) );
+
+      graphene::app::application app1;
+      boost::program_options::variables_map cfg;
+      // the nodes listen on ephemeral ports, so that the test does not collide with other nodes on the host
+      cfg.emplace("p2p-endpoint", boost::program_options::variable_value(string("127.0.0.1:0"), false));
+      cfg.emplace("genesis-json", boost::program_options::variable_value(genesis_path, false));
+      cfg.emplace("seed-nodes", boost::program_options::variable_value(string("[]"), false));
+      app1.initialize(app_dir.path(), cfg);
+      app1.startup();
+
+      BOOST_TEST_MESSAGE( "Generating " + std::to_string( block_count ) + " blocks on app1" );
+      std::shared_ptr<chain::database> db1 = app1.chain_database();
+      fc::ecc::private_key committee_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("nathan")));
+      for( uint32_t i = 0; i < block_count; ++i )
+         db1->generate_block( db1->get_slot_time(1), db1->get_scheduled_witness(1), committee_key, database::skip_nothing );
+      BOOST_REQUIRE_EQUAL( db1->head_block_num(), block_count );
+
+      BOOST_TEST_MESSAGE( "Syncing app2 from app1" );
+      graphene::app::application app2;
+      auto cfg2 = cfg;
+      cfg2.erase("p2p-endpoint");
+      cfg2.emplace("p2p-endpoint", boost::program_options::variable_value(string("127.0.0.1:0"), false));
+      const string app1_endpoint = "127.0.0.1:" + std::to_string( app1.p2p_node()->get_actual_listening_endpoint().port() );
+      cfg2.emplace("seed-node", boost::program_options::variable_value(vector<string>{app1_endpoint}, false));
+      app2.initialize(app2_dir.path(), cfg2);
+
+      fc::time_point start = fc::time_point::now();
+      app2.startup();
+      std::shared_ptr<chain::database> db2 = app2.chain_database();
+      fc::time_point deadline = start + fc::seconds(120);
+      while( db2->head_block_num() < block_count && fc::time_point::now() < deadline )
+         fc::usleep(fc::milliseconds(20));
+      fc::microseconds elapsed = fc::time_point::now() - start;
+
+      BOOST_REQUIRE_EQUAL( db2->head_block_num(), block_count );
+      BOOST_CHECK( db2->head_block_id() == db1->head_block_id() );
+      BOOST_TEST_MESSAGE( "Synced " + std::to_string( block_count ) + " blocks in " + std::to_string( elapsed.count() / 1000 )
+                          + " ms, " + std::to_string( block_count * 1000000ll / std::max<int64_t>( elapsed.count(), 1 ) ) + " blocks/s" );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( broadcast_transactions_and_callbacks )
+{
+   using namespace graphene::chain;
+   using namespace graphene::app;
+   try {
+      BOOST_TEST_MESSAGE( "=== broadcast_transactions_and_callbacks ===" );
+
+      fc::temp_directory app_dir( graphene::utilities::temp_directory_path() );
+      graphene::app::application app1;
+      boost::program_options::variables_map cfg;
+      cfg.emplace("p2p-endpoint", boost::program_options::variable_value(string("127.0.0.1:0"), false));
+      cfg.emplace("genesis-json", boost::program_options::variable_value(create_genesis_file(app_dir), false));
+      cfg.emplace("seed-nodes", boost::program_options::variable_value(string("[]"), false));
+      app1.initialize(app_dir.path(), cfg);
+      app1.startup();
+
+      std::shared_ptr<chain::database> db1 = app1.chain_database();
+      auto api = std::make_shared<network_broadcast_api>( std::ref( app1 ) );
+      fc::ecc::private_key nathan_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("nathan")));
+      account_id_type nathan_id = db1->get_index_type<account_index>().indices().get<by_name>().find( "nathan" )->id;
+      auto generate_block = [&]( uint32_t slot ) {
+         db1->generate_block( db1->get_slot_time(slot), db1->get_scheduled_witness(slot), nathan_key, database::skip_nothing );
+      };
+
+      signed_transaction trx_fee_payer;
+      assets_update_fee_payer_operation payer_upd_op;
+      payer_upd_op.assets_to_update = { CORE_ASSET };
+      payer_upd_op.fee_payer_asset = CORE_ASSET;
+      trx_fee_payer.operations.push_back(payer_upd_op);
+      db1->current_fee_schedule().set_fee( trx_fee_payer.operations.back() );
+      trx_fee_payer.set_expiration( db1->head_block_time() );
+      trx_fee_payer.set_reference_block( db1->head_block_id() );
+      trx_fee_payer.sign( nathan_key, db1->get_chain_id() );
+      db1->push_transaction(trx_fee_payer, ~0);
+
+      signed_transaction claim_trx;
+      balance_claim_operation claim_op;
+      claim_op.deposit_to_account = nathan_id;
+      claim_op.balance_to_claim = balance_id_type();
+      claim_op.balance_owner_key = nathan_key.get_public_key();
+      claim_op.total_claimed = balance_id_type()(*db1).balance;
+      claim_trx.operations.push_back( claim_op );
+      db1->current_fee_schedule().set_fee( claim_trx.operations.back() );
+      claim_trx.set_expiration( db1->head_block_time() );
+      claim_trx.set_reference_block( db1->head_block_id() );
+      claim_trx.sign( nathan_key, db1->get_chain_id() );
+
+      auto make_transfer = [&]( int64_t amount, fc::time_point_sec expiration, bool sign ) {
+         signed_transaction trx;
+         transfer_operation xfer_op;
+         xfer_op.from = nathan_id;
+         xfer_op.to = GRAPHENE_NULL_ACCOUNT;
+         xfer_op.amount = asset( amount, CORE_ASSET );
+         trx.operations.push_back( xfer_op );
+         db1->current_fee_schedule().set_fee( trx.operations.back() );
+         trx.set_expiration( expiration );
+         trx.set_reference_block( db1->head_block_id() );
+         if( sign )
+            trx.sign( nathan_key, db1->get_chain_id() );
+         return trx;
+      };
+
+      BOOST_TEST_MESSAGE( "Every transaction of a batch gets its own result" );
+      const vector<signed_transaction> batch{ signed_transaction(), claim_trx,
+                                              make_transfer( 1000, db1->head_block_time(), false ), claim_trx };
+      const auto results = api->broadcast_transactions( batch );
+      BOOST_REQUIRE_EQUAL( results.size(), batch.size() );
+      for( size_t i = 0; i < batch.size(); ++i )
+         BOOST_CHECK( results[i].id == batch[i].id() );
+      BOOST_CHECK( !results[0].accepted && results[0].error.valid() );
+      BOOST_CHECK( results[1].accepted && !results[1].error.valid() );
+      BOOST_CHECK( !results[2].accepted && results[2].error.valid() );
+      BOOST_CHECK( !results[3].accepted && results[3].error.valid() );
+      generate_block(1);
+
+      BOOST_TEST_MESSAGE( "A callback is called and removed once its transaction is included" );
+      vector<variant> confirmations;
+      auto callback = [&confirmations]( variant v ) { confirmations.push_back( v ); };
+      const signed_transaction confirmed = make_transfer( 1000, db1->head_block_time() + 60, true );
+      api->broadcast_transaction_with_callback_new( callback, confirmed );
+      BOOST_CHECK_EQUAL( api->pending_confirmations(), 1u );
+      generate_block(1);
+      fc::usleep( fc::milliseconds(50) );
+      BOOST_CHECK_EQUAL( api->pending_confirmations(), 0u );
+      BOOST_REQUIRE_EQUAL( confirmations.size(), 1u );
+      BOOST_CHECK( confirmations[0].as<network_broadcast_api::transaction_confirmation>( 10 ).id == confirmed.id() );
+
+      BOOST_TEST_MESSAGE( "A callback is dropped once its transaction expired" );
+      const signed_transaction expiring = make_transfer( 1001, db1->get_slot_time(1), true );
+      api->broadcast_transaction_with_callback_new( callback, expiring );
+      BOOST_CHECK_EQUAL( api->pending_confirmations(), 1u );
+      db1->clear_pending();
+      generate_block(2);
+      fc::usleep( fc::milliseconds(50) );
+      BOOST_CHECK_EQUAL( api->pending_confirmations(), 0u );
+      BOOST_CHECK_EQUAL( confirmations.size(), 1u );
+
+      BOOST_TEST_MESSAGE( "A full table rejects a transaction before it is applied" );
+      api->set_max_pending_confirmations( 1 );
+      api->broadcast_transaction_with_callback_new( callback, make_transfer( 1002, db1->head_block_time() + 60, true ) );
+      const signed_transaction rejected = make_transfer( 1003, db1->head_block_time() + 60, true );
+      BOOST_CHECK_THROW( api->broadcast_transaction_with_callback_new( callback, rejected ), fc::exception );
+      BOOST_CHECK( !db1->is_known_transaction( rejected.id() ) );
+      BOOST_CHECK_EQUAL( api->pending_confirmations(), 1u );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( bonus_checkpoint_resume )
+{
+   using namespace graphene::chain;
+   using namespace graphene::app;
+   try {
+      BOOST_TEST_MESSAGE( "=== bonus_checkpoint_resume ===" );
+
+      bonus_checkpoint checkpoint;
+      checkpoint.start_day( "2026-10-17" );
+      BOOST_CHECK( !checkpoint.trusted );
+
+      auto make_payment = []( account_id_type account, uint64_t quantity, const string& kind, bool core_transfer ) {
+         bonus_payment payment;
+         payment.account = account;
+         payment.quantity = quantity;
+         payment.kind = kind;
+         payment.core_transfer = core_transfer;
+         return payment;
+      };
+      const transaction_id_type daily_trx = fc::ripemd160::hash( string( "daily" ) );
+      const transaction_id_type referral_trx = fc::ripemd160::hash( string( "referral" ) );
+      const transaction_id_type completion_trx = fc::ripemd160::hash( string( "completion" ) );
+      const fc::time_point_sec expiration( 1000000 );
+      checkpoint.pending[daily_trx].expiration = expiration;
+      checkpoint.pending[daily_trx].payments.push_back( make_payment( account_id_type(20), 65, "Daily mining reward", false ) );
+      checkpoint.pending[daily_trx].payments.push_back( make_payment( account_id_type(21), 13, "Daily mining reward", false ) );
+      checkpoint.pending[referral_trx].expiration = expiration;
+      checkpoint.pending[referral_trx].payments.push_back( make_payment( account_id_type(20), 5, "Referral reward", false ) );
+      checkpoint.pending[completion_trx].expiration = expiration + 60;
+      checkpoint.pending[completion_trx].payments.push_back( make_payment( account_id_type(19), 1000, "Daily mining reward", true ) );
+
+      BOOST_TEST_MESSAGE( "Broadcast rewards are only recorded once their transaction is included" );
+      BOOST_CHECK( checkpoint.daily_rewards.empty() );
+      BOOST_CHECK( checkpoint.confirm( daily_trx ) );
+      BOOST_CHECK( !checkpoint.confirm( daily_trx ) );
+      BOOST_CHECK_EQUAL( checkpoint.daily_rewards.size(), 2u );
+      BOOST_CHECK_EQUAL( checkpoint.daily_rewards.at( account_id_type(20) ), 65u );
+      BOOST_CHECK( checkpoint.referral_rewards.empty() );
+      BOOST_CHECK( checkpoint.completed.empty() );
+      BOOST_CHECK_EQUAL( checkpoint.pending.size(), 2u );
+
+      BOOST_TEST_MESSAGE( "The checkpoint is resumed with its trust and its pending transactions" );
+      checkpoint.trusted = true;
+      fc::temp_directory dir( graphene::utilities::temp_directory_path() );
+      const fc::path file = dir.path() / "bonus_checkpoint.json";
+      fc::json::save_to_file( checkpoint, file );
+      bonus_checkpoint resumed = fc::json::from_file( file ).as<bonus_checkpoint>( 10 );
+      BOOST_CHECK_EQUAL( resumed.date, "2026-10-17" );
+      BOOST_CHECK( resumed.trusted );
+      BOOST_CHECK_EQUAL( resumed.daily_rewards.at( account_id_type(21) ), 13u );
+      BOOST_REQUIRE_EQUAL( resumed.pending.size(), 2u );
+      BOOST_CHECK( resumed.pending.at( referral_trx ).expiration == expiration );
+
+      BOOST_TEST_MESSAGE( "Expired transactions are dropped, the others stay pending" );
+      BOOST_CHECK( !resumed.drop_expired( expiration ) );
+      BOOST_CHECK( resumed.drop_expired( expiration + 1 ) );
+      BOOST_CHECK( resumed.referral_rewards.empty() );
+      BOOST_REQUIRE_EQUAL( resumed.pending.size(), 1u );
+      BOOST_CHECK( resumed.confirm( completion_trx ) );
+      BOOST_CHECK_EQUAL( resumed.completed.count( "Daily mining reward" ), 1u );
+      BOOST_CHECK( resumed.pending.empty() );
+
+      BOOST_TEST_MESSAGE( "A new day starts empty and trusted, since the node kept the previous day" );
+      resumed.trusted = false;
+      resumed.start_day( "2026-10-18" );
+      BOOST_CHECK( resumed.trusted );
+      BOOST_CHECK_EQUAL( resumed.date, "2026-10-18" );
+      BOOST_CHECK( resumed.daily_rewards.empty() );
+      BOOST_CHECK( resumed.completed.empty() );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
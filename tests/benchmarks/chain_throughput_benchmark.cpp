@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/fund_object.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/settings_object.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include <deque>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+/**
+ * Parameters of one chain_throughput run. The operation weights are relative, a mix of
+ * { transfers = 3, cheques = 1 } makes three transfers for every cheque operation.
+ */
+struct chain_bench_workload
+{
+   std::string name;
+   uint32_t    accounts               = 100;
+   uint32_t    blocks                 = 20;
+   uint32_t    transactions_per_block = 100;
+   /// when false the history and market history plugins are disconnected from the database
+   bool        history                = true;
+
+   uint32_t    transfers              = 1;
+   uint32_t    blind_transfers        = 0;
+   /// every second cheque operation creates a cheque, the others use the oldest unused one
+   uint32_t    cheques                = 0;
+   uint32_t    fund_deposits          = 0;
+   uint32_t    addresses              = 0;
+};
+
+struct chain_bench_result
+{
+   chain_bench_workload workload;
+   uint64_t             transactions          = 0;
+   uint64_t             tx_per_second         = 0;
+   /// time spent pushing the transactions to the pending state
+   int64_t              push_us               = 0;
+   /// time spent generating and applying the blocks, maintenance blocks excluded
+   int64_t              blocks_us             = 0;
+   /// percentiles of generate_block(), which includes producing and signing the block besides applying it
+   int64_t              generate_block_p50_us = 0;
+   int64_t              generate_block_p99_us = 0;
+   int64_t              generate_block_max_us = 0;
+   int64_t              maintenance_block_us  = 0;
+};
+
+FC_REFLECT( chain_bench_workload, (name)(accounts)(blocks)(transactions_per_block)(history)
+                                  (transfers)(blind_transfers)(cheques)(fund_deposits)(addresses) )
+FC_REFLECT( chain_bench_result, (workload)(transactions)(tx_per_second)(push_us)(blocks_us)
+                                (generate_block_p50_us)(generate_block_p99_us)(generate_block_max_us)(maintenance_block_us) )
+
+namespace {
+
+const share_type account_edc_balance  = 100000000;
+const share_type account_test_balance = 1000000;
+const share_type transfer_amount      = 1000;
+const share_type deposit_amount       = 10000;
+const uint32_t   fee_percent          = 100;
+
+/**
+ * Sets up an EDC chain past the last hardfork and runs a workload on it. Transactions are pushed
+ * with all checks skipped, like the other chain benchmarks, so the numbers are the cost of
+ * evaluating and applying operations and blocks.
+ */
+struct chain_bench_harness : database_fixture
+{
+   explicit chain_bench_harness( const chain_bench_workload& w ) : workload( w ) {}
+
+   void setup()
+   {
+      ACTOR( fundowner );
+      SET_ACTOR_CAN_CREATE_ASSET( fundowner_id );
+
+      create_edc( GRAPHENE_MAX_SHARE_SUPPLY, asset( 100, CORE_ASSET ), asset( 1, EDC_ASSET ) );
+      create_test_asset();
+
+      generate_blocks( HARDFORK_632_TIME + fc::days( 1 ) );
+      generate_block();
+
+      update_settings_operation s_op;
+      s_op.transfer_fees = { settings_fee{ EDC_ASSET, fee_percent } };
+      s_op.blind_transfer_fees = { settings_fee{ EDC_ASSET, fee_percent } };
+      s_op.blind_transfer_default_fee = asset( 0, EDC_ASSET );
+      s_op.edc_deposit_max_sum = GRAPHENE_MAX_SHARE_SUPPLY;
+      s_op.edc_transfers_daily_limit = GRAPHENE_MAX_SHARE_SUPPLY;
+      s_op.extensions.value.cheque_fees = std::vector<settings_fee>{ settings_fee{ EDC_ASSET, fee_percent } };
+      s_op.extensions.value.edc_cheques_daily_limit = GRAPHENE_MAX_SHARE_SUPPLY;
+      push( s_op );
+
+      const asset_id_type test_asset = get_asset( "TEST" ).get_id();
+      accounts.reserve( workload.accounts );
+      for( uint32_t i = 0; i < workload.accounts; ++i )
+      {
+         const account_object& a = create_account( "bench-acct-x" + fc::to_string( i ) );
+         accounts.push_back( a.get_id() );
+         issue_uia( a.get_id(), asset( account_edc_balance, EDC_ASSET ) );
+         // held for the bonus issuance of the maintenance block
+         issue_uia( a.get_id(), asset( account_test_balance, test_asset ) );
+      }
+
+      if( workload.fund_deposits > 0 )
+      {
+         fund_options::fund_rate fr;
+         fr.amount = 10000;
+         fr.day_percent = 1000;
+         fund_options::payment_rate pr;
+         pr.period = 50;
+         pr.percent = 20000;
+
+         fund_options options;
+         options.description = "BENCHMARK FUND";
+         options.period = 100;
+         options.min_deposit = deposit_amount;
+         options.rates_reduction_per_month = 300;
+         options.fund_rates.push_back( fr );
+         options.payment_rates.push_back( pr );
+         make_fund( "BENCHFUND", options, fundowner_id );
+         fund = db.get_index_type<fund_index>().indices().get<by_name>().find( "BENCHFUND" )->get_id();
+      }
+
+      generate_block();
+
+      if( !workload.history )
+         db.applied_block.disconnect_all_slots();
+   }
+
+   void push( const operation& op )
+   {
+      set_expiration( db, trx );
+      trx.operations = { op };
+      db.push_transaction( trx, ~0 );
+      trx.clear();
+   }
+
+   asset custom_fee( share_type amount )const
+   {
+      return asset( int64_t( std::round( amount.value * db.get_percent( fee_percent ) ) ), EDC_ASSET );
+   }
+
+   /// @return the operation number @p seq of the workload mix
+   operation next_operation( uint64_t seq )
+   {
+      const account_id_type from = accounts[seq % accounts.size()];
+      const account_id_type to   = accounts[(seq + 1) % accounts.size()];
+      // the amount keeps transactions of the same accounts distinct
+      const share_type amount = transfer_amount + int64_t( seq % 1000 );
+
+      uint64_t slot = seq % mix_total();
+      if( slot < workload.transfers )
+      {
+         transfer_operation op;
+         op.from = from;
+         op.to = to;
+         op.amount = asset( amount, EDC_ASSET );
+         op.fee = custom_fee( amount );
+         return op;
+      }
+      slot -= workload.transfers;
+      if( slot < workload.blind_transfers )
+      {
+         blind_transfer2_operation op;
+         op.from = from;
+         op.to = to;
+         op.amount = asset( amount, EDC_ASSET );
+         op.fee = asset( 0, EDC_ASSET );
+         return op;
+      }
+      slot -= workload.blind_transfers;
+      if( slot < workload.cheques )
+      {
+         if( open_cheques.empty() || ( seq / mix_total() ) % 2 == 0 )
+         {
+            std::string code = fc::to_string( seq );
+            code = "B" + std::string( 15 - code.size(), '0' ) + code;
+            cheque_create_operation op;
+            op.code = code;
+            op.expiration_datetime = db.head_block_time() + fc::days( 2 );
+            op.account_id = from;
+            op.payee_amount = asset( transfer_amount, EDC_ASSET );
+            op.payee_count = 1;
+            op.fee = custom_fee( transfer_amount );
+            open_cheques.push_back( std::make_pair( code, from ) );
+            return op;
+         }
+         cheque_use_operation op;
+         op.code = open_cheques.front().first;
+         op.account_id = open_cheques.front().second == from ? to : from;
+         op.amount = asset( transfer_amount, EDC_ASSET );
+         op.fee = asset( 0, EDC_ASSET );
+         open_cheques.pop_front();
+         return op;
+      }
+      slot -= workload.cheques;
+      if( slot < workload.fund_deposits )
+      {
+         fund_deposit_operation op;
+         op.from_account = from;
+         op.fund_id = fund;
+         op.amount = deposit_amount + int64_t( seq % 1000 );
+         op.period = 50;
+         op.fee = asset();
+         return op;
+      }
+      add_address_operation op;
+      op.to_account = from;
+      return op;
+   }
+
+   uint64_t mix_total()const
+   {
+      return workload.transfers + workload.blind_transfers + workload.cheques
+             + workload.fund_deposits + workload.addresses;
+   }
+
+   chain_bench_result run()
+   {
+      FC_ASSERT( workload.accounts > 1 );
+      FC_ASSERT( mix_total() > 0 );
+      setup();
+
+      chain_bench_result result;
+      result.workload = workload;
+
+      std::vector<int64_t> block_times;
+      block_times.reserve( workload.blocks );
+      uint64_t seq = 0;
+      for( uint32_t b = 0; b < workload.blocks; ++b )
+      {
+         auto start = fc::time_point::now();
+         for( uint32_t t = 0; t < workload.transactions_per_block; ++t )
+            push( next_operation( seq++ ) );
+         result.push_us += ( fc::time_point::now() - start ).count();
+
+         const auto maintenance_time = db.get_dynamic_global_properties().next_maintenance_time;
+         start = fc::time_point::now();
+         generate_block();
+         const int64_t elapsed = ( fc::time_point::now() - start ).count();
+         if( db.get_dynamic_global_properties().next_maintenance_time != maintenance_time )
+            result.maintenance_block_us = std::max( result.maintenance_block_us, elapsed );
+         else
+         {
+            block_times.push_back( elapsed );
+            result.blocks_us += elapsed;
+         }
+      }
+      result.transactions = seq;
+      result.tx_per_second = seq * 1000000 / std::max<int64_t>( result.push_us + result.blocks_us, 1 );
+
+      if( !block_times.empty() )
+      {
+         std::sort( block_times.begin(), block_times.end() );
+         result.generate_block_p50_us = block_times[ block_times.size() / 2 ];
+         result.generate_block_p99_us = block_times[ std::min( block_times.size() - 1, block_times.size() * 99 / 100 ) ];
+         result.generate_block_max_us = block_times.back();
+      }
+
+      // the next block is a maintenance block, which issues the daily bonuses of the TEST holders
+      const auto maintenance_time = db.get_dynamic_global_properties().next_maintenance_time;
+      uint32_t slot = db.get_slot_at_time( maintenance_time );
+      if( db.get_slot_time( slot ) < maintenance_time )
+         ++slot;
+      const auto start = fc::time_point::now();
+      generate_block( ~0, init_account_priv_key, slot - 1 );
+      result.maintenance_block_us = std::max( result.maintenance_block_us, ( fc::time_point::now() - start ).count() );
+      BOOST_CHECK( db.get_dynamic_global_properties().next_maintenance_time > maintenance_time );
+
+      return result;
+   }
+
+   chain_bench_workload                                 workload;
+   vector<account_id_type>                              accounts;
+   fund_id_type                                         fund;
+   std::deque<std::pair<std::string, account_id_type>>  open_cheques;
+};
+
+/**
+ * Workloads can be given on the command line as JSON objects, e.g.
+ *    chain_bench --run_test=chain_throughput_benchmark -- \
+ *       --chain-bench-workload='{"name":"mix","accounts":1000,"cheques":1}' --chain-bench-json=out.json
+ * Without them a default set of small workloads is run.
+ */
+vector<chain_bench_workload> get_workloads( std::string& json_file )
+{
+   vector<chain_bench_workload> result;
+   const int argc = boost::unit_test::framework::master_test_suite().argc;
+   char** argv = boost::unit_test::framework::master_test_suite().argv;
+   const std::string workload_arg = "--chain-bench-workload=";
+   const std::string json_arg = "--chain-bench-json=";
+   for( int i = 1; i < argc; ++i )
+   {
+      const std::string arg = argv[i];
+      if( arg.compare( 0, workload_arg.size(), workload_arg ) == 0 )
+         result.push_back( fc::json::from_string( arg.substr( workload_arg.size() ) ).as<chain_bench_workload>( 2 ) );
+      else if( arg.compare( 0, json_arg.size(), json_arg ) == 0 )
+         json_file = arg.substr( json_arg.size() );
+   }
+   if( !result.empty() )
+      return result;
+
+   chain_bench_workload w;
+   w.name = "transfers";
+   result.push_back( w );
+
+   w.name = "transfers_no_history";
+   w.history = false;
+   result.push_back( w );
+
+   w.name = "edc_mix";
+   w.history = true;
+   w.transfers = 4;
+   w.blind_transfers = 2;
+   w.cheques = 2;
+   w.fund_deposits = 1;
+   w.addresses = 1;
+   result.push_back( w );
+   return result;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE( chain_throughput_benchmark )
+
+BOOST_AUTO_TEST_CASE( chain_throughput )
+{ try {
+   std::string json_file;
+   vector<chain_bench_result> results;
+   for( const auto& workload : get_workloads( json_file ) )
+   {
+      chain_bench_harness harness( workload );
+      results.push_back( harness.run() );
+      const auto& r = results.back();
+      ilog( "${name}: ${tps} tx/s, generate_block p50 ${p50} us, p99 ${p99} us, maintenance block ${m} us",
+            ("name", workload.name)("tps", r.tx_per_second)("p50", r.generate_block_p50_us)("p99", r.generate_block_p99_us)
+            ("m", r.maintenance_block_us) );
+   }
+
+   if( !json_file.empty() )
+      fc::json::save_to_file( results, fc::path( json_file ) );
+   else
+      std::cout << fc::json::to_pretty_string( results ) << std::endl;
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/cheque_object.hpp>
+#include <graphene/chain/database.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+const uint32_t payees = 10000;
+const uint32_t chunk  = 1000;
+
+/// reports the redemption cost of @p count payees redeemed since @p start
+void report( const char* name, const fc::time_point& start, uint64_t count )
+{
+   const auto elapsed = fc::time_point::now() - start;
+   ilog( "${name}: ${n} redemptions/s, ${us} us/redemption",
+         ("name", name)("n", count * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))
+         ("us", elapsed.count() / std::max<uint64_t>( count, 1 )) );
+}
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE( cheque_benchmark, database_fixture )
+
+/**
+ * Redeems a promo cheque with many payees, one chunk of payees per block. The cost of a redemption
+ * must not grow with the number of payees which came before, so the first and the last chunk are
+ * reported separately.
+ */
+BOOST_AUTO_TEST_CASE( mass_redemption )
+{ try {
+   ACTOR( alice );
+   SET_ACTOR_CAN_CREATE_ASSET( alice_id );
+   create_edc();
+   issue_uia( alice_id, asset( 1000 * payees, EDC_ASSET ) );
+
+   vector<account_id_type> accounts;
+   accounts.reserve( payees );
+   for( uint32_t i = 0; i < payees; ++i )
+      accounts.push_back( create_account( "bench-payee-x" + fc::to_string( i ) ).get_id() );
+   generate_block();
+
+   const std::string code = "PromoCode0000001";
+   make_cheque( code, db.head_block_time() + fc::days( 2 ), EDC_ASSET, 1000, payees, alice_id );
+   generate_block();
+
+   const auto total_start = fc::time_point::now();
+   for( uint32_t i = 0; i < payees; i += chunk )
+   {
+      const auto start = fc::time_point::now();
+      for( uint32_t j = i; j < i + chunk; ++j )
+         use_cheque( code, accounts[j] );
+      if( i == 0 )
+         report( "first chunk", start, chunk );
+      else if( i + chunk >= payees )
+         report( "last chunk", start, chunk );
+      generate_block();
+   }
+   report( "all payees", total_start, payees );
+
+   const cheque_object& cheque = *db.get_index_type<cheque_index>().indices().get<by_code>().find( code );
+   BOOST_CHECK_EQUAL( cheque.status, cheque_status::cheque_used );
+   BOOST_CHECK_EQUAL( cheque.payees_used, payees );
+   BOOST_CHECK( cheque.amount_remaining == 0 );
+   BOOST_CHECK( get_balance( accounts.back(), EDC_ASSET ) == 1000 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
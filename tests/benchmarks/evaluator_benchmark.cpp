@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/transfer_evaluator.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+const uint32_t chunk      = 1000;
+const uint32_t iterations = 50 * chunk;
+
+/// reports the operation throughput of @p count iterations started at @p start
+void report( const char* name, const fc::time_point& start, uint64_t count )
+{
+   const auto elapsed = fc::time_point::now() - start;
+   ilog( "${name}: ${n} ops/s, ${ns} ns/op",
+         ("name", name)("n", count * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))
+         ("ns", elapsed.count() * 1000 / std::max<uint64_t>( count, 1 )) );
+}
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE( evaluator_benchmark, database_fixture )
+
+BOOST_AUTO_TEST_CASE( transfer_apply )
+{ try {
+   ACTORS( (alice)(bob) );
+   fund( alice, asset( 10 * iterations ) );
+   generate_block();
+
+   transfer_operation t;
+   t.from   = alice_id;
+   t.to     = bob_id;
+   t.amount = asset( 1 );
+   const operation op = t;
+
+   transaction_evaluation_state eval_state( &db );
+   eval_state.skip_fee_schedule_check = true;
+
+   // every chunk is undone, so that the balances and the undo state do not grow over the run
+   auto run = [&]( const char* name, const std::function<void()>& apply_one )
+   {
+      const auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < iterations / chunk; ++i )
+      {
+         auto session = db._undo_db.start_undo_session();
+         for( uint32_t j = 0; j < chunk; ++j )
+            apply_one();
+         BOOST_CHECK( get_balance( bob_id, asset_id_type() ) == chunk );
+      }
+      report( name, start, iterations );
+   };
+
+   run( "transfer apply through the dispatch table", [&]() {
+      db.apply_operation( eval_state, op );
+   } );
+
+   run( "transfer apply through the evaluator interface", [&]() {
+      transfer_evaluator eval;
+      static_cast<generic_evaluator&>( eval ).start_evaluate( eval_state, op, true );
+   } );
+
+   BOOST_CHECK( get_balance( bob_id, asset_id_type() ) == 0 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
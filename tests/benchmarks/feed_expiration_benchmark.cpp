@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/database.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+const uint32_t blocks = 200;
+
+/// a valid asset symbol for every @p n
+std::string symbol( uint32_t n )
+{
+   std::string result = "FEED";
+   for( uint32_t i = 0; i < 4; ++i, n /= 26 )
+      result += char( 'A' + n % 26 );
+   return result;
+}
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE( feed_expiration_benchmark, database_fixture )
+
+/**
+ * Generates blocks in which no feed expires and no asset changes, with a growing number of market issued
+ * assets. The cost of a block should not depend on the number of assets.
+ */
+BOOST_AUTO_TEST_CASE( blocks_by_asset_count )
+{ try {
+   uint32_t assets = 0;
+   for( uint32_t count : { 10, 100, 1000, 5000 } )
+   {
+      for( ; assets < count; ++assets )
+      {
+         const asset_object& a = create_bitasset( symbol( assets ) );
+         BOOST_CHECK( a.bitasset_data( db ).asset_id == a.get_id() );
+      }
+      generate_block();
+
+      const auto start = fc::time_point::now();
+      generate_blocks( blocks );
+      const auto elapsed = fc::time_point::now() - start;
+      ilog( "${n} market issued assets: ${us} us/block",
+            ("n", count)("us", elapsed.count() / blocks) );
+   }
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/database.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( market_history_benchmark, database_fixture )
+
+/**
+ * Fills a growing number of orders of one market with a single taker order and reports the cost of the block
+ * containing the fills, which includes updating the order history and the buckets of all tracked sizes.
+ */
+BOOST_AUTO_TEST_CASE( blocks_by_fill_count )
+{ try {
+   ACTORS( (maker)(taker) );
+   const asset_object& test_asset = create_user_issued_asset( "FILLS" );
+   transfer( committee_account, maker_id, asset( 100000000 ) );
+   issue_uia( taker_id, test_asset.amount( 100000000 ) );
+   generate_block();
+
+   for( uint32_t orders : { 100, 1000, 4000 } )
+   {
+      share_type total = 0;
+      for( uint32_t i = 0; i < orders; ++i )
+      {
+         const asset wanted = test_asset.amount( 10 + i % 7 );
+         BOOST_REQUIRE( create_sell_order( maker_id, asset( 10 ), wanted ) != nullptr );
+         total += wanted.amount;
+      }
+      generate_block();
+
+      BOOST_REQUIRE( create_sell_order( taker_id, test_asset.amount( total ), asset( 1 ) ) == nullptr );
+      const auto start = fc::time_point::now();
+      generate_block();
+      const auto elapsed = fc::time_point::now() - start;
+      ilog( "${n} filled orders: ${us} us/block, ${f} us/fill",
+            ("n", orders)("us", elapsed.count())("f", elapsed.count() / orders) );
+   }
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
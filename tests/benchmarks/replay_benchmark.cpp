@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/database.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+const uint32_t blocks                 = 200;
+const uint32_t transactions_per_block = 50;
+
+/// reports the block throughput of @p count blocks applied since @p start
+void report( const char* name, const fc::time_point& start, uint64_t count )
+{
+   const auto elapsed = fc::time_point::now() - start;
+   ilog( "${name}: ${n} blocks/s, ${us} us/block",
+         ("name", name)("n", count * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))
+         ("us", elapsed.count() / std::max<uint64_t>( count, 1 )) );
+}
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE( replay_benchmark, database_fixture )
+
+BOOST_AUTO_TEST_CASE( transfer_blocks )
+{ try {
+   ACTORS( (alice)(bob) );
+   fund( alice, asset( 10 * blocks * transactions_per_block * transactions_per_block ) );
+   generate_block();
+
+   for( uint32_t i = 0; i < blocks; ++i )
+   {
+      for( uint32_t j = 0; j < transactions_per_block; ++j )
+      {
+         transfer_operation t;
+         t.from   = alice_id;
+         t.to     = bob_id;
+         t.amount = asset( j + 1 );
+         trx.operations.push_back( t );
+         set_expiration( db, trx );
+         PUSH_TX( db, trx, ~0 );
+         trx.clear();
+      }
+      generate_block();
+   }
+   const uint32_t head = db.head_block_num();
+   const share_type bob_balance = get_balance( bob_id, asset_id_type() );
+
+   // the regular path: the same blocks pushed into a fresh database with the reindex skip flags
+   {
+      fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+      database db2;
+      db2.open( data_dir2.path(), [this]{ return genesis_state; } );
+
+      const auto start = fc::time_point::now();
+      for( uint32_t i = 1; i <= head; ++i )
+         db2.push_block( *db.fetch_block_by_number( i ), database::skip_witness_signature |
+                                                         database::skip_transaction_signatures |
+                                                         database::skip_transaction_dupe_check |
+                                                         database::skip_tapos_check |
+                                                         database::skip_witness_schedule_check |
+                                                         database::skip_authority_check );
+      report( "push_block", start, head );
+      BOOST_CHECK_EQUAL( db2.head_block_num(), head );
+   }
+
+   // the replay path, which reads the blocks back from the block log of the fixture database
+   const auto start = fc::time_point::now();
+   db.reindex( data_dir->path(), genesis_state );
+   report( "reindex", start, head );
+
+   BOOST_CHECK( !db.is_replaying() );
+   BOOST_CHECK_EQUAL( db.head_block_num(), head );
+   BOOST_CHECK( get_balance( bob_id, asset_id_type() ) == bob_balance );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
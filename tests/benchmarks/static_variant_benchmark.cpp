@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/protocol/operations.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+using namespace graphene::protocol;
+
+namespace {
+
+const uint32_t iterations = 1000000;
+
+struct fee_visitor
+{
+   typedef share_type result_type;
+   template<typename Op>
+   share_type operator()( const Op& op )const { return op.fee.amount; }
+};
+
+operation make_transfer()
+{
+   transfer_operation t;
+   t.fee = asset( 20 );
+   t.from = account_id_type( 17 );
+   t.to = account_id_type( 18 );
+   t.amount = asset( 1000 );
+   t.memo = memo_data();
+   t.memo->message.resize( 32 );
+   return t;
+}
+
+/// reports the operation throughput of @p count iterations started at @p start
+void report( const char* name, const fc::time_point& start, uint64_t count )
+{
+   const auto elapsed = fc::time_point::now() - start;
+   ilog( "${name}: ${n} ops/s, ${ns} ns/op",
+         ("name", name)("n", count * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))
+         ("ns", elapsed.count() * 1000 / std::max<uint64_t>( count, 1 )) );
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE( static_variant_benchmark )
+
+BOOST_AUTO_TEST_CASE( operation_copy )
+{
+   ilog( "sizeof(operation) = ${s}, sizeof(transfer_operation) = ${t}",
+         ("s", sizeof(operation))("t", sizeof(transfer_operation)) );
+
+   const operation op = make_transfer();
+   const transfer_operation& t = op.get<transfer_operation>();
+   share_type sum;
+
+   // copying the alternative itself is the lower bound of an operation copy
+   auto start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+   {
+      transfer_operation copy( t );
+      sum += copy.fee.amount;
+   }
+   report( "transfer_operation copy", start, iterations );
+
+   start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+   {
+      operation copy( op );
+      sum += copy.get<transfer_operation>().fee.amount;
+   }
+   report( "operation copy", start, iterations );
+
+   std::vector<operation> ops;
+   ops.reserve( 1000 );
+   start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations / 1000; ++i )
+   {
+      ops.clear();
+      for( uint32_t j = 0; j < 1000; ++j )
+         ops.push_back( op );
+   }
+   report( "operation push_back", start, iterations );
+
+   BOOST_CHECK( sum == share_type( 2 * 20 * int64_t( iterations ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( operation_pack )
+{
+   const operation op = make_transfer();
+   const auto packed = fc::raw::pack( op );
+   size_t total = 0;
+
+   auto start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+      total += fc::raw::pack_size( op );
+   report( "operation pack_size", start, iterations );
+
+   start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+      total += fc::raw::pack( op ).size();
+   report( "operation pack", start, iterations );
+
+   start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+   {
+      const operation unpacked = fc::raw::unpack<operation>( packed, FC_PACK_MAX_DEPTH );
+      total += unpacked.which();
+   }
+   report( "operation unpack", start, iterations );
+
+   BOOST_CHECK( total > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( operation_visit )
+{
+   // one operation of every type, so that the visit does not always hit the same table entry
+   std::vector<operation> ops;
+   for( int64_t which = 0; which < operation::count(); ++which )
+   {
+      operation op;
+      op.set_which( which );
+      ops.push_back( op );
+   }
+
+   share_type sum;
+   const fee_visitor visitor;
+   const uint32_t rounds = iterations / ops.size() + 1;
+   auto start = fc::time_point::now();
+   for( uint32_t i = 0; i < rounds; ++i )
+      for( const auto& op : ops )
+         sum += op.visit( visitor );
+   report( "operation visit", start, uint64_t( rounds ) * ops.size() );
+
+   BOOST_CHECK( sum == share_type( 0 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
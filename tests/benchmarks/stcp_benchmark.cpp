@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/net/stcp_socket.hpp>
+
+#include <fc/network/ip.hpp>
+#include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+using namespace graphene::net;
+
+namespace {
+
+const uint64_t bytes_per_run = 64 * 1024 * 1024;
+
+/// an encrypted loopback connection between two stcp sockets
+struct loopback
+{
+   explicit loopback( size_t buffer_size ) : sender( buffer_size ), receiver( buffer_size )
+   {
+      server.listen( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), 0 ) );
+      fc::future<void> accepted = fc::async( [this]() {
+         server.accept( receiver.get_socket() );
+         receiver.accept();
+      } );
+      sender.connect_to( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), server.get_port() ) );
+      accepted.wait();
+   }
+
+   fc::tcp_server server;
+   stcp_socket    sender;
+   stcp_socket    receiver;
+};
+
+/**
+ * Sends messages of @p message_size bytes, each behind an 8 byte header and padded to 16 bytes like
+ * message_oriented_connection does, @p batch messages per write, and reports the MB/s received.
+ */
+void run( size_t buffer_size, size_t message_size, size_t batch )
+{
+   loopback connection( buffer_size );
+
+   static const char padding[16] = {};
+   const char header[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+   std::vector<char> body( message_size );
+   for( size_t i = 0; i < body.size(); ++i )
+      body[i] = char( i * 7 + 3 );
+   const size_t padded_size = 16 * ( ( sizeof(header) + message_size + 15 ) / 16 );
+
+   std::vector<stcp_socket::segment> segments;
+   for( size_t i = 0; i < batch; ++i )
+   {
+      segments.emplace_back( header, sizeof(header) );
+      segments.emplace_back( body.data(), body.size() );
+      segments.emplace_back( padding, padded_size - sizeof(header) - message_size );
+   }
+   const uint64_t writes = std::max<uint64_t>( bytes_per_run / ( padded_size * batch ), 1 );
+
+   auto start = fc::time_point::now();
+   fc::future<void> received = fc::async( [&]() {
+      std::shared_ptr<char> buffer( new char[padded_size], [](char* p){ delete[] p; } );
+      for( uint64_t i = 0; i < writes * batch; ++i )
+      {
+         connection.receiver.read( buffer, padded_size );
+         if( i == 0 )
+         {
+            BOOST_CHECK( memcmp( buffer.get(), header, sizeof(header) ) == 0 );
+            BOOST_CHECK( memcmp( buffer.get() + sizeof(header), body.data(), body.size() ) == 0 );
+         }
+      }
+   } );
+   for( uint64_t i = 0; i < writes; ++i )
+      connection.sender.write_segments( segments );
+   received.wait();
+   const auto elapsed = fc::time_point::now() - start;
+
+   const uint64_t bytes = writes * batch * padded_size;
+   ilog( "buffer ${b} bytes, ${n} x ${m} byte messages per write: ${mbs} MB/s",
+         ("b", connection.sender.get_buffer_size())("n", batch)("m", message_size)
+         ("mbs", bytes / std::max<int64_t>( elapsed.count(), 1 )) );
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE( stcp_benchmark )
+
+/// block sized messages, as sent to every peer when a block is propagated
+BOOST_AUTO_TEST_CASE( block_throughput )
+{ try {
+   for( size_t buffer_size : { 4096, 16 * 1024, 64 * 1024, 256 * 1024 } )
+      run( buffer_size, 2 * 1024 * 1024 - 5, 1 );
+} FC_LOG_AND_RETHROW() }
+
+/// small messages such as transaction inventories, sent one by one or batched
+BOOST_AUTO_TEST_CASE( batched_small_messages )
+{ try {
+   for( size_t batch : { 1, 16, 256 } )
+      run( GRAPHENE_NET_DEFAULT_STCP_BUFFER_SIZE, 300, batch );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <graphene/app/prevalidated_transactions.hpp>
+
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/exceptions.hpp>
 
@@ -1361,4 +1363,95 @@ BOOST_FIXTURE_TEST_CASE( nonminimal_sig_test, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( prevalidated_transactions_test, database_fixture )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "=== prevalidated_transactions_test ===" );
+
+      ACTORS( (alice)(bob) );
+      fund( alice );
+      const chain_id_type& chain_id = db.get_chain_id();
+
+      auto make_transfer = [&]( int64_t amount, const fc::ecc::private_key& key ) {
+         signed_transaction tx;
+         transfer_operation op;
+         op.from = alice_id;
+         op.to = bob_id;
+         op.amount = asset( amount );
+         tx.operations.push_back( op );
+         set_expiration( db, tx );
+         sign( tx, key );
+         return tx;
+      };
+
+      graphene::app::prevalidated_transactions cache;
+
+      BOOST_TEST_MESSAGE( "A prevalidated transaction is pushed with the recovered keys" );
+      signed_transaction tx = make_transfer( 1, alice_private_key );
+      cache.prevalidate( tx, chain_id );
+      BOOST_CHECK_EQUAL( cache.size(), 1u );
+      cache.push_transaction( db, tx );
+      BOOST_CHECK_EQUAL( cache.size(), 0u );
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 1 );
+
+      // the signatures are not checked again, the authorities are checked against the recovered keys
+      tx = make_transfer( 2, alice_private_key );
+      graphene::app::prevalidated_transactions::result forged;
+      forged.signatures = tx.signatures;
+      forged.signature_keys.insert( bob_private_key.get_public_key() );
+      cache.insert( tx.id(), forged );
+      GRAPHENE_REQUIRE_THROW( cache.push_transaction( db, tx ), fc::exception );
+      BOOST_CHECK_EQUAL( cache.size(), 0u );
+
+      BOOST_TEST_MESSAGE( "A failed prevalidation is reported without pushing the transaction" );
+      signed_transaction empty_tx;
+      set_expiration( db, empty_tx );
+      cache.prevalidate( empty_tx, chain_id );
+      GRAPHENE_REQUIRE_THROW( cache.push_transaction( db, empty_tx ), fc::exception );
+      BOOST_CHECK( !db.is_known_transaction( empty_tx.id() ) );
+
+      BOOST_TEST_MESSAGE( "A transaction the cache misses is pushed with all of its checks" );
+      cache.push_transaction( db, make_transfer( 3, alice_private_key ) );
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 4 );
+      GRAPHENE_REQUIRE_THROW( cache.push_transaction( db, make_transfer( 4, bob_private_key ) ), fc::exception );
+
+      // a result made for other signatures does not apply
+      tx = make_transfer( 5, alice_private_key );
+      cache.insert( tx.id(), forged );
+      cache.push_transaction( db, tx );
+      BOOST_CHECK_EQUAL( cache.size(), 0u );
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 9 );
+
+      BOOST_TEST_MESSAGE( "A full cache drops the oldest results" );
+      graphene::app::prevalidated_transactions small_cache( 2 );
+      const signed_transaction tx_a = make_transfer( 6, alice_private_key );
+      const signed_transaction tx_b = make_transfer( 7, alice_private_key );
+      const signed_transaction tx_c = make_transfer( 8, alice_private_key );
+      small_cache.prevalidate( tx_a, chain_id );
+      small_cache.prevalidate( tx_b, chain_id );
+      small_cache.prevalidate( tx_a, chain_id );
+      BOOST_CHECK_EQUAL( small_cache.size(), 2u );
+      small_cache.prevalidate( tx_c, chain_id );
+      BOOST_CHECK_EQUAL( small_cache.size(), 2u );
+      BOOST_CHECK( !small_cache.take( tx_b ).valid() );
+      BOOST_CHECK( small_cache.take( tx_a ).valid() );
+      BOOST_CHECK( small_cache.take( tx_c ).valid() );
+
+      // a result that was taken leaves no trace that could evict a later one
+      small_cache.prevalidate( tx_a, chain_id );
+      small_cache.prevalidate( tx_b, chain_id );
+      BOOST_CHECK( small_cache.take( tx_a ).valid() );
+      small_cache.prevalidate( tx_a, chain_id );
+      BOOST_CHECK_EQUAL( small_cache.size(), 2u );
+      BOOST_CHECK( small_cache.take( tx_a ).valid() );
+      BOOST_CHECK( small_cache.take( tx_b ).valid() );
+
+      // once its result was taken a transaction goes through the full checks
+      small_cache.push_transaction( db, tx_b );
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 16 );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
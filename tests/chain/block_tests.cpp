@@ -26,12 +26,16 @@
 
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/exceptions.hpp>
+#include <graphene/chain/hardfork.hpp>
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
 #include <graphene/chain/committee_member_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/chain/transaction_history_object.hpp>
+
+#include <graphene/history/operation_history_store.hpp>
 
 #include <graphene/utilities/tempdir.hpp>
 
@@ -128,6 +132,71 @@ BOOST_AUTO_TEST_CASE( block_database_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( operation_history_store_test )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== operation_history_store_test ===" );
+
+      fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+
+      // tiny segments, so the store has to roll over to new segment files
+      graphene::history::operation_history_store store;
+      store.open( data_dir.path(), 256 );
+      FC_ASSERT( store.is_open() );
+      FC_ASSERT( store.last_id() == operation_history_id_type() );
+
+      const account_id_type alice( 10 ), bob( 11 );
+      for( uint32_t i = 1; i <= 20; ++i )
+      {
+         operation_history_object op;
+         op.id = operation_history_id_type( i * 2 );
+         op.block_num = i;
+         vector<std::pair<account_id_type, uint32_t>> accounts{ { alice, i } };
+         if( i % 2 == 0 )
+            accounts.emplace_back( bob, i / 2 );
+         store.append( op, accounts );
+      }
+      // already archived operations are ignored
+      operation_history_object dup;
+      dup.id = operation_history_id_type( 40 );
+      dup.block_num = 1000;
+      store.append( dup, {} );
+      store.flush();
+
+      auto check = [&]() {
+         BOOST_CHECK_EQUAL( store.size(), 20u );
+         BOOST_CHECK( store.last_id() == operation_history_id_type( 40 ) );
+         BOOST_CHECK( !store.contains( operation_history_id_type( 3 ) ) );
+         BOOST_CHECK( !store.fetch( operation_history_id_type( 3 ) ).valid() );
+         auto op = store.fetch( operation_history_id_type( 40 ) );
+         BOOST_REQUIRE( op.valid() );
+         BOOST_CHECK_EQUAL( op->block_num, 20u );
+         BOOST_CHECK_EQUAL( store.fetch_by_position( 0 ).block_num, 1u );
+         BOOST_CHECK_EQUAL( store.lower_bound( operation_history_id_type( 5 ) ), 2u );
+
+         const auto& alice_ops = store.account_history( alice );
+         BOOST_REQUIRE_EQUAL( alice_ops.size(), 20u );
+         BOOST_CHECK_EQUAL( alice_ops.back().operation, 40u );
+         BOOST_CHECK_EQUAL( alice_ops.back().sequence, 20u );
+         const auto& bob_ops = store.account_history( bob );
+         BOOST_REQUIRE_EQUAL( bob_ops.size(), 10u );
+         BOOST_CHECK_EQUAL( bob_ops.front().operation, 4u );
+         BOOST_CHECK( store.account_history( account_id_type( 12 ) ).empty() );
+      };
+
+      check();
+      store.close();
+      FC_ASSERT( !store.is_open() );
+      store.open( data_dir.path(), 256 );
+      check();
+
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( generate_empty_blocks )
 {
    try {
@@ -556,10 +625,16 @@ BOOST_AUTO_TEST_CASE( duplicate_transactions )
       PUSH_TX( db1, trx, skip_sigs );
 
       GRAPHENE_CHECK_THROW(PUSH_TX( db1, trx, skip_sigs ), fc::exception);
+      // a pending transaction is served from the pending transactions
+      BOOST_CHECK( db1.get_recent_transaction( trx.id() ).id() == trx.id() );
 
       auto b = db1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness( 1 ), init_account_priv_key, skip_sigs );
       PUSH_BLOCK( db2, b, skip_sigs );
 
+      // and an included one from its block
+      BOOST_CHECK( db1.get_recent_transaction( trx.id() ).id() == trx.id() );
+      BOOST_CHECK( db2.get_recent_transaction( trx.id() ).id() == trx.id() );
+
       GRAPHENE_CHECK_THROW(PUSH_TX( db1, trx, skip_sigs ), fc::exception);
       GRAPHENE_CHECK_THROW(PUSH_TX( db2, trx, skip_sigs ), fc::exception);
       BOOST_CHECK_EQUAL(db1.get_balance(nathan_id, asset_id_type()).amount.value, 500);
@@ -570,6 +645,33 @@ BOOST_AUTO_TEST_CASE( duplicate_transactions )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( expired_transactions_are_forgotten, database_fixture )
+{ try {
+   ACTORS( (alice)(bob) );
+   fund( alice, asset( 1000 ) );
+
+   transfer_operation t;
+   t.from = alice_id;
+   t.to = bob_id;
+   t.amount = asset( 100 );
+   trx.operations.push_back( t );
+   trx.set_expiration( db.head_block_time() + fc::seconds( 3 * db.get_global_properties().parameters.block_interval ) );
+   PUSH_TX( db, trx, ~0 );
+   const transaction_id_type trx_id = trx.id();
+   generate_block();
+
+   const auto& dedupe_idx = db.get_index_type<transaction_index>().indices().get<by_trx_id>();
+   auto itr = dedupe_idx.find( trx_id );
+   BOOST_REQUIRE( itr != dedupe_idx.end() );
+   BOOST_CHECK( itr->expiration == trx.expiration );
+   BOOST_CHECK_EQUAL( itr->block_num, db.head_block_num() );
+   BOOST_CHECK( db.get_recent_transaction( trx_id ).operations.size() == 1 );
+
+   generate_blocks( trx.expiration + db.get_global_properties().parameters.block_interval );
+   BOOST_CHECK( !db.is_known_transaction( trx_id ) );
+   GRAPHENE_CHECK_THROW( db.get_recent_transaction( trx_id ), fc::exception );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( tapos )
 {
    try {
@@ -956,6 +1058,34 @@ BOOST_FIXTURE_TEST_CASE( pop_block_twice, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( feed_update_marks_of_undone_assets, database_fixture )
+{
+   try
+   {
+      generate_block();
+
+      // the asset is marked for a feed update by the pending transaction, which is then dropped
+      const asset_id_type dropped_id = create_bitasset( "DROPPED" ).id;
+      db.clear_pending();
+      BOOST_CHECK( db.find( dropped_id ) == nullptr );
+      generate_block();
+
+      // the same for an asset of a popped block, which is only restored to the pending state later
+      const asset_id_type popped_id = create_bitasset( "POPPED" ).id;
+      generate_block();
+      BOOST_CHECK( db.find( popped_id ) != nullptr );
+      db.pop_block();
+      db.clear_pending();
+      BOOST_CHECK( db.find( popped_id ) == nullptr );
+      generate_block();
+   }
+   catch( const fc::exception& e )
+   {
+      edump( (e.to_detail_string()) );
+      throw;
+   }
+}
+
 BOOST_FIXTURE_TEST_CASE( rsf_missed_blocks, database_fixture )
 {
    try
@@ -1307,4 +1437,190 @@ BOOST_FIXTURE_TEST_CASE( miss_many_blocks, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( prune_old_history, database_fixture )
+{
+   try
+   {
+      ACTORS((alice));
+      transfer( account_id_type(), alice_id, asset(1000) );
+      transfer( account_id_type(), alice_id, asset(1000) );
+      generate_block();
+
+      const auto& ops = db.get_index_type<operation_history_index>().indices().get<by_time>();
+      const fc::time_point_sec old_time = db.head_block_time() + 1;
+      auto count_old = [&]() { return std::distance( ops.begin(), ops.lower_bound( old_time ) ); };
+      const auto old_ops = count_old();
+      BOOST_REQUIRE( old_ops >= 2 );
+
+      db.set_history_size( 1 );
+      db.set_pruning_chunk_size( 1 );
+      generate_blocks( db.head_block_time() + fc::days(2) );
+
+      // a single object is pruned per block
+      const auto blocks = db.get_pruning_statistics().chunks;
+      BOOST_CHECK_EQUAL( db.get_pruning_statistics().operation_history, blocks );
+      BOOST_CHECK_EQUAL( count_old(), old_ops - blocks );
+
+      db.set_pruning_chunk_size( 1000 );
+      generate_block();
+      BOOST_CHECK_EQUAL( count_old(), 0 );
+      BOOST_CHECK_EQUAL( db.get_pruning_statistics().operation_history, uint64_t( old_ops ) );
+
+      // pruning happens outside of the undo sessions, popping a block still restores its state
+      const size_t ops_before = ops.size();
+      transfer( account_id_type(), alice_id, asset(1000) );
+      generate_block();
+      BOOST_CHECK_EQUAL( ops.size(), ops_before + 1 );
+      BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), 3000 );
+      db.pop_block();
+      BOOST_CHECK_EQUAL( ops.size(), ops_before );
+      BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), 2000 );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_FIXTURE_TEST_CASE( history_store_archive, database_fixture )
+{
+   try
+   {
+      graphene::history::operation_history_store* store = app.history_store();
+      BOOST_REQUIRE( store != nullptr );
+
+      ACTORS((alice));
+      transfer( account_id_type(), alice_id, asset(1000) );
+      generate_block();
+
+      // issue_bonuses_old() walks the account histories until HARDFORK_617_TIME, nothing is archived before
+      generate_blocks( 20 );
+      BOOST_CHECK_EQUAL( store->size(), 0u );
+
+      generate_blocks( HARDFORK_617_TIME + fc::days(1) );
+      transfer( account_id_type(), alice_id, asset(1000) );
+      generate_block();
+      generate_blocks( 20 );
+      BOOST_CHECK( !store->account_history( alice_id ).empty() );
+
+      // no link in the object database points to an archived entry
+      const auto& stats = alice_id(db).statistics(db);
+      BOOST_CHECK( stats.most_recent_op == account_transaction_history_id_type() || db.find( stats.most_recent_op ) != nullptr );
+      for( const account_transaction_history_object& ath : db.get_index_type<account_transaction_history_index>().indices() )
+         BOOST_CHECK( ath.next == account_transaction_history_id_type() || db.find( ath.next ) != nullptr );
+
+      auto count_history = [&]() {
+         uint64_t count = 0;
+         graphene::history::visit_account_history( db, store, alice_id, [&]( const operation_history_object& ) {
+            ++count;
+            return true;
+         });
+         return count;
+      };
+      BOOST_CHECK_EQUAL( count_history(), stats.total_ops );
+
+      // new operations are linked in the object database in front of the archived ones
+      transfer( account_id_type(), alice_id, asset(1000) );
+      generate_block();
+      BOOST_CHECK( db.find( stats.most_recent_op ) != nullptr );
+      BOOST_CHECK_EQUAL( count_history(), stats.total_ops );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( object_database_load_test )
+{
+   try
+   {
+      fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+      // enough balances to decode the index in several chunks
+      const uint32_t count = 50000;
+      {
+         database db;
+         db.open( data_dir.path(), make_genesis );
+         for( uint32_t i = 0; i < count; ++i )
+            db.create<account_balance_object>( [i]( account_balance_object& b ) {
+               b.owner = account_id_type( 1000 + i );
+               b.asset_type = asset_id_type( 1 );
+               b.balance = i;
+            });
+         db.close();
+      }
+
+      database db;
+      db.open( data_dir.path(), []{ return genesis_state_type(); } );
+
+      const auto& stats = db.get_load_statistics();
+      BOOST_REQUIRE( !stats.empty() );
+      for( size_t i = 1; i < stats.size(); ++i )
+         BOOST_CHECK( stats[i-1].elapsed >= stats[i].elapsed );
+      auto balances = std::find_if( stats.begin(), stats.end(), []( const graphene::db::index_load_statistics& s ) {
+         return s.space == implementation_ids && s.type == impl_account_balance_object_type;
+      });
+      BOOST_REQUIRE( balances != stats.end() );
+      BOOST_CHECK( balances->objects >= count );
+
+      const auto& idx = db.get_index_type<account_balance_index>().indices().get<by_account_asset>();
+      for( uint32_t i = 0; i < count; i += 997 )
+      {
+         auto itr = idx.find( boost::make_tuple( account_id_type( 1000 + i ), asset_id_type( 1 ) ) );
+         BOOST_REQUIRE( itr != idx.end() );
+         BOOST_CHECK_EQUAL( itr->balance.value, i );
+      }
+
+      // new objects continue after the loaded ids
+      const auto& last = *db.get_index_type<account_balance_index>().indices().get<by_id>().rbegin();
+      const auto& created = db.create<account_balance_object>( []( account_balance_object& b ) {
+         b.owner = account_id_type( 999 );
+         b.asset_type = asset_id_type( 1 );
+      });
+      BOOST_CHECK( created.id.instance() == last.id.instance() + 1 );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+#ifndef GRAPHENE_DISABLE_BLOCK_TIMING
+BOOST_FIXTURE_TEST_CASE( block_timing_statistics_test, database_fixture )
+{
+   try
+   {
+      ACTORS((alice));
+      db.get_block_timing().reset();
+
+      transfer( account_id_type(), alice_id, asset(1000) );
+      generate_block();
+      generate_block();
+
+      const block_timing_statistics stats = db.get_block_timing_statistics();
+      BOOST_CHECK_EQUAL( stats.blocks, 2u );
+      BOOST_CHECK_EQUAL( stats.block_time.count, 2u );
+      BOOST_CHECK_EQUAL( stats.phases.at( "transactions" ).count, 2u );
+      BOOST_CHECK_EQUAL( stats.phases.at( "applied_block" ).count, 2u );
+      BOOST_CHECK( stats.phases.find( "chain_maintenance" ) == stats.phases.end() );
+
+      // the transfer is evaluated when pushed and again when the block is generated and applied
+      BOOST_CHECK( stats.evaluate.at( "transfer_operation" ).count >= 2u );
+      BOOST_CHECK_EQUAL( stats.apply.at( "transfer_operation" ).count, stats.evaluate.at( "transfer_operation" ).count );
+      BOOST_CHECK_EQUAL( stats.observers.at( "history" ).count, 2u );
+      BOOST_CHECK_EQUAL( stats.observers.at( "market_history" ).count, 2u );
+      BOOST_CHECK_EQUAL( stats.undo_new_ids.count, 2u );
+      BOOST_CHECK( stats.undo_new_ids.max > 0 );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
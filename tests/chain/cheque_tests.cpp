@@ -54,7 +54,7 @@ BOOST_AUTO_TEST_CASE(create_and_use_cheque_test)
       BOOST_CHECK(cheque.code == cheque_code);
       BOOST_CHECK(cheque.datetime_expiration == exp_date);
 
-      share_type sum_amount = cheque.payees.size() * cheque.amount_payee;
+      share_type sum_amount = cheque.payees_count * cheque.amount_payee;
       BOOST_CHECK(sum_amount == 1000 * 2);
 
       BOOST_CHECK(cheque.asset_id == EDC_ASSET);
@@ -90,6 +90,14 @@ BOOST_AUTO_TEST_CASE(create_and_use_cheque_test)
       BOOST_CHECK(cheque_iter != db.get_index_type<cheque_index>().indices().get<by_code>().end());
       const cheque_object& cheque_alice = *cheque_iter;
       BOOST_CHECK_EQUAL(cheque_alice.status, cheque_status::cheque_used);
+      BOOST_CHECK_EQUAL(cheque_alice.payees_used, 2u);
+      BOOST_CHECK(cheque_alice.amount_remaining == 0);
+
+      // every payee is recorded once
+      const auto& payee_idx = db.get_index_type<cheque_payee_index>().indices().get<by_cheque_payee>();
+      BOOST_CHECK(payee_idx.find(boost::make_tuple(cheque_alice.get_id(), bob_id)) != payee_idx.end());
+      BOOST_CHECK(payee_idx.find(boost::make_tuple(cheque_alice.get_id(), dan_id)) != payee_idx.end());
+      BOOST_CHECK(payee_idx.find(boost::make_tuple(cheque_alice.get_id(), alice_id)) == payee_idx.end());
 
       //check bob balance after cheque usage
       BOOST_CHECK(get_balance(bob_id, EDC_ASSET) == 1000);
@@ -181,11 +189,13 @@ BOOST_AUTO_TEST_CASE(undo_expired_cheques_test)
       const cheque_object& cheque_bob = *cheque_iter;
       BOOST_CHECK_EQUAL(cheque_bob.status, cheque_undo);
 
-      for(auto payee: cheque_bob.payees)
-      {
-         if(payee.payee == dan_id)
-            BOOST_CHECK_EQUAL(payee.status, cheque_used);
-      }
+      BOOST_CHECK_EQUAL(cheque_bob.payees_used, 1u);
+      BOOST_CHECK(cheque_bob.amount_remaining == 0);
+
+      const auto& payee_idx = db.get_index_type<cheque_payee_index>().indices().get<by_cheque_payee>();
+      auto payee_itr = payee_idx.find(boost::make_tuple(cheque_bob.get_id(), dan_id));
+      BOOST_REQUIRE(payee_itr != payee_idx.end());
+      BOOST_CHECK(payee_itr->datetime_used <= cheque_bob.datetime_used);
 
    } FC_LOG_AND_RETHROW()
 
@@ -222,6 +232,9 @@ BOOST_AUTO_TEST_CASE(cheque_fee_test)
       // std::cout << get_balance(bob_id, EDC_ASSET) << std::endl;
       BOOST_CHECK(get_balance(bob_id, EDC_ASSET) == 9000);
 
+      use_cheque(bob_cheque_code, alice_id);
+      const cheque_id_type bob_cheque_id = db.get_index_type<cheque_index>().indices().get<by_code>().find(bob_cheque_code)->get_id();
+
       {
          update_settings_operation op;
          op.fee = asset();
@@ -260,6 +273,10 @@ BOOST_AUTO_TEST_CASE(cheque_fee_test)
       {
          const auto& idx = db.get_index_type<cheque_index>().indices().get<by_code>().find(bob_cheque_code);
          BOOST_CHECK(idx == db.get_index_type<cheque_index>().indices().get<by_code>().end());
+
+         // and its payees with it
+         const auto& payee_idx = db.get_index_type<cheque_payee_index>().indices().get<by_cheque_payee>();
+         BOOST_CHECK(payee_idx.find(boost::make_tuple(bob_cheque_id, alice_id)) == payee_idx.end());
          //std::cout << "!!!: " << std::boolalpha << (idx == db.get_index_type<cheque_index>().indices().get<by_code>().end()) << std::endl;
       }
 
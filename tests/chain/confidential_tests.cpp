@@ -35,9 +35,12 @@
 #include <graphene/db/simple_index.hpp>
 
 #include <fc/crypto/digest.hpp>
+#include <fc/thread/parallel.hpp>
+
 #include "../common/database_fixture.hpp"
 
 using namespace graphene::chain;
+using namespace graphene::chain::test;
 
 BOOST_FIXTURE_TEST_SUITE( confidential_tests, database_fixture )
 BOOST_AUTO_TEST_CASE( confidential_test )
@@ -133,6 +136,73 @@ BOOST_AUTO_TEST_CASE( confidential_test )
 
 } FC_LOG_AND_RETHROW() }
 
+/// a transfer of 1000 to two blind outputs, the first one's range proof admits values above the maximum supply if @p bad_proof
+static transfer_to_blind_operation make_to_blind( const account_object& from, bool bad_proof )
+{
+   transfer_to_blind_operation to_blind;
+   to_blind.amount = asset( 1000 );
+   to_blind.from   = from.id;
 
+   auto InB1  = fc::sha256::hash("InB1");
+   auto InB2  = fc::sha256::hash("InB2");
+   blind_output out1, out2;
+   out1.owner = authority( 1, public_key_type( fc::ecc::private_key::generate().get_public_key() ), 1 );
+   out2.owner = authority( 1, public_key_type( fc::ecc::private_key::generate().get_public_key() ), 1 );
+   out1.commitment  = fc::ecc::blind( InB1, 250 );
+   out1.range_proof = fc::ecc::range_proof_sign( 0, out1.commitment, InB1, fc::sha256::hash("nonce"), 0, bad_proof ? 64 : 0, 250 );
+   out2.commitment  = fc::ecc::blind( InB2, 750 );
+   out2.range_proof = fc::ecc::range_proof_sign( 0, out2.commitment, InB2, fc::sha256::hash("nonce2"), 0, 0, 750 );
+
+   to_blind.blinding_factor = fc::ecc::blind_sum( {InB1,InB2}, 2 );
+   to_blind.outputs = {out1,out2};
+   std::sort( to_blind.outputs.begin(), to_blind.outputs.end(),
+              []( const blind_output& a, const blind_output& b ) { return a.commitment < b.commitment; } );
+   return to_blind;
+}
+
+BOOST_AUTO_TEST_CASE( confidential_validation_cache )
+{ try {
+   ACTORS( (dan) )
+
+   signed_transaction good;
+   good.operations = { make_to_blind( dan, false ) };
+   set_expiration( db, good );
+   good.validate();
+   // a passed transaction is remembered, validating it again is fine
+   good.validate();
+
+   // failures are not remembered, and the cached pass does not cover a transaction with another proof
+   signed_transaction bad = good;
+   bad.operations = { make_to_blind( dan, true ) };
+   BOOST_CHECK( bad.id() != good.id() );
+   BOOST_CHECK_THROW( bad.validate(), fc::assert_exception );
+   BOOST_CHECK_THROW( bad.validate(), fc::assert_exception );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( confidential_prevalidation_failure )
+{ try {
+   ACTORS( (dan) )
+   transfer( account_id_type()(db), dan, asset( 1000000 ) );
+   const int64_t balance = get_balance( dan, asset_id_type()(db) );
+
+   vector<signed_transaction> trxs( 3 );
+   for( size_t i = 0; i < trxs.size(); ++i )
+   {
+      trxs[i].operations = { make_to_blind( dan, i == 1 ) };
+      set_expiration( db, trxs[i] );
+      sign( trxs[i], dan_private_key );
+   }
+
+   // a proof failing on a worker reaches the caller
+   BOOST_CHECK_THROW( fc::parallel_for( 0, trxs.size(), [&trxs]( size_t i ) { trxs[i].validate(); }, 1 ),
+                      fc::assert_exception );
+
+   // the chain still checks the transactions which failed on the worker pool
+   db.push_transaction( trxs[0] );
+   GRAPHENE_REQUIRE_THROW( db.push_transaction( trxs[1] ), fc::exception );
+   db.push_transaction( trxs[2] );
+   generate_block();
+   BOOST_CHECK_EQUAL( get_balance( dan, asset_id_type()(db) ), balance - 2000 );
+} FC_LOG_AND_RETHROW() }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 
 #include <graphene/chain/fund_object.hpp>
 #include <graphene/chain/hardfork.hpp>
+#include <graphene/app/database_api.hpp>
 
 using namespace graphene::chain;
 using namespace graphene::chain::test;
@@ -585,6 +586,89 @@ BOOST_AUTO_TEST_CASE( fund_make_payments_test )
    } FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( fund_deposits_by_period_api_test )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "=== fund_deposits_by_period_api_test ===" );
+
+      ACTOR(abcde1); // for needed IDs
+      ACTOR(alice);
+      ACTOR(bob);
+
+      SET_ACTOR_CAN_CREATE_ASSET(alice_id);
+
+      create_edc();
+
+      issue_uia(bob_id, asset(50000, EDC_ASSET));
+
+      generate_blocks(HARDFORK_626_TIME);
+
+      fund_options::fund_rate fr;
+      fr.amount = 10000;
+      fr.day_percent = 1000;
+      fund_options::payment_rate pr1;
+      pr1.period = 1;
+      pr1.percent = 1000;
+      fund_options::payment_rate pr2;
+      pr2.period = 2;
+      pr2.percent = 1000;
+
+      fund_options options;
+      options.description = "FUND DESCRIPTION";
+      options.period = 10;
+      options.min_deposit = 10000;
+      options.rates_reduction_per_month = 0;
+      options.fund_rates.push_back(std::move(fr));
+      options.payment_rates.push_back(std::move(pr1));
+      options.payment_rates.push_back(std::move(pr2));
+      make_fund("TESTFUND", options, alice_id);
+
+      const fund_object& fund = *db.get_index_type<fund_index>().indices().get<by_name>().find("TESTFUND");
+
+      for (uint32_t period : { 1, 2, 1 })
+      {
+         fund_deposit_operation fdo;
+         fdo.amount = 10000;
+         fdo.fee = asset();
+         fdo.from_account = bob_id;
+         fdo.period = period;
+         fdo.fund_id = fund.get_id();
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(fdo));
+         PUSH_TX(db, trx, ~0);
+         trx.clear();
+      }
+
+      graphene::app::database_api db_api(db);
+
+      vector<fund_deposit_object> by_period = db_api.get_fund_deposits_by_period(1, fund_deposit_id_type(), 100);
+      BOOST_REQUIRE_EQUAL(by_period.size(), 2u);
+      BOOST_CHECK(by_period[0].period == 1);
+      BOOST_CHECK(by_period[1].period == 1);
+      BOOST_CHECK(by_period[0].id < by_period[1].id);
+
+      // paging by the last returned id
+      vector<fund_deposit_object> first = db_api.get_fund_deposits_by_period(1, fund_deposit_id_type(), 1);
+      BOOST_REQUIRE_EQUAL(first.size(), 1u);
+      BOOST_CHECK(first[0].id == by_period[0].id);
+      vector<fund_deposit_object> next =
+            db_api.get_fund_deposits_by_period(1, fund_deposit_id_type(first[0].id) + 1, 100);
+      BOOST_REQUIRE_EQUAL(next.size(), 1u);
+      BOOST_CHECK(next[0].id == by_period[1].id);
+
+      BOOST_CHECK_EQUAL(db_api.get_fund_deposits_by_period(2, fund_deposit_id_type(), 100).size(), 1u);
+      BOOST_CHECK(db_api.get_fund_deposits_by_period(3, fund_deposit_id_type(), 100).empty());
+
+      // the offset based call returns the same deposits
+      auto all = db_api.get_all_fund_deposits_by_period(1, 0, 100);
+      BOOST_REQUIRE_EQUAL(all.first.size(), 2u);
+      BOOST_CHECK(all.first[0].id == by_period[0].id);
+      BOOST_CHECK(all.first[1].id == by_period[1].id);
+
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE( fund_make_autorenewal_test )
 {
    try
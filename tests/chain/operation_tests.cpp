@@ -35,6 +35,7 @@
 #include <graphene/chain/vesting_balance_object.hpp>
 #include <graphene/chain/withdraw_permission_object.hpp>
 #include <graphene/chain/witness_object.hpp>
+#include <graphene/market_history/market_history_plugin.hpp>
 
 #include <fc/crypto/digest.hpp>
 
@@ -971,6 +972,61 @@ BOOST_AUTO_TEST_CASE( create_buy_uia_multiple_match_new )
  }
 }
 
+BOOST_AUTO_TEST_CASE( market_history_buckets )
+{ try {
+
+   BOOST_TEST_MESSAGE( "=== market_history_buckets ===" );
+
+   INVOKE( issue_uia );
+   const asset_object&   core_asset     = asset_id_type()(db);
+   const asset_object&   test_asset     = get_asset( "TEST" );
+   const account_object& nathan_account = get_account( "nathan" );
+   const account_object& buyer_account  = create_account( "buyer" );
+   const account_object& seller_account = create_account( "seller" );
+
+   transfer( committee_account(db), buyer_account, core_asset.amount( 10000 ) );
+   transfer( nathan_account, seller_account, test_asset.amount( 10000 ) );
+   generate_block();
+
+   // four trades at different prices in one block, the second is the highest and the third the lowest price
+   const std::vector<std::pair<int64_t,int64_t>> trades = { {100, 200}, {100, 100}, {100, 400}, {150, 200} };
+   for( const auto& t : trades )
+   {
+      BOOST_CHECK( create_sell_order( buyer_account, core_asset.amount( t.first ), test_asset.amount( t.second ) ) );
+      BOOST_CHECK( !create_sell_order( seller_account, test_asset.amount( t.second ), core_asset.amount( t.first ) ) );
+   }
+   generate_block();
+
+   // both fills of every matched order are recorded
+   const auto& history_idx = db.get_index_type<graphene::market_history::history_index>().indices();
+   BOOST_CHECK_EQUAL( history_idx.size(), 2 * trades.size() );
+
+   // the fills of the block are aggregated and written to every bucket once
+   const auto& bucket_idx = db.get_index_type<graphene::market_history::bucket_index>().indices();
+   BOOST_REQUIRE_EQUAL( bucket_idx.size(), 5u );
+   for( const auto& b : bucket_idx )
+   {
+      BOOST_CHECK( b.key.base == core_asset.get_id() );
+      BOOST_CHECK( b.key.quote == test_asset.get_id() );
+      BOOST_CHECK_EQUAL( b.base_volume.value, 450 );
+      BOOST_CHECK_EQUAL( b.quote_volume.value, 900 );
+      BOOST_CHECK_EQUAL( b.open_base.value, 100 );
+      BOOST_CHECK_EQUAL( b.open_quote.value, 200 );
+      BOOST_CHECK_EQUAL( b.high_base.value, 100 );
+      BOOST_CHECK_EQUAL( b.high_quote.value, 100 );
+      BOOST_CHECK_EQUAL( b.low_base.value, 100 );
+      BOOST_CHECK_EQUAL( b.low_quote.value, 400 );
+      BOOST_CHECK_EQUAL( b.close_base.value, 150 );
+      BOOST_CHECK_EQUAL( b.close_quote.value, 200 );
+   }
+ }
+ catch ( const fc::exception& e )
+ {
+    elog( "${e}", ("e", e.to_detail_string() ) );
+    throw;
+ }
+}
+
 BOOST_AUTO_TEST_CASE( create_buy_exact_match_uia )
 { try {
 
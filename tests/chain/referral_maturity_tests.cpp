@@ -64,7 +64,8 @@ BOOST_AUTO_TEST_CASE( tree_create_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in acc_parent_pair) {
@@ -125,7 +126,8 @@ BOOST_AUTO_TEST_CASE( balances_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -183,7 +185,8 @@ BOOST_AUTO_TEST_CASE( level_a_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -260,7 +263,8 @@ BOOST_AUTO_TEST_CASE( a_referrals_mandatory_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -351,7 +355,8 @@ BOOST_AUTO_TEST_CASE( level_b_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -436,7 +441,8 @@ BOOST_AUTO_TEST_CASE( level_c_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -505,7 +511,8 @@ BOOST_AUTO_TEST_CASE( level_d_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -576,7 +583,8 @@ BOOST_AUTO_TEST_CASE( level_e_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -643,7 +651,8 @@ BOOST_AUTO_TEST_CASE( e_referrals_mandatory_test )
       auto& acc_idx = db.get_index_type<account_index>();
       auto& bal_idx = db.get_index_type<account_balance_index>();
       auto& mat_bal_idx = db.get_index_type<account_mature_balance_index>();
-      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx);
+      referral_tree result(acc_idx, bal_idx, asset_id_type(), account_id_type(), &mat_bal_idx,
+                           db.get_dynamic_global_properties().maturity_epoch);
       result.form();
 
       std::for_each( test_accounts.begin(), test_accounts.end(), [&](account_test_in& acc_parent_pair) {
@@ -677,4 +686,49 @@ BOOST_AUTO_TEST_CASE( e_referrals_mandatory_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( lazy_maturity_reset_test )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== lazy_maturity_reset_test ===" );
+
+      ACTORS((alice)(bob));
+      transfer( account_id_type(), alice_id, asset(10000) );
+      transfer( alice_id, bob_id, asset(2000) );
+
+      auto& bal_idx = db.get_index_type<account_balance_index>().indices().get<by_account_asset>();
+      auto& mat_idx = db.get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
+      const account_balance_object& bal = *bal_idx.find( boost::make_tuple( alice_id, asset_id_type() ) );
+      const account_mature_balance_object& mat = *mat_idx.find( boost::make_tuple( alice_id, asset_id_type() ) );
+      const uint32_t epoch = db.get_dynamic_global_properties().maturity_epoch;
+
+      BOOST_CHECK( bal.is_mandatory_transfer( epoch ) );
+      BOOST_CHECK( mat.is_mandatory_transfer( epoch ) );
+      BOOST_CHECK( db.get_mature_balance( alice_id, asset_id_type() ) == mat.get_balance() );
+
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+      const uint32_t new_epoch = db.get_dynamic_global_properties().maturity_epoch;
+      BOOST_REQUIRE_EQUAL( new_epoch, epoch + 1 );
+
+      // maintenance does not rewrite the objects, but they read as reset
+      BOOST_CHECK_EQUAL( mat.maturity_epoch, epoch );
+      BOOST_CHECK( !bal.is_mandatory_transfer( new_epoch ) );
+      BOOST_CHECK( !mat.is_mandatory_transfer( new_epoch ) );
+      BOOST_CHECK( db.get_mature_balance( alice_id, asset_id_type() ) == asset(0) );
+
+      // the first balance change applies the reset
+      transfer( alice_id, bob_id, asset(100) );
+      BOOST_CHECK_EQUAL( bal.maturity_epoch, new_epoch );
+      BOOST_CHECK_EQUAL( mat.maturity_epoch, new_epoch );
+      BOOST_CHECK( !bal.is_mandatory_transfer( new_epoch ) );
+      BOOST_CHECK_EQUAL( mat.balance.value, bal.balance.value );
+      BOOST_REQUIRE_EQUAL( mat.history.size(), 1u );
+      BOOST_CHECK_EQUAL( mat.history[0].real_balance.value, bal.balance.value );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
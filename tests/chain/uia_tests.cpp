@@ -32,6 +32,8 @@
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
 
+#include <graphene/app/database_api.hpp>
+
 #include <fc/crypto/digest.hpp>
 
 #include "../common/database_fixture.hpp"
@@ -117,6 +119,52 @@ BOOST_AUTO_TEST_CASE( override_transfer_test )
    BOOST_REQUIRE_EQUAL( get_balance( eric, advanced ), 100 );
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( asset_holder_index_test )
+{ try {
+
+   BOOST_TEST_MESSAGE( "=== asset_holder_index_test ===" );
+
+   ACTORS( (dan)(eric)(sam)(tom) );
+
+   //assign privileges for create_asset_operation
+   SET_ACTOR_CAN_CREATE_ASSET(sam_id);
+
+   const asset_object& advanced = create_user_issued_asset( "ADVANCED", sam, override_authority );
+   const asset_id_type advanced_id = advanced.id;
+   issue_uia( tom, advanced.amount( 1000 ) );
+   issue_uia( dan, advanced.amount( 500 ) );
+   issue_uia( eric, advanced.amount( 100 ) );
+
+   // eric's balance object stays in the index with zero balance
+   override_transfer_operation otrans;
+   otrans.issuer = advanced.issuer;
+   otrans.from = eric_id;
+   otrans.to   = dan_id;
+   otrans.amount = advanced.amount(100);
+   trx.operations.push_back(otrans);
+   sign( trx,  sam_private_key  );
+   PUSH_TX( db, trx, 0 );
+   BOOST_REQUIRE_EQUAL( get_balance( eric_id(db), advanced_id(db) ), 0 );
+
+   graphene::app::database_api db_api( db );
+
+   vector<account_id_type> all = db_api.get_asset_holders( advanced_id, account_id_type(), 100 );
+   BOOST_REQUIRE_EQUAL( all.size(), 2u );
+   BOOST_CHECK( all[0] == dan_id );
+   BOOST_CHECK( all[1] == tom_id );
+
+   vector<account_id_type> first = db_api.get_asset_holders( advanced_id, account_id_type(), 1 );
+   BOOST_REQUIRE_EQUAL( first.size(), 1u );
+   BOOST_CHECK( first[0] == dan_id );
+
+   vector<account_id_type> tail = db_api.get_asset_holders( advanced_id, first[0] + 1, 100 );
+   BOOST_REQUIRE_EQUAL( tail.size(), 1u );
+   BOOST_CHECK( tail[0] == tom_id );
+
+   GRAPHENE_REQUIRE_THROW( db_api.get_asset_holders( advanced_id, account_id_type(), 101 ), fc::exception );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( override_transfer_test2 )
 { try {
 
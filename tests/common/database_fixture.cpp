@@ -27,6 +27,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/program_options.hpp>
+#include <boost/filesystem/path.hpp>
 
 #include <graphene/history/history_plugin.hpp>
 #include <graphene/market_history/market_history_plugin.hpp>
@@ -74,6 +75,10 @@ database_fixture::database_fixture()
    init_account_pub_key = init_account_priv_key.get_public_key();
        
    boost::program_options::variables_map options;
+   // the market history plugin only tracks buckets in the tests which check them
+   const string current_test_name = boost::unit_test::framework::current_test_case().p_name.value;
+   if( current_test_name == "market_history_buckets" )
+      options.emplace( "bucket-size", boost::program_options::variable_value( string( "[15,60,300,3600,86400]" ), false ) );
 
    genesis_state.initial_timestamp = time_point_sec( GRAPHENE_TESTING_GENESIS_TIMESTAMP );
    genesis_state.initial_active_witnesses = 10;
@@ -90,6 +95,9 @@ database_fixture::database_fixture()
 
    genesis_state.initial_parameters.get_mutable_fees().zero_all_fees();
    open_database();
+   if( current_test_name == "history_store_archive" )
+      options.emplace( "history-store-dir", boost::program_options::variable_value(
+                          boost::filesystem::path( data_dir->path().generic_string() ) / "history", false ) );
        
    // app.initialize();
    ahplugin->plugin_set_app(&app);
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/protocol/transaction.hpp>
+
+#include <fc/thread/parallel.hpp>
+
+using namespace graphene::protocol;
+
+namespace {
+
+const uint32_t transactions = 64;
+const uint32_t outputs_per_transaction = 8;
+
+/// reports the validation throughput of @p count transactions validated since @p start
+void report( const char* name, const fc::time_point& start, uint64_t count )
+{
+   const auto elapsed = fc::time_point::now() - start;
+   ilog( "${name}: ${n} transactions/s, ${us} us/transaction",
+         ("name", name)("n", count * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))
+         ("us", elapsed.count() / std::max<uint64_t>( count, 1 )) );
+}
+
+/// a transfer to blind outputs whose proofs are signed once and shared by all transactions
+transfer_to_blind_operation make_to_blind()
+{
+   transfer_to_blind_operation op;
+   op.amount = asset( 1000 * outputs_per_transaction );
+   op.from = account_id_type( 17 );
+
+   vector<fc::sha256> blindings;
+   for( uint32_t i = 0; i < outputs_per_transaction; ++i )
+   {
+      blind_output out;
+      fc::sha256 blinding = fc::sha256::hash( "blinding" + fc::to_string( i ) );
+      out.owner = authority( 1, public_key_type( fc::ecc::private_key::generate().get_public_key() ), 1 );
+      out.commitment = fc::ecc::blind( blinding, 1000 );
+      out.range_proof = fc::ecc::range_proof_sign( 0, out.commitment, blinding,
+                                                   fc::sha256::hash( "nonce" + fc::to_string( i ) ), 0, 0, 1000 );
+      op.outputs.push_back( out );
+      blindings.push_back( blinding );
+   }
+   std::sort( op.outputs.begin(), op.outputs.end(),
+              []( const blind_output& a, const blind_output& b ) { return a.commitment < b.commitment; } );
+   op.blinding_factor = fc::ecc::blind_sum( blindings, blindings.size() );
+   return op;
+}
+
+/// @return @p count transactions with the same operation but distinct ids, starting at @p first
+vector<signed_transaction> make_transactions( const transfer_to_blind_operation& op, uint32_t first, uint32_t count )
+{
+   vector<signed_transaction> result( count );
+   for( uint32_t i = 0; i < count; ++i )
+   {
+      result[i].expiration = fc::time_point_sec( first + i );
+      result[i].operations.push_back( op );
+   }
+   return result;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( confidential_validation_benchmark )
+{ try {
+   BOOST_TEST_MESSAGE( "=== confidential_validation_benchmark ===" );
+   const transfer_to_blind_operation op = make_to_blind();
+
+   // every transaction checked for the first time, one after the other like a block used to be
+   auto trxs = make_transactions( op, 1, transactions );
+   auto start = fc::time_point::now();
+   for( const auto& trx : trxs )
+      trx.validate();
+   report( "serial", start, transactions );
+
+   // the same transactions again, as when the block containing pushed transactions is applied
+   start = fc::time_point::now();
+   for( const auto& trx : trxs )
+      trx.validate();
+   report( "cached", start, transactions );
+
+   // new transactions checked on the worker pool, as blocks from the network are before push_block()
+   trxs = make_transactions( op, 1 + transactions, transactions );
+   start = fc::time_point::now();
+   fc::parallel_for( 0, trxs.size(), [&trxs]( size_t i ) { trxs[i].validate(); }, 1 );
+   report( "parallel", start, transactions );
+} FC_LOG_AND_RETHROW() }